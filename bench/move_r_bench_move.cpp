@@ -0,0 +1,112 @@
+#include <ctime>
+
+#include <move_r/data_structures/move_data_structure/move_data_structure.hpp>
+#include <move_r/data_structures/move_data_structure/move_data_structure_packed.hpp>
+#include <move_r/data_structures/move_data_structure/move_data_structure_reordered.hpp>
+#include <move_r/misc/utils.hpp>
+
+static constexpr uint32_t num_queries = 1 << 24;
+static constexpr uint32_t input_size = 1 << 26;
+static constexpr uint32_t avg_interval_length = 16;
+std::random_device rd;
+std::mt19937 gen(rd());
+std::vector<std::pair<uint32_t,uint32_t>> interval_sequence;
+std::vector<uint32_t> interval_permutation;
+
+template <move_policy policy, typename mds_t>
+void bench_move(const mds_t& mds, uint16_t a, std::string layout) {
+    std::string policy_str;
+
+    switch (policy) {
+        case _move_plain: policy_str = "plain";break;
+        case _move_fast:  policy_str = "fast";break;
+    }
+
+    std::cout << "benchmarking move queries ("
+        << "a: " << a
+        << ", r': " << mds.num_intervals()
+        << ", policy: " << policy_str
+        << ", layout: " << layout
+        << ", size: " << format_size(mds.size_in_bytes())
+        << "): " << std::flush;
+
+    // perform a chain of move queries (like in revert), so each query depends on the previous one
+    std::pair<uint32_t,uint32_t> ix{0,0};
+    auto time_start = now();
+
+    for (uint32_t query=0; query<num_queries; query++) {
+        mds.template move<policy>(ix.first,ix.second);
+    }
+
+    auto time_end = now();
+    std::to_string(ix.first);
+
+    std::cout << format_query_throughput(
+        num_queries,time_diff_ns(time_start,time_end))
+        << std::endl;
+}
+
+int main() {
+    std::srand(std::time(0));
+    omp_set_num_threads(1);
+
+    // choose input intervals of random lengths
+    std::uniform_int_distribution<uint32_t> interval_length_distrib(1,2*avg_interval_length);
+    uint32_t interval_length_prefix_sum = 0;
+    uint32_t num_intervals = 0;
+    interval_sequence.emplace_back(std::make_pair(0,0));
+
+    while (interval_length_prefix_sum < input_size) {
+        interval_length_prefix_sum = std::min<uint32_t>(
+            interval_length_prefix_sum+interval_length_distrib(gen),
+            input_size
+        );
+        interval_sequence.emplace_back(std::make_pair(interval_length_prefix_sum,0));
+        num_intervals++;
+    }
+
+    // permute the input intervals randomly into the output intervals
+    no_init_resize(interval_permutation,num_intervals);
+    for (uint32_t i=0; i<num_intervals; i++) interval_permutation[i] = i;
+    std::shuffle(interval_permutation.begin(),interval_permutation.end(),gen);
+    interval_length_prefix_sum = 0;
+
+    for (uint32_t i=0; i<num_intervals; i++) {
+        interval_sequence[interval_permutation[i]].second = interval_length_prefix_sum;
+        interval_length_prefix_sum += interval_sequence[interval_permutation[i]+1].first-interval_sequence[interval_permutation[i]].first;
+    }
+
+    interval_sequence.pop_back();
+    interval_permutation.clear();
+    interval_permutation.shrink_to_fit();
+
+    for (uint16_t a=2; a<=8192; a*=2) {
+        move_data_structure<uint32_t> mds(interval_sequence,input_size,{.num_threads = 1, .a = a});
+
+        move_data_structure_packed<uint32_t> mds_packed(interval_sequence,input_size,{.num_threads = 1, .a = a});
+
+        bench_move<_move_plain>(mds,a,"interleaved");
+        bench_move<_move_fast>(mds,a,"interleaved");
+
+        // the same data with the widths as compile-time constants (if they are one of mds_fixed_widths)
+        mds.with_fixed_widths([&](const auto& mds_f){
+            if constexpr (!std::is_same_v<std::decay_t<decltype(mds_f)>,move_data_structure<uint32_t>>) {
+                bench_move<_move_plain>(mds_f,a,"fixed widths");
+                bench_move<_move_fast>(mds_f,a,"fixed widths");
+            }
+        });
+
+        bench_move<_move_plain>(mds_packed,a,"packed");
+        bench_move<_move_fast>(mds_packed,a,"packed");
+
+        // the same data with the rows stored in the order in which the chain of move queries visits them first
+        move_data_structure_reordered<uint32_t> mds_ro(mds,
+            move_data_structure_reordered<uint32_t>::walk_order(mds,0,0,num_queries));
+        mds_ro.with_fixed_widths([&](const auto& rows){
+            bench_move<_move_plain>(rows,a,"reordered");
+            bench_move<_move_fast>(rows,a,"reordered");
+        });
+
+        std::cout << std::endl;
+    }
+}
@@ -8,6 +8,12 @@
 #include <libsais64.h>
 #include <move_r/move_r.hpp>
 
+// suffix of the names of move-r in the output that identifies the layout of M_LF (set at compile time with
+// MOVE_R_LAYOUT_L_; move-r-bench-l-separate and move-r-bench-l-p-separate are built with the other layouts)
+const std::string name_layout_l_ =
+    MOVE_R_LAYOUT_L_ == _l_separate ? "-l-separate" :
+    MOVE_R_LAYOUT_L_ == _l_p_separate ? "-l-p-separate" : "";
+
 void preprocess_input() {
     std::vector<std::vector<uint8_t>> contains_uchar_thr(max_num_threads,std::vector<uint8_t>(256,0));
 
@@ -427,6 +433,7 @@ void bench_a() {
         if (mf.is_open()) {
             mf << "RESULT"
                 << " type=comparison_a_count"
+                << " layout_l_=" << (name_layout_l_ == "" ? "interleaved" : name_layout_l_.substr(1))
                 << " text=" << name_text_file
                 << " text_length=" << input_size
                 << " a=" << std::to_string(a)
@@ -442,6 +449,7 @@ void bench_a() {
             for (query_result& res : locate_results) {
                 mf << "RESULT"
                     << " type=comparison_a_locate"
+                    << " layout_l_=" << (name_layout_l_ == "" ? "interleaved" : name_layout_l_.substr(1))
                     << " text=" << name_text_file
                     << " text_length=" << input_size
                     << " a=" << std::to_string(a)
@@ -454,4 +462,98 @@ void bench_a() {
             }
         }
     }
-}
\ No newline at end of file
+}
+template <typename pos_t, move_r_support support>
+void bench_numa(std::ifstream& index_file) {
+    using idx_t = move_r<support,char,pos_t>;
+    uint16_t num_nodes = num_numa_nodes();
+
+    std::cout << "loading the index" << std::flush;
+    auto t1 = now();
+    idx_t index;
+    index.load(index_file);
+    log_runtime(t1);
+
+    std::string header;
+    std::getline(patterns_file_1,header);
+    uint64_t num_patterns = number_of_patterns(header);
+    uint64_t pattern_length = patterns_length(header);
+    std::vector<std::string> patterns(num_patterns,std::string(pattern_length,0));
+    for (std::string& pattern : patterns) patterns_file_1.read((char*)&pattern[0],pattern_length);
+
+    /* locates all patterns with each of max_num_threads threads, which are spread evenly over the NUMA nodes and use
+    the index index_of_thread(), and reports the throughput of each node */
+    auto bench_mode = [&](std::string mode, auto&& index_of_thread){
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        std::cout << std::endl << "locating the patterns (" << mode << ") using " << format_threads(max_num_threads) << std::endl;
+        std::vector<uint64_t> time_thr(max_num_threads);
+        std::vector<uint64_t> num_occurrences_thr(max_num_threads);
+        std::vector<std::thread> threads;
+
+        for (uint16_t i_t=0; i_t<max_num_threads; i_t++) {
+            threads.emplace_back([&,i_t](){
+                pin_to_numa_node(i_t % num_nodes);
+                const idx_t& idx = index_of_thread();
+                std::vector<pos_t> occurrences;
+                uint64_t num_occurrences = 0;
+                auto t2 = now();
+
+                for (const std::string& pattern : patterns) {
+                    idx.locate(pattern,occurrences);
+                    num_occurrences += occurrences.size();
+                    occurrences.clear();
+                }
+
+                time_thr[i_t] = time_diff_ns(t2,now());
+                num_occurrences_thr[i_t] = num_occurrences;
+            });
+        }
+
+        for (std::thread& thread : threads) thread.join();
+
+        for (uint16_t node=0; node<num_nodes; node++) {
+            uint16_t num_threads_node = 0;
+            uint64_t num_occurrences = 0;
+            uint64_t time_query = 0;
+
+            for (uint16_t i_t=node; i_t<max_num_threads; i_t+=num_nodes) {
+                num_threads_node++;
+                num_occurrences += num_occurrences_thr[i_t];
+                time_query = std::max(time_query,time_thr[i_t]);
+            }
+
+            if (num_threads_node == 0) continue;
+            uint64_t num_queries = num_threads_node*num_patterns;
+
+            std::cout << "node " << node << " (" << format_threads(num_threads_node) << "): "
+                      << format_query_throughput(num_queries,time_query) << std::endl;
+
+            if (mf.is_open()) {
+                mf << "RESULT"
+                    << " type=numa_locate"
+                    << " mode=" << mode
+                    << " text=" << name_text_file
+                    << " node=" << node
+                    << " num_nodes=" << num_nodes
+                    << " num_threads=" << num_threads_node
+                    << " num_queries=" << num_queries
+                    << " pattern_length=" << pattern_length
+                    << " num_occurrences=" << num_occurrences
+                    << " time_query=" << time_query
+                    << std::endl;
+            }
+        }
+    };
+
+    // one copy of the index, which is stored on the node of the thread that loaded it
+    bench_mode("shared",[&]() -> const idx_t& {return index;});
+
+    std::cout << std::endl << "replicating the index on " << num_nodes << " NUMA node(s)" << std::flush;
+    t1 = now();
+    numa_replicated<idx_t> replicas(index,num_nodes);
+    log_runtime(t1);
+    index = idx_t();
+
+    // each thread uses the replica on its own node
+    bench_mode("replicated",[&]() -> const idx_t& {return replicas.local();});
+}
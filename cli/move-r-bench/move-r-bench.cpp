@@ -41,7 +41,12 @@ void help(std::string msg) {
     if (msg != "") std::cout << msg << std::endl;
     std::cout << "move-r-bench: benchmarks construction- and query performance of move-r, block-rlbwt-2, block-rlbwt-v," << std::endl;
     std::cout << "              block-rlbwt-r, r-index, r-index-f, rcomp-glfig and online-rlbwt;" << std::endl;
-    std::cout << "              has to be executed from the base folder." << std::endl << std::endl;
+    std::cout << "              has to be executed from the base folder." << std::endl;
+    if (name_layout_l_ != "") {
+        std::cout << "              (this build stores L' of move-r in the layout " << name_layout_l_.substr(1)
+                  << " and only benchmarks move-r)" << std::endl;
+    }
+    std::cout << std::endl;
     std::cout << "usage 1: move-r-bench [options] <input_file> <patterns_file_1> <patterns_file_2>" << std::endl;
     std::cout << "   -c                 check for correctnes if possible; disables the -m option; will not print" << std::endl;
     std::cout << "                      runtime data if the runtime could be affected by checking for correctness" << std::endl;
@@ -62,13 +67,25 @@ void help(std::string msg) {
     std::cout << "   <patterns_file_2>  file containing patterns (pattern length << number of occurrences) from <input_file>" << std::endl;
     std::cout << "                      to locate" << std::endl;
     std::cout << "   <num_threads>   maximum number of threads to use" << std::endl;
+    std::cout << std::endl;
+    std::cout << "usage 3: move-r-bench -numa [options] <index_file> <patterns_file> <num_threads>" << std::endl;
+    std::cout << "                      locates the patterns with <num_threads> threads, which are spread evenly over" << std::endl;
+    std::cout << "                      the NUMA nodes, first using one copy of the index and then using one replica" << std::endl;
+    std::cout << "                      of the index per NUMA node, and reports the throughput of each node (socket)." << std::endl;
+    std::cout << "   -m <m_file>        writes measurement data to m_file" << std::endl;
+    std::cout << "   <index_file>       index file (with extension .move-r; locate_move or locate_move_bi)" << std::endl;
+    std::cout << "   <patterns_file>    file in pizza&chili format containing the patterns" << std::endl;
+    std::cout << "   <num_threads>      number of threads to use" << std::endl;
     exit(0);
 }
 
 template <typename pos_t>
 void bench_indexes() {
-    bench_index<pos_t,move_r<_locate_move,char,pos_t>,true,true>("move-r","move_r");
-    bench_index<pos_t,move_r<_locate_rlzdsa,char,pos_t>,true,true>("move-rlzdsa","move_rlzdsa");
+    bench_index<pos_t,move_r<_locate_move,char,pos_t>,true,true>("move-r"+name_layout_l_,"move_r"+name_layout_l_);
+    bench_index<pos_t,move_r<_locate_rlzdsa,char,pos_t>,true,true>("move-rlzdsa"+name_layout_l_,"move_rlzdsa"+name_layout_l_);
+
+    // the other indexes do not depend on the layout of M_LF, so they are only benchmarked with the default layout
+    if constexpr (MOVE_R_LAYOUT_L_ != _l_interleaved) return;
     
     block_rlbwt_data bd = prepare_blockrlbwt();
     measure_blockrlbwt("block_rlbwt_2",bd);
@@ -212,8 +229,49 @@ int main_bench_indexes(int argc, char** argv) {
     return 0;
 }
 
+int main_bench_numa(int argc, char** argv) {
+    ptr = 2;
+    if (argc < 5) help("");
+    while (ptr < argc - 3) parse_args(argv, argc, ptr);
+
+    std::string path_index_file = argv[ptr];
+    path_patterns_file_1 = argv[ptr+1];
+    max_num_threads = atoi(argv[ptr+2]);
+
+    std::ifstream index_file(path_index_file);
+    patterns_file_1.open(path_patterns_file_1);
+    if (!index_file.good()) help("error: invalid input, could not read <index_file>");
+    if (!patterns_file_1.good()) help("error: invalid input, could not read <patterns_file>");
+    if (max_num_threads == 0) help("error: invalid number of threads");
+
+    std::cout << std::setprecision(4);
+    name_text_file = path_index_file.substr(path_index_file.find_last_of("/\\") + 1);
+    std::cout << "benchmarking " << path_index_file << " on " << num_numa_nodes() << " NUMA node(s)" << std::endl;
+
+    bool is_64_bit;
+    index_file.read((char*)&is_64_bit,1);
+    move_r_support _support;
+    index_file.read((char*)&_support,sizeof(move_r_support));
+    index_file.seekg(0,std::ios::beg);
+
+    if (_support == _locate_move) {
+        if (is_64_bit) bench_numa<uint64_t,_locate_move>(index_file);
+        else bench_numa<uint32_t,_locate_move>(index_file);
+    } else if (_support == _locate_move_bi) {
+        if (is_64_bit) bench_numa<uint64_t,_locate_move_bi>(index_file);
+        else bench_numa<uint32_t,_locate_move_bi>(index_file);
+    } else {
+        help("error: the index has to support locate with locate_move or locate_move_bi");
+    }
+
+    patterns_file_1.close();
+    if (mf.is_open()) mf.close();
+    return 0;
+}
+
 int main(int argc, char** argv) {
     if (argc == 1) help("");
     if (std::string(argv[1]) == "-a") return main_bench_a(argc,argv);
+    if (std::string(argv[1]) == "-numa") return main_bench_numa(argc,argv);
     else return main_bench_indexes(argc,argv);
 }
\ No newline at end of file
@@ -6,6 +6,10 @@ int ptr = 1;
 uint64_t n;
 uint16_t a = 8;
 uint16_t p = 1;
+uint64_t sr_isa = 0;
+uint64_t sr_sa = 0;
+bool build_lcp = false;
+bool build_thresholds = false;
 std::string path_prefix_index_file;
 move_r_construction_mode mode = _suffix_array;
 move_r_support support = _locate_move;
@@ -23,11 +27,20 @@ void help(std::string msg) {
     std::cout << "usage: move-r-build [options] <input_file>" << std::endl;
     std::cout << "   -c <mode>          construction mode: sa or bigbwt (default: sa)" << std::endl;
     std::cout << "   -o <base_name>     names the index file base_name.move-r (default: input_file)" << std::endl;
-    std::cout << "   -s <support>       support: count, locate_move or locate_rlzdsa" << std::endl;
+    std::cout << "   -s <support>       support: count, locate_move, locate_move_bi or locate_rlzdsa" << std::endl;
     std::cout << "                      (default: locate_move)" << std::endl;
     std::cout << "   -p <integer>       number of threads to use during the construction of the index" << std::endl;
     std::cout << "                      (default: all threads)" << std::endl;
     std::cout << "   -a <integer>       balancing parameter; a must be an integer number and a >= 2 (default: 8)" << std::endl;
+    std::cout << "   -sr_isa <integer>  sample rate of the text position samples used by move-r-extract" << std::endl;
+    std::cout << "                      (default: 0, i.e., no samples are stored)" << std::endl;
+    std::cout << "   -sr_sa <integer>   sample rate of the suffix array samples used by SA(i) (only with" << std::endl;
+    std::cout << "                      locate_move and locate_move_bi; default: 0, i.e., no samples are stored)" << std::endl;
+    std::cout << "   -lcp               also build the PLCP samples, which enable lcp queries (only with -c sa)" << std::endl;
+    std::cout << "   -thr               also build the thresholds, which enable matching statistics (only with" << std::endl;
+    std::cout << "                      locate_move, locate_move_bi and locate_rlzdsa)" << std::endl;
+    std::cout << "   -hp                back the arrays of the index with transparent huge pages" << std::endl;
+    std::cout << "   -numa              interleave the arrays of the index across all NUMA nodes" << std::endl;
     std::cout << "   -m_idx <m_file>    m_file is file to write measurement data of the index construction to" << std::endl;
     std::cout << "   -m_mds <m_file>    m_file is file to write measurement data of the construction of the move" << std::endl;
     std::cout << "                      data structures to" << std::endl;
@@ -59,12 +72,23 @@ void parse_args(char** argv, int argc, int &ptr) {
         if (support_str == "count") {support = _count;}
         else if (support_str == "locate_one") {support = _locate_one;}
         else if (support_str == "locate_move") {support = _locate_move;}
+        else if (support_str == "locate_move_bi") {support = _locate_move_bi;}
         else if (support_str == "locate_rlzdsa") {support = _locate_rlzdsa;}
         else help("error: unknown mode provided with -s option");
     } else if (s == "-a") {
         if (ptr >= argc-1) help("error: missing parameter after -a option");
         a = atoi(argv[ptr++]);
         if (a < 2) help("error: a < 2");
+    } else if (s == "-sr_isa") {
+        if (ptr >= argc-1) help("error: missing parameter after -sr_isa option");
+        sr_isa = atoll(argv[ptr++]);
+    } else if (s == "-sr_sa") {
+        if (ptr >= argc-1) help("error: missing parameter after -sr_sa option");
+        sr_sa = atoll(argv[ptr++]);
+    } else if (s == "-lcp") {
+        build_lcp = true;
+    } else if (s == "-thr") {
+        build_thresholds = true;
     } else if (s == "-m_idx") {
         if (ptr >= argc-1) help("error: missing parameter after -m_idx option");
         std::string path_mf_idx = argv[ptr++];
@@ -75,6 +99,10 @@ void parse_args(char** argv, int argc, int &ptr) {
         std::string path_mf_mds = argv[ptr++];
         mf_mds.open(path_mf_mds,std::filesystem::exists(path_mf_mds) ? std::ios::app : std::ios::out);
         if (!mf_mds.good()) help("error: cannot open or create at least one measurement file");
+    } else if (s == "-hp") {
+        current_alloc_policy().huge_pages = true;
+    } else if (s == "-numa") {
+        current_alloc_policy().numa = _numa_interleave;
     } else {
         help("error: unrecognized '" + s + "' option");
     }
@@ -89,7 +117,11 @@ void build() {
         .log=true,
         .mf_idx=mf_idx.is_open() ? &mf_idx : NULL,
         .mf_mds=mf_mds.is_open() ? &mf_mds : NULL,
-        .name_text_file=name_text_file
+        .name_text_file=name_text_file,
+        .sample_rate_isa=sr_isa,
+        .sample_rate_sa=sr_sa,
+        .build_lcp=build_lcp,
+        .build_thresholds=build_thresholds
     });
     input_file.close();
     std::cout << "serializing the index" << std::flush;
@@ -149,6 +181,12 @@ int main(int argc, char** argv) {
         } else {
             build<uint64_t,_locate_move>();
         }
+    } else if (support == _locate_move_bi) {
+        if (n < UINT_MAX) {
+            build<uint32_t,_locate_move_bi>();
+        } else {
+            build<uint64_t,_locate_move_bi>();
+        }
     } else {
         if (n < UINT_MAX) {
             build<uint32_t,_locate_rlzdsa>();
@@ -9,13 +9,21 @@ std::string path_patterns_file;
 std::ifstream index_file;
 std::ifstream patterns_file;
 std::string name_text_file;
+uint64_t batch_size = 1;
+int64_t max_scan_l_ = -1;
 
 void help(std::string msg) {
     if (msg != "") std::cout << msg << std::endl;
     std::cout << "move-r-count: count all occurrences of the input patterns." << std::endl << std::endl;
-    std::cout << "usage: move-r-count <index_file> <patterns_file>" << std::endl;
+    std::cout << "usage: move-r-count [options] <index_file> <patterns_file>" << std::endl;
+    std::cout << "   -b <batch_size>            number of patterns to count at once with interleaved backward searches" << std::endl;
+    std::cout << "                              (default: 1, i.e., the patterns are counted one after another)" << std::endl;
+    std::cout << "   -s <max_scan>              maximum number of runs to scan over L' in a backward search step before" << std::endl;
+    std::cout << "                              using rank-select queries (default: " << MOVE_R_MAX_SCAN_L_ << ")" << std::endl;
     std::cout << "   -m <m_file> <text_name>    m_file is the file to write measurement data to," << std::endl;
     std::cout << "                              text_name should be the name of the original file" << std::endl;
+    std::cout << "   -hp                        back the index with transparent huge pages" << std::endl;
+    std::cout << "   -numa                      interleave the index across all NUMA nodes" << std::endl;
     std::cout << "   <index_file>               index file (with extension .move-r)" << std::endl;
     std::cout << "   <patterns_file>            file in pizza&chili format containing the patterns." << std::endl;
     exit(0);
@@ -31,6 +39,18 @@ void parse_args(char **argv, int argc, int &ptr) {
         mf.open(path_m_file,std::filesystem::exists(path_m_file) ? std::ios::app : std::ios::out);
         if (!mf.good()) help("error: cannot open measurement file");
         name_text_file = argv[ptr++];
+    } else if (s == "-b") {
+        if (ptr >= argc - 1) help("error: missing parameter after -b option.");
+        batch_size = atoi(argv[ptr++]);
+        if (batch_size < 1) help("error: batch_size must be at least 1.");
+    } else if (s == "-s") {
+        if (ptr >= argc - 1) help("error: missing parameter after -s option.");
+        max_scan_l_ = atoi(argv[ptr++]);
+        if (max_scan_l_ < 0) help("error: max_scan must be non-negative.");
+    } else if (s == "-hp") {
+        current_alloc_policy().huge_pages = true;
+    } else if (s == "-numa") {
+        current_alloc_policy().numa = _numa_interleave;
     } else {
         help("error: unrecognized '" + s + "' option");
     }
@@ -43,6 +63,7 @@ void measure_count() {
     auto t1 = now();
     move_r<support,char,pos_t> index;
     index.load(index_file);
+    if (max_scan_l_ >= 0) index.set_max_scan_l_length(max_scan_l_);
     log_runtime(t1);
     index_file.close();
     std::cout << std::endl;
@@ -59,8 +80,15 @@ void measure_count() {
     std::chrono::steady_clock::time_point t2,t3;
     std::string pattern;
     no_init_resize(pattern,pattern_length);
+    std::vector<std::string> patterns;
+    std::vector<pos_t> counts;
 
-    for (uint64_t i=0; i<num_patterns; i++) {
+    if (batch_size > 1) {
+        patterns.resize(batch_size,pattern);
+        no_init_resize(counts,batch_size);
+    }
+
+    for (uint64_t i=0; i<num_patterns;) {
         perc = (100*i) / num_patterns;
 
         if (perc > last_perc) {
@@ -68,11 +96,26 @@ void measure_count() {
             last_perc = perc;
         }
 
-        patterns_file.read((char*)&pattern[0],pattern_length);
-        t2 = now();
-        num_occurrences += index.count(pattern);
-        t3 = now();
-        time_count += time_diff_ns(t2,t3);
+        if (batch_size == 1) {
+            patterns_file.read((char*)&pattern[0],pattern_length);
+            t2 = now();
+            num_occurrences += index.count(pattern);
+            t3 = now();
+            time_count += time_diff_ns(t2,t3);
+            i++;
+        } else {
+            uint64_t cur_batch_size = std::min<uint64_t>(batch_size,num_patterns-i);
+            for (uint64_t j=0; j<cur_batch_size; j++) patterns_file.read((char*)&patterns[j][0],pattern_length);
+            t2 = now();
+            index.count_batch(
+                std::span<const std::string>(patterns.data(),cur_batch_size),
+                std::span<pos_t>(counts.data(),cur_batch_size)
+            );
+            t3 = now();
+            time_count += time_diff_ns(t2,t3);
+            for (uint64_t j=0; j<cur_batch_size; j++) num_occurrences += counts[j];
+            i += cur_batch_size;
+        }
     }
 
     patterns_file.close();
@@ -98,10 +141,12 @@ void measure_count() {
         mf << " sigma=" << std::to_string(index.alphabet_size());
         mf << " r=" << index.num_bwt_runs();
         mf << " r_=" << index.M_LF().num_intervals();
+        mf << " max_scan_l_=" << index.max_scan_l_length();
 
         if constexpr (support != _count && support != _locate_one) {
-            if constexpr (support == _locate_move) {
+            if constexpr (support == _locate_move || support == _locate_move_bi) {
                 mf << " r__=" << index.M_Phi_m1().num_intervals();
+                if constexpr (support == _locate_move_bi) mf << " r___=" << index.M_Phi().num_intervals();
             } else if constexpr (support == _locate_rlzdsa) {
                 mf << " z__=" << index.num_phrases_rlzdsa();
                 mf << " z_l_=" << index.num_literal_phrases_rlzdsa();
@@ -111,6 +156,7 @@ void measure_count() {
         
         mf << " pattern_length=" << pattern_length;
         index.log_data_structure_sizes(mf);
+        mf << " batch_size=" << batch_size;
         mf << " num_patterns=" << num_patterns;
         mf << " num_occurrences=" << num_occurrences;
         mf << " time_count=" << time_count;
@@ -156,6 +202,12 @@ int main(int argc, char **argv) {
         } else {
             measure_count<uint32_t,_locate_move>();
         }
+    } else if (_support == _locate_move_bi) {
+        if (is_64_bit) {
+            measure_count<uint64_t,_locate_move_bi>();
+        } else {
+            measure_count<uint32_t,_locate_move_bi>();
+        }
     } else {
         if (is_64_bit) {
             measure_count<uint64_t,_locate_rlzdsa>();
@@ -0,0 +1,194 @@
+#include <iostream>
+#include <filesystem>
+#include <move_r/move_r.hpp>
+
+int ptr = 1;
+uint16_t p = 1;
+uint64_t sr_isa = 0;
+std::string path_index_file;
+std::string path_requests_file;
+std::string path_outputfile;
+std::string name_text_file;
+std::ifstream index_file;
+std::ifstream requests_file;
+std::ofstream output_file;
+std::ofstream mf;
+
+void help(std::string msg) {
+    if (msg != "") std::cout << msg << std::endl;
+    std::cout << "move-r-extract: extract substrings of the original file from the index." << std::endl << std::endl;
+    std::cout << "usage: move-r-extract [options] <index_file> <requests_file> <output_file>" << std::endl;
+    std::cout << "   -s <integer>               sample rate of the text position samples to build, if the index" << std::endl;
+    std::cout << "                              does not store them (default: 0, i.e., use the stored samples or" << std::endl;
+    std::cout << "                              revert the sections containing the requests, if there are none)" << std::endl;
+    std::cout << "   -p <integer>               number of threads to use (default: 1)" << std::endl;
+    std::cout << "   -m <m_file> <text_name>    m_file is the file to write measurement data to," << std::endl;
+    std::cout << "                              text_name should be the name of the original file" << std::endl;
+    std::cout << "   <index_file>               index file (with extension .move-r)" << std::endl;
+    std::cout << "   <requests_file>            file containing one request \"l r\" per line, i.e., the" << std::endl;
+    std::cout << "                              range [l,r] (0 <= l <= r < input size) to extract" << std::endl;
+    std::cout << "   <output_file>              output file; the extracted substrings are written to it in" << std::endl;
+    std::cout << "                              the order of the requests, each followed by a newline" << std::endl;
+    exit(0);
+}
+
+void parse_args(char** argv, int argc, int &ptr) {
+    std::string s = argv[ptr];
+    ptr++;
+
+    if (s == "-m") {
+        if (ptr >= argc-2) help("error: missing parameter after -m option");
+        std::string path_m_file = argv[ptr++];
+        mf.open(path_m_file,std::filesystem::exists(path_m_file) ? std::ios::app : std::ios::out);
+        if (!mf.good()) help("error: cannot open measurement file");
+        name_text_file = argv[ptr++];
+    } else if (s == "-s") {
+        if (ptr >= argc-2) help("error: missing parameter after -s option");
+        sr_isa = atoll(argv[ptr++]);
+    } else if (s == "-p") {
+        if (ptr >= argc-2) help("error: missing parameter after -p option");
+        p = atoi(argv[ptr++]);
+        if (p < 1) help("error: p < 1");
+        if (p > omp_get_max_threads()) help("error: p > number of available threads");
+    } else  {
+        help("error: unrecognized '" + s + "' option");
+    }
+}
+
+template <typename pos_t, move_r_support support>
+void measure_extract() {
+    std::cout << std::setprecision(4);
+    std::cout << "loading the index" << std::flush;
+    auto t1 = now();
+    move_r<support,char,pos_t> index;
+    index.load(index_file);
+    log_runtime(t1);
+    index_file.close();
+
+    if (index.sample_rate_isa() == 0 && sr_isa != 0) {
+        index.build_isa_samples(sr_isa,p,true);
+    }
+
+    std::cout << std::endl;
+    index.log_data_structure_sizes();
+    std::cout << std::endl;
+
+    std::cout << "reading the requests" << std::flush;
+    auto t2 = now();
+    std::vector<std::pair<pos_t,pos_t>> requests;
+    uint64_t l,r;
+
+    while (requests_file >> l >> r) {
+        if (l > r || r >= index.input_size()) {
+            std::cout << std::endl << "error: invalid request " << l << " " << r << std::endl;
+            return;
+        }
+
+        requests.emplace_back(std::make_pair(l,r));
+    }
+
+    requests_file.close();
+    log_runtime(t2);
+
+    std::cout << "extracting " << requests.size() << " substrings using " << format_threads(p) << std::flush;
+    std::vector<std::string> substrings(requests.size());
+    uint64_t num_chars = 0;
+    auto t3 = now();
+
+    #pragma omp parallel for schedule(dynamic,16) num_threads(p) reduction(+:num_chars)
+    for (uint64_t i=0; i<requests.size(); i++) {
+        substrings[i] = index.extract(requests[i].first,requests[i].second);
+        num_chars += substrings[i].size();
+    }
+
+    auto t4 = now();
+    log_runtime(t3,t4);
+
+    std::cout << "writing the substrings to the output file" << std::flush;
+
+    for (uint64_t i=0; i<substrings.size(); i++) {
+        output_file.write(substrings[i].c_str(),substrings[i].size());
+        output_file.put('\n');
+    }
+
+    output_file.close();
+    log_runtime(t4);
+
+    uint64_t time_extract = time_diff_ns(t3,t4);
+    std::cout << std::endl << "extracted " << num_chars << " characters in " << format_time(time_extract) << std::endl;
+    std::cout << "throughput: " << format_query_throughput(requests.size(),time_extract) << std::endl;
+
+    if (mf.is_open()) {
+        mf << "RESULT";
+        mf << " type=extract";
+        mf << " text=" << name_text_file;
+        mf << " a=" << index.balancing_parameter();
+        mf << " n=" << index.input_size();
+        mf << " sigma=" << std::to_string(index.alphabet_size());
+        mf << " r=" << index.num_bwt_runs();
+        mf << " r_=" << index.M_LF().num_intervals();
+        mf << " sr_isa=" << index.sample_rate_isa();
+        mf << " num_threads=" << p;
+        mf << " num_requests=" << requests.size();
+        mf << " num_chars=" << num_chars;
+        index.log_data_structure_sizes(mf);
+        mf << " time_extract=" << time_extract;
+        mf << std::endl;
+        mf.close();
+    }
+}
+
+int main(int argc, char **argv) {
+    if (argc < 4) help("");
+    while (ptr < argc - 3) parse_args(argv, argc, ptr);
+
+    path_index_file = argv[ptr];
+    path_requests_file = argv[ptr+1];
+    path_outputfile = argv[ptr+2];
+
+    index_file.open(path_index_file);
+    requests_file.open(path_requests_file);
+    output_file.open(path_outputfile);
+
+    if (!index_file.good()) help("error: could not read <index_file>");
+    if (!requests_file.good()) help("error: could not read <requests_file>");
+    if (!output_file.good()) help("error: could not create <output_file>");
+
+    bool is_64_bit;
+    index_file.read((char*)&is_64_bit,1);
+    move_r_support _support;
+    index_file.read((char*)&_support,sizeof(move_r_support));
+    index_file.seekg(0,std::ios::beg);
+
+    if (_support == _count) {
+        if (is_64_bit) {
+            measure_extract<uint64_t,_count>();
+        } else {
+            measure_extract<uint32_t,_count>();
+        }
+    } else if (_support == _locate_one) {
+        if (is_64_bit) {
+            measure_extract<uint64_t,_locate_one>();
+        } else {
+            measure_extract<uint32_t,_locate_one>();
+        }
+    } else if (_support == _locate_move) {
+        if (is_64_bit) {
+            measure_extract<uint64_t,_locate_move>();
+        } else {
+            measure_extract<uint32_t,_locate_move>();
+        }
+    } else if (_support == _locate_move_bi) {
+        if (is_64_bit) {
+            measure_extract<uint64_t,_locate_move_bi>();
+        } else {
+            measure_extract<uint32_t,_locate_move_bi>();
+        }
+    } else {
+        if (is_64_bit) {
+            measure_extract<uint64_t,_locate_rlzdsa>();
+        } else {
+            measure_extract<uint32_t,_locate_rlzdsa>();
+        }
+    }
+}
@@ -0,0 +1,164 @@
+#include <iostream>
+#include <filesystem>
+#include <move_r/move_r.hpp>
+
+int ptr = 1;
+uint16_t p = 1;
+uint64_t k;
+uint64_t min_freq = 1;
+uint64_t max_freq = std::numeric_limits<uint64_t>::max();
+std::string path_index_file;
+std::string path_outputfile;
+std::string name_text_file;
+std::ifstream index_file;
+std::ofstream mf;
+
+void help(std::string msg) {
+    if (msg != "") std::cout << msg << std::endl;
+    std::cout << "move-r-kmers: write the distinct k-mers of the original file with their frequencies to a file." << std::endl << std::endl;
+    std::cout << "usage: move-r-kmers [options] <index_file> <k> <output_file>" << std::endl;
+    std::cout << "   -min <integer>             minimum frequency of a k-mer to write (default: 1)" << std::endl;
+    std::cout << "   -max <integer>             maximum frequency of a k-mer to write (default: no maximum)" << std::endl;
+    std::cout << "   -p <integer>               number of threads to use (default: 1)" << std::endl;
+    std::cout << "   -m <m_file> <text_name>    m_file is the file to write measurement data to," << std::endl;
+    std::cout << "                              text_name should be the name of the original file" << std::endl;
+    std::cout << "   <index_file>               index file (with extension .move-r)" << std::endl;
+    std::cout << "   <k>                        length of the k-mers" << std::endl;
+    std::cout << "   <output_file>              output file; for each k-mer, it contains a record of the k characters of" << std::endl;
+    std::cout << "                              the k-mer, followed by its frequency (4 bytes for 32-bit indexes, else 8" << std::endl;
+    std::cout << "                              bytes); the records are in no particular order" << std::endl;
+    exit(0);
+}
+
+void parse_args(char** argv, int argc, int &ptr) {
+    std::string s = argv[ptr];
+    ptr++;
+
+    if (s == "-m") {
+        if (ptr >= argc-2) help("error: missing parameter after -m option");
+        std::string path_m_file = argv[ptr++];
+        mf.open(path_m_file,std::filesystem::exists(path_m_file) ? std::ios::app : std::ios::out);
+        if (!mf.good()) help("error: cannot open measurement file");
+        name_text_file = argv[ptr++];
+    } else if (s == "-min") {
+        if (ptr >= argc-2) help("error: missing parameter after -min option");
+        min_freq = atoll(argv[ptr++]);
+    } else if (s == "-max") {
+        if (ptr >= argc-2) help("error: missing parameter after -max option");
+        max_freq = atoll(argv[ptr++]);
+    } else if (s == "-p") {
+        if (ptr >= argc-2) help("error: missing parameter after -p option");
+        p = atoi(argv[ptr++]);
+        if (p < 1) help("error: p < 1");
+        if (p > omp_get_max_threads()) help("error: p > number of available threads");
+    } else  {
+        help("error: unrecognized '" + s + "' option");
+    }
+}
+
+template <typename pos_t, move_r_support support>
+void measure_kmers() {
+    std::cout << std::setprecision(4);
+    std::cout << "loading the index" << std::flush;
+    auto t1 = now();
+    move_r<support,char,pos_t> index;
+    index.load(index_file);
+    log_runtime(t1);
+    index_file.close();
+
+    std::cout << std::endl;
+    index.log_data_structure_sizes();
+    std::cout << std::endl;
+
+    if (k > index.input_size()) {
+        std::cout << "error: k > input size" << std::endl;
+        return;
+    }
+
+    std::cout << "writing the " << k << "-mers to " << path_outputfile << " using " << format_threads(p) << std::flush;
+    auto t2 = now();
+
+    uint64_t num_kmers = index.write_kmers(k,path_outputfile,{
+        .min_freq = (pos_t)std::min<uint64_t>(min_freq,std::numeric_limits<pos_t>::max()),
+        .max_freq = (pos_t)std::min<uint64_t>(max_freq,std::numeric_limits<pos_t>::max()),
+        .num_threads = p
+    });
+
+    auto t3 = now();
+    log_runtime(t2,t3);
+
+    uint64_t time_kmers = time_diff_ns(t2,t3);
+    std::cout << std::endl << "wrote " << num_kmers << " distinct " << k << "-mers in " << format_time(time_kmers) << std::endl;
+
+    if (mf.is_open()) {
+        mf << "RESULT";
+        mf << " type=kmers";
+        mf << " text=" << name_text_file;
+        mf << " a=" << index.balancing_parameter();
+        mf << " n=" << index.input_size();
+        mf << " sigma=" << std::to_string(index.alphabet_size());
+        mf << " r=" << index.num_bwt_runs();
+        mf << " r_=" << index.M_LF().num_intervals();
+        mf << " k=" << k;
+        mf << " min_freq=" << min_freq;
+        mf << " max_freq=" << max_freq;
+        mf << " num_threads=" << p;
+        mf << " num_kmers=" << num_kmers;
+        index.log_data_structure_sizes(mf);
+        mf << " time_kmers=" << time_kmers;
+        mf << std::endl;
+        mf.close();
+    }
+}
+
+int main(int argc, char **argv) {
+    if (argc < 4) help("");
+    while (ptr < argc - 3) parse_args(argv, argc, ptr);
+
+    path_index_file = argv[ptr];
+    k = atoll(argv[ptr+1]);
+    path_outputfile = argv[ptr+2];
+
+    if (k < 1) help("error: k < 1");
+
+    index_file.open(path_index_file);
+    if (!index_file.good()) help("error: could not read <index_file>");
+
+    bool is_64_bit;
+    index_file.read((char*)&is_64_bit,1);
+    move_r_support _support;
+    index_file.read((char*)&_support,sizeof(move_r_support));
+    index_file.seekg(0,std::ios::beg);
+
+    if (_support == _count) {
+        if (is_64_bit) {
+            measure_kmers<uint64_t,_count>();
+        } else {
+            measure_kmers<uint32_t,_count>();
+        }
+    } else if (_support == _locate_one) {
+        if (is_64_bit) {
+            measure_kmers<uint64_t,_locate_one>();
+        } else {
+            measure_kmers<uint32_t,_locate_one>();
+        }
+    } else if (_support == _locate_move) {
+        if (is_64_bit) {
+            measure_kmers<uint64_t,_locate_move>();
+        } else {
+            measure_kmers<uint32_t,_locate_move>();
+        }
+    } else if (_support == _locate_move_bi) {
+        if (is_64_bit) {
+            measure_kmers<uint64_t,_locate_move_bi>();
+        } else {
+            measure_kmers<uint32_t,_locate_move_bi>();
+        }
+    } else {
+        if (is_64_bit) {
+            measure_kmers<uint64_t,_locate_rlzdsa>();
+        } else {
+            measure_kmers<uint32_t,_locate_rlzdsa>();
+        }
+    }
+}
@@ -5,6 +5,8 @@
 int ptr = 1;
 bool output_occurrences = false;
 bool check_correctness = false;
+bool locate_sorted = false;
+bool reorder_rows = false;
 std::string input;
 std::ofstream mf;
 std::string path_index_file;
@@ -16,6 +18,7 @@ std::ifstream patterns_file;
 std::ifstream input_file;
 std::ofstream output_file;
 std::string name_text_file;
+uint16_t num_threads = 1;
 
 void help(std::string msg) {
     if (msg != "") std::cout << msg << std::endl;
@@ -26,6 +29,13 @@ void help(std::string msg) {
     std::cout << "   -m <m_file> <text_name>    m_file is the file to write measurement data to," << std::endl;
     std::cout << "                              text_name should be the name of the original file" << std::endl;
     std::cout << "   -o <output_file>           write pattern occurrences to this file (ASCII)" << std::endl;
+    std::cout << "   -p <integer>               maximum number of threads to use per pattern (default: 1)" << std::endl;
+    std::cout << "   -s                         locate the occurrences in increasing order (with locate_sorted), so" << std::endl;
+    std::cout << "                              they do not have to be sorted afterwards; uses one thread per pattern" << std::endl;
+    std::cout << "   -hp                        back the index with transparent huge pages" << std::endl;
+    std::cout << "   -numa                      interleave the index across all NUMA nodes" << std::endl;
+    std::cout << "   -ro                        reorder the rows of the move data structures after loading" << std::endl;
+    std::cout << "                              (faster on large repetitive inputs, but needs more space)" << std::endl;
     std::cout << "   <index_file>               index file (with extension .move-r)" << std::endl;
     std::cout << "   <patterns_file>            file in pizza&chili format containing the patterns" << std::endl;
     exit(0);
@@ -49,6 +59,18 @@ void parse_args(char **argv, int argc, int &ptr) {
         if (ptr >= argc-1) help("error: missing parameter after -o option.");
         output_occurrences = true;
         path_outputfile = argv[ptr++];
+    } else if (s == "-p") {
+        if (ptr >= argc-1) help("error: missing parameter after -p option.");
+        num_threads = atoi(argv[ptr++]);
+        if (num_threads < 1) help("error: p < 1");
+    } else if (s == "-s") {
+        locate_sorted = true;
+    } else if (s == "-hp") {
+        current_alloc_policy().huge_pages = true;
+    } else if (s == "-numa") {
+        current_alloc_policy().numa = _numa_interleave;
+    } else if (s == "-ro") {
+        reorder_rows = true;
     } else  {
         help("error: unrecognized '" + s + "' option");
     }
@@ -63,6 +85,11 @@ void measure_locate() {
     index.load(index_file);
     log_runtime(t1);
     index_file.close();
+
+    if (reorder_rows) {
+        index.reorder_rows(omp_get_max_threads(),true);
+    }
+
     std::cout << std::endl;
     index.log_data_structure_sizes();
 
@@ -103,13 +130,20 @@ void measure_locate() {
 
         patterns_file.read((char*)&pattern[0],pattern_length);
         t2 = now();
-        index.locate(pattern,occurrences);
+        if (locate_sorted) {
+            index.locate_sorted(pattern,occurrences);
+            is_sorted = true;
+        } else if (num_threads == 1) {
+            index.locate(pattern,occurrences);
+        } else {
+            index.locate(pattern,occurrences,num_threads);
+        }
         t3 = now();
         time_locate += time_diff_ns(t2,t3);
         num_occurrences += occurrences.size();
 
         if (check_correctness) {
-            ips4o::sort(occurrences.begin(),occurrences.end());
+            if (!is_sorted) ips4o::sort(occurrences.begin(),occurrences.end());
             is_sorted = true;
 
             if (occurrences.size() != (count = index.count(pattern))) {
@@ -167,8 +201,9 @@ void measure_locate() {
         mf << " r=" << index.num_bwt_runs();
         mf << " r_=" << index.M_LF().num_intervals();
 
-        if constexpr (support == _locate_move) {
+        if constexpr (support == _locate_move || support == _locate_move_bi) {
             mf << " r__=" << index.M_Phi_m1().num_intervals();
+            if constexpr (support == _locate_move_bi) mf << " r___=" << index.M_Phi().num_intervals();
         } else if constexpr (support == _locate_rlzdsa) {
             mf << " z__=" << index.num_phrases_rlzdsa();
             mf << " z_l_=" << index.num_literal_phrases_rlzdsa();
@@ -177,6 +212,9 @@ void measure_locate() {
 
         mf << " pattern_length=" << pattern_length;
         index.log_data_structure_sizes(mf);
+        mf << " num_threads=" << num_threads;
+        mf << " sorted=" << locate_sorted;
+        mf << " reordered=" << reorder_rows;
         mf << " num_patterns=" << num_patterns;
         mf << " num_occurrences=" << num_occurrences;
         mf << " time_locate=" << time_locate;
@@ -223,6 +261,12 @@ int main(int argc, char **argv) {
         } else {
             measure_locate<uint32_t,_locate_move>();
         }
+    } else if (_support == _locate_move_bi) {
+        if (is_64_bit) {
+            measure_locate<uint64_t,_locate_move_bi>();
+        } else {
+            measure_locate<uint32_t,_locate_move_bi>();
+        }
     } else {
         if (is_64_bit) {
             measure_locate<uint64_t,_locate_rlzdsa>();
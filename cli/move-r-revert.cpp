@@ -5,6 +5,7 @@
 int ptr = 1;
 uint16_t p = 1;
 bool revert_in_memory = false;
+bool reorder_rows = false;
 std::string path_index_file;
 std::string path_outputfile;
 std::string name_text_file;
@@ -22,6 +23,10 @@ void help(std::string msg) {
     std::cout << "                              (default: greatest possible)" << std::endl;
     std::cout << "   -m <m_file> <text_name>    m_file is the file to write measurement data to," << std::endl;
     std::cout << "                              text_name should be the name of the original file" << std::endl;
+    std::cout << "   -hp                        back the index with transparent huge pages" << std::endl;
+    std::cout << "   -numa                      interleave the index across all NUMA nodes" << std::endl;
+    std::cout << "   -ro                        reorder the rows of the move data structures after loading" << std::endl;
+    std::cout << "                              (faster on large repetitive inputs, but needs more space)" << std::endl;
     std::cout << "   <index_file>               index file (with extension .move-r)" << std::endl;
     std::cout << "   <output_file>              output file" << std::endl;
     exit(0);
@@ -44,6 +49,12 @@ void parse_args(char** argv, int argc, int &ptr) {
         p = atoi(argv[ptr++]);
         if (p < 1) help("error: p < 1");
         if (p > omp_get_max_threads()) help("error: p > number of available threads");
+    } else if (s == "-hp") {
+        current_alloc_policy().huge_pages = true;
+    } else if (s == "-numa") {
+        current_alloc_policy().numa = _numa_interleave;
+    } else if (s == "-ro") {
+        reorder_rows = true;
     } else  {
         help("error: unrecognized '" + s + "' option");
     }
@@ -58,6 +69,11 @@ void measure_revert() {
     index.load(index_file);
     log_runtime(t1);
     index_file.close();
+
+    if (reorder_rows) {
+        index.reorder_rows(omp_get_max_threads(),true);
+    }
+
     std::cout << std::endl;
     index.log_data_structure_sizes();
     std::cout << std::endl;
@@ -97,8 +113,9 @@ void measure_revert() {
         mf << " r_=" << index.M_LF().num_intervals();
 
         if constexpr (support != _count && support != _locate_one) {
-            if constexpr (support == _locate_move) {
+            if constexpr (support == _locate_move || support == _locate_move_bi) {
                 mf << " r__=" << index.M_Phi_m1().num_intervals();
+                if constexpr (support == _locate_move_bi) mf << " r___=" << index.M_Phi().num_intervals();
             } else if constexpr (support == _locate_rlzdsa) {
                 mf << " z__=" << index.num_phrases_rlzdsa();
                 mf << " z_l_=" << index.num_literal_phrases_rlzdsa();
@@ -108,6 +125,7 @@ void measure_revert() {
 
         index.log_data_structure_sizes(mf);
         mf << " time_revert=" << time_revert;
+        mf << " reordered=" << reorder_rows;
         mf << std::endl;
         mf.close();
     }
@@ -150,6 +168,12 @@ int main(int argc, char **argv) {
         } else {
             measure_revert<uint32_t,_locate_move>();
         }
+    } else if (_support == _locate_move_bi) {
+        if (is_64_bit) {
+            measure_revert<uint64_t,_locate_move_bi>();
+        } else {
+            measure_revert<uint32_t,_locate_move_bi>();
+        }
     } else {
         if (is_64_bit) {
             measure_revert<uint64_t,_locate_rlzdsa>();
@@ -21,11 +21,43 @@ int main() {
     // print the number of occurences of a pattern
     std::cout << index.count("test") << std::endl;
 
+    // count many patterns at once (their backward searches are interleaved)
+    auto counts = index.count_batch({"test","is","a"});
+    for (auto c : counts) std::cout << c << ", ";
+    std::cout << std::endl;
+
     // store all occurences of a pattern in a vector
     auto Occ = index.locate("is");
     for (auto o : Occ) std::cout << o << ", ";
     std::cout << std::endl;
 
+    // store the occurences of a pattern in increasing order
+    Occ = index.locate_sorted("is");
+
+    // store at most 2 occurrences of a pattern, which are spread
+    // evenly over its suffix array interval
+    Occ.clear();
+    index.locate("t",Occ,{.max_occ = 2, .spread = true});
+
+    // locate many patterns at once; the occurrences of the j-th
+    // pattern are stored in Occ_batch[Occ_offs[j]..Occ_offs[j+1]-1]
+    std::vector<std::string> patterns = {"is","t"};
+    std::vector<uint32_t> Occ_batch;
+    std::vector<uint64_t> Occ_offs;
+    index.locate_batch(patterns,Occ_batch,Occ_offs);
+
+    // build an index that also stores M_Phi, so the occurrences are
+    // decoded from both ends of their suffix array interval at once
+    move_r<_locate_move_bi> index_bi("This is a test string");
+    std::vector<uint32_t> Occ_bi = index_bi.locate("is");
+
+    // split the input into documents, which are separated by ' ', and print
+    // the documents containing "is" and the number of occurrences in each
+    index.build_document_array(' ');
+    for (auto d : index.list_documents("is")) std::cout << d << ", ";
+    for (auto [d,c] : index.count_per_document("is")) std::cout << d << ":" << c << ", ";
+    auto top_docs = index.top_k_documents("t",1);
+
     // build an index for an integer vector using a relative
     // lempel-ziv encoded differential suffix array (rlzdsa)
     move_r<_locate_rlzdsa,int32_t> index_3({2,-1,5,-1,7,2,-1});
@@ -42,6 +74,13 @@ int main() {
     std::cout << "b = " << query.sa_interval().first
             << ", e = " << query.sa_interval().second << std::endl;
 
+    // print the symbols c preceding the occurrences of [2,-1] and the
+    // suffix-array intervals of [c,2,-1]
+    auto [b,e] = query.sa_interval();
+    for (auto [c,b_c,e_c] : index_3.interval_symbols(b,e)) {
+        std::cout << c << ": [" << b_c << ", " << e_c << "]" << std::endl;
+    }
+
     // incrementally locate the occurrences of [2,-1] in the input vector
     while (query.num_occ_rem() > 0) {
         std::cout << query.next_occ() << ", " << std::flush;
@@ -53,4 +92,44 @@ int main() {
     uint32_t suffix = pattern.size();
     while (suffix > 0 && query_2.prepend(pattern[suffix-1])) suffix--;
     std::cout << std::endl << suffix << std::flush;
+
+    // the same without a loop: prepend_many() prepends the symbols of an array
+    // from right to left and returns the length of the longest suffix that occurs
+    auto query_4 = index_3.query();
+    std::cout << std::endl << query_4.prepend_many(pattern.data(),pattern.size()) << std::flush;
+
+    // store the state of a query context, extend it and restore the state
+    auto state = query_4.state();
+    query_4.prepend(-1);
+    query_4.restore(state);
+
+    // build a bidirectional index, whiches patterns can also be extended to the right,
+    // and the thresholds, which enable matching statistics
+    move_r<> index_4("This is a test string",{.bidirectional = true, .build_thresholds = true});
+
+    // search "is a" by starting with " " and extending it in both directions
+    auto query_3 = index_4.query();
+    query_3.prepend(' ');
+    query_3.append('a');
+    query_3.prepend('s');
+    query_3.prepend('i');
+    std::cout << std::endl << query_3.num_occ() << ", " << query_3.one_occ() << std::flush;
+
+    // compute the matching statistics of a pattern, i.e., for each position i the
+    // length of the longest prefix of P[i..|P|-1] that occurs in the input (this
+    // requires the thresholds and takes O(|P|) time, if the text position samples
+    // have been built, see move_r_params::sample_rate_isa)
+    auto MS = index_4.matching_statistics("This is not a test");
+
+    // compute the maximal exact matches of length at least 3 of a pattern; each MEM
+    // is a tuple (position in the pattern, length, position in the input)
+    for (auto [i,l,t] : index_4.maximal_exact_matches("This is not a test",3)) {
+        std::cout << std::endl << i << ", " << l << ", " << t << std::flush;
+    }
+
+    // find the substrings of the input within edit distance 1 of "tast"; each match
+    // stores the suffix array interval [b,e] of the matched substring
+    for (auto m : index_4.approximate_matches("tast",{.k = 1, .edits = true})) {
+        std::cout << std::endl << m.b << ", " << m.e << ", " << m.errors << std::flush;
+    }
 }
\ No newline at end of file
@@ -17,6 +17,25 @@ int main() {
     index.revert([](auto,auto c){std::cout << c;},{.num_threads = 1});
     std::cout << std::endl;
 
+    // build the text position samples with sample rate 4 and extract
+    // the range [5,13] with at most 13-5+4 LF steps
+    index.build_isa_samples(4);
+    std::cout << index.extract(5,13) << std::endl;
+
+    // build the suffix array samples with sample rate 4 and compute
+    // SA[7] with less than 4 Phi^{-1} move queries
+    index.build_sa_samples(4);
+    std::cout << index.SA(7) << std::endl;
+
+    // print the 3-mers that occur at least twice with their frequencies,
+    // write all 3-mers to the file "test_3-mers.kmers" using at most 4
+    // threads and remove the file again
+    for (auto [kmer,freq] : index.kmers(3,{.min_freq = 2})) {
+        std::cout << kmer << ": " << freq << std::endl;
+    }
+    index.write_kmers(3,"test_3-mers.kmers",{.num_threads = 4});
+    std::filesystem::remove("test_3-mers.kmers");
+
     // retrieve the suffix array values in the range [2,6] using at
     // most 4 threads and store them in a vector
     std::vector<uint32_t> SA_range = index.SA({
@@ -28,6 +47,16 @@ int main() {
     // print SA[1]
     std::cout << index.SA(1) << std::endl;
 
+    // print ISA[3], the position of the suffix starting at 3 in SA
+    std::cout << index.ISA(3) << std::endl;
+
+    // build an index that also stores the PLCP samples, print LCP[5]
+    // and the lcp array in the range [3,8]
+    move_r<> index_2("This is a test string",{.build_lcp = true});
+    std::cout << index_2.LCP(5) << std::endl;
+    for (auto l : index_2.lcp_range(3,8)) std::cout << l << ", ";
+    std::cout << std::endl;
+
     // retrieve the BWT in the range [7,14] from left to right
     // using 1 thread
     index.BWT([](auto,auto s){std::cout << s << ", ";},{
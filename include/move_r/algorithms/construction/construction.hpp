@@ -35,6 +35,9 @@ class move_r<support,sym_t,pos_t>::construction {
     uint16_t p_ = 1;
     bool build_sa_and_l = false; // controls whether the index should be built from the suffix array and the bwt
     bool delete_T = false; // controls whether T should be deleted when not needed anymore
+    bool build_plcp = false; // controls whether the PLCP samples should be built (only in the suffix array modes)
+    std::vector<uint64_t> doc_starts; // starting positions of the documents (empty <=> no document array is built)
+    bool build_thr = false; // controls whether the thresholds should be built (only for _locate_move, _locate_move_bi and _locate_rlzdsa)
     bool log = false; // controls, whether to print log messages
     std::ostream* mf_idx = NULL; // file to write measurement data of the index construction to 
     std::ostream* mf_mds = NULL; // file to write measurement data of the move data structure construction to 
@@ -92,6 +95,13 @@ class move_r<support,sym_t,pos_t>::construction {
     /** [0..r'-1] SA_s[x] = SA[M_LF.p[x]]; if the starting position of the
      * x-th input interval of M_LF is not starting position of a BWT run, then SA_s[x] = n */
     std::vector<pos_t> SA_s;
+    /** [0..r'-1] SA_e[x] = SA[M_LF.p[x+1]-1]; if the end position of the x-th input interval of M_LF
+     * is not an end position of a BWT run, then SA_e[x] = n (only for _locate_move_bi) */
+    std::vector<pos_t> SA_e;
+    /** thresholds of the bwt runs and suffix array values at their end positions (in the order of the runs), which
+     * are stored in the index after M_LF and L' have been built (see move_r::thresholds_of_runs()) */
+    std::vector<pos_t> THR_r;
+    std::vector<pos_t> SA_e_r;
     /** [0..r'-1] Permutation storing the order of the values in SA_s */
     std::vector<pos_t> pi_;
     /** [0..r''-1] Permutation storing the order of the output interval starting positions of M_Phi^{-1} */
@@ -488,6 +498,9 @@ class move_r<support,sym_t,pos_t>::construction {
         this->mf_idx = params.mf_idx;
         this->mf_mds = params.mf_mds;
         this->name_text_file = params.name_text_file;
+        this->build_plcp = params.build_lcp;
+        this->doc_starts = std::move(params.doc_starts);
+        this->build_thr = supports_multiple_locate && params.build_thresholds;
     }
 
     /**
@@ -618,6 +631,27 @@ class move_r<support,sym_t,pos_t>::construction {
 
         prepare_phase_1();
         prepare_phase_2();
+
+        if (build_plcp || !doc_starts.empty() || build_thr) {
+            /* T is needed to compute the PLCP samples, ILCP and the thresholds, so it is restored from L with T[SA[i]-1] = L[i]; T[n-1]
+               is set to 0, such that it is unique (in L, it is $ = 1) */
+            std::vector<sa_sint_t>& SA = get_sa<sa_sint_t>();
+            no_init_resize(T_str,n);
+
+            #pragma omp parallel for num_threads(p)
+            for (uint64_t i=0; i<n; i++) {
+                if (SA[i] != 0) T_str[SA[i]-1] = L[i];
+            }
+
+            T_str[n-1] = uchar_to_char((uint8_t)0);
+
+            if (build_plcp) build_plcp_samples<sa_sint_t>();
+            if (!doc_starts.empty()) build_documents<sa_sint_t>();
+            if (build_thr) build_thresholds<sa_sint_t>();
+            T_str.clear();
+            T_str.shrink_to_fit();
+        }
+
         build_rlbwt_c<_bwt,sa_sint_t>();
         if (log) log_statistics();
         build_ilf();
@@ -631,7 +665,7 @@ class move_r<support,sym_t,pos_t>::construction {
         }
 
         if constexpr (supports_multiple_locate) {
-            if constexpr (support == _locate_move) {
+            if constexpr (uses_m_phi_m1) {
                 sort_iphim1();
                 build_mphim1();
                 build_saphim1();
@@ -642,6 +676,7 @@ class move_r<support,sym_t,pos_t>::construction {
         }
 
         build_rsl_();
+        if (build_thr) store_thresholds();
         if (log) log_finished();
     }
 
@@ -668,6 +703,9 @@ class move_r<support,sym_t,pos_t>::construction {
 
         prepare_phase_2();
         build_sa<sa_sint_t>();
+        if (build_plcp) build_plcp_samples<sa_sint_t>();
+        if (!doc_starts.empty()) build_documents<sa_sint_t>();
+        if (build_thr) build_thresholds<sa_sint_t>();
         build_rlbwt_c<_sa,sa_sint_t>();
         if (log) log_statistics();
         build_ilf();
@@ -680,7 +718,7 @@ class move_r<support,sym_t,pos_t>::construction {
             build_l__sas<true>();
 
             if constexpr (supports_multiple_locate) {
-                if constexpr (support == _locate_move) {
+                if constexpr (uses_m_phi_m1) {
                     if (_space) store_sas();
                     build_rsl_();
                     if (_space) store_rsl_();
@@ -713,6 +751,8 @@ class move_r<support,sym_t,pos_t>::construction {
             build_rsl_();
         }
 
+        if (build_thr) store_thresholds();
+
         if constexpr (int_alphabet) {
             if (idx.symbols_remapped &&
                 mode == _suffix_array_space
@@ -725,6 +765,11 @@ class move_r<support,sym_t,pos_t>::construction {
      */
     void construct_from_bigbwt() {
         prepare_phase_2();
+
+        if (build_plcp && log) {
+            std::cout << "warning: the PLCP samples cannot be built with Big-BWT, ignoring build_lcp" << std::endl;
+        }
+
         bigbwt();
         build_rlbwt_c<_bwt_file,int32_t>();
         if (log) log_statistics();
@@ -735,7 +780,7 @@ class move_r<support,sym_t,pos_t>::construction {
 
         if constexpr (supports_locate) {
             if constexpr (supports_multiple_locate) {
-                if constexpr (support == _locate_move) {
+                if constexpr (uses_m_phi_m1) {
                     read_iphim1_bigbwt();
                     build_l__sas<true>();
                     store_sas();
@@ -773,6 +818,16 @@ class move_r<support,sym_t,pos_t>::construction {
             build_l__sas<false>();
             build_rsl_();
         }
+
+        if (!doc_starts.empty()) {
+            // the suffix array is not in memory, so ILCP is computed with the index (see move_r::build_document_array())
+            idx.build_document_array(std::vector<pos_t>(doc_starts.begin(),doc_starts.end()),p,log);
+        }
+
+        if constexpr (supports_multiple_locate) {
+            // the suffix array is not in memory, so the thresholds are computed with the index
+            if (build_thr) idx.build_thresholds(p,log);
+        }
     };
 
     /**
@@ -873,10 +928,16 @@ class move_r<support,sym_t,pos_t>::construction {
     void sort_iphim1();
 
     /**
-     * @brief builds M_Phi^{-1}
+     * @brief builds M_Phi^{-1} (and M_Phi and SA_Phi for _locate_move_bi)
      */
     void build_mphim1();
 
+    /**
+     * @brief builds M_Phi from I_Phi^{-1} (by swapping the input and output interval starting positions)
+     * and SA_Phi from SA_e
+     */
+    void build_mphi();
+
     /**
      * @brief builds SA_Phi^{-1}
      */
@@ -957,6 +1018,34 @@ class move_r<support,sym_t,pos_t>::construction {
     template <typename sa_sint_t>
     void build_sa();
 
+    /**
+     * @brief builds the PLCP samples by comparing T at the irreducible positions, i.e., the suffix array values at the
+     * starting positions of the bwt runs, with T at their Phi-values; this takes O(n log r) time in total
+     * @tparam sa_sint_t suffix array signed integer type
+     */
+    template <typename sa_sint_t>
+    void build_plcp_samples();
+
+    /**
+     * @brief builds the document array from doc_starts and, if the index supports locating all occurrences, ILCP from
+     * the suffix array and T (see move_r::build_ilcp())
+     * @tparam sa_sint_t suffix array signed integer type
+     */
+    template <typename sa_sint_t>
+    void build_documents();
+
+    /**
+     * @brief computes the thresholds of the bwt runs from the suffix array and T (see move_r::thresholds_of_runs())
+     * @tparam sa_sint_t suffix array signed integer type
+     */
+    template <typename sa_sint_t>
+    void build_thresholds();
+
+    /**
+     * @brief stores the thresholds of the bwt runs in the index (requires M_LF and L')
+     */
+    void store_thresholds();
+
     /**
      * @brief unmaps T from the internal alphabet
      */
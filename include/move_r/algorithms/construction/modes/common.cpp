@@ -604,8 +604,9 @@ void move_r<support,sym_t,pos_t>::construction::build_l__sas() {
     }
 
     if constexpr (build_sas_) {
-        if constexpr (support == _locate_move) {
+        if constexpr (uses_m_phi_m1) {
             no_init_resize(SA_s,r_);
+            if constexpr (uses_m_phi) no_init_resize(SA_e,r_);
         } else {
             idx._SA_s.resize_no_init(r_);
         }
@@ -634,11 +635,16 @@ void move_r<support,sym_t,pos_t>::construction::build_l__sas() {
         for (pos_t i=0; i<rp_diff; i++) {
             idx._M_LF.template set_L_(j,run_sym(i_p,i));
             if constexpr (build_sas_) {
-                if constexpr (support == _locate_move ) {
+                if constexpr (uses_m_phi_m1) {
                     SA_s[j] = I_Phi_m1[b_r+i].second;
                 } else {
                     idx._SA_s.template set<0,pos_t>(j,I_Phi_m1[b_r+i].second);
                 }
+
+                if constexpr (uses_m_phi) {
+                    // the input interval before the j-th one ends at the end position of the previous bwt run
+                    SA_e[j == 0 ? r_-1 : j-1] = I_Phi_m1[b_r+i].first;
+                }
             }
 
             j++;
@@ -650,8 +656,9 @@ void move_r<support,sym_t,pos_t>::construction::build_l__sas() {
             // created by the balancing algorithm
             while (idx._M_LF.p(j) < l_) {
                 if constexpr (build_sas_) {
-                    if constexpr (support == _locate_move) {
+                    if constexpr (uses_m_phi_m1) {
                         SA_s[j] = n;
+                        if constexpr (uses_m_phi) SA_e[j-1] = n;
                     } else {
                         idx._SA_s.template set<0,pos_t>(j,n);
                     }
@@ -710,12 +717,14 @@ void move_r<support,sym_t,pos_t>::construction::sort_iphim1() {
 
 template <move_r_support support, typename sym_t, typename pos_t>
 void move_r<support,sym_t,pos_t>::construction::build_mphim1() {
+    if constexpr (uses_m_phi) build_mphi();
+
     if (log) {
         time = now();
         std::cout << std::endl << "building M_Phi^{-1}" << std::flush;
     }
 
-    idx._M_Phi_m1 = move_data_structure<pos_t>(std::move(I_Phi_m1),n,{
+    idx._M_Phi_m1 = mds_phi_t(std::move(I_Phi_m1),n,{
         .num_threads=p,
         .a=idx.a,
         .log=log,
@@ -735,6 +744,98 @@ void move_r<support,sym_t,pos_t>::construction::build_mphim1() {
     }
 }
 
+template <move_r_support support, typename sym_t, typename pos_t>
+void move_r<support,sym_t,pos_t>::construction::build_mphi() {
+    if (log) {
+        time = now();
+        std::cout << std::endl << "building M_Phi" << std::flush;
+    }
+
+    // I_Phi^{-1} contains the pair <SA[i-1],SA[i]> for each bwt run start i, hence I_Phi contains <SA[i],SA[i-1]>
+    std::vector<std::pair<pos_t,pos_t>> I_Phi;
+    no_init_resize(I_Phi,r);
+
+    #pragma omp parallel for num_threads(p)
+    for (uint64_t i=0; i<r; i++) {
+        I_Phi[i] = std::make_pair(I_Phi_m1[i].second,I_Phi_m1[i].first);
+    }
+
+    // Sort I_Phi by the starting positions of its input intervals.
+    auto comp_I_Phi = [](std::pair<pos_t,pos_t> p1, std::pair<pos_t,pos_t> p2) {return p1.first < p2.first;};
+
+    if (p > 1) {
+        ips4o::parallel::sort(I_Phi.begin(),I_Phi.end(),comp_I_Phi);
+    } else {
+        ips4o::sort(I_Phi.begin(),I_Phi.end(),comp_I_Phi);
+    }
+
+    // [0..r'''-1] Permutation storing the order of the output interval starting positions of M_Phi
+    std::vector<pos_t> pi_mphi_fwd;
+
+    idx._M_Phi = mds_phi_t(std::move(I_Phi),n,{
+        .num_threads=p,
+        .a=idx.a,
+        .log=log
+    },&pi_mphi_fwd);
+
+    idx.r___ = idx._M_Phi.num_intervals();
+
+    if (log) {
+        if (mf_idx != NULL) {
+            *mf_idx << " time_build_mphi_fwd=" << time_diff_ns(time,now());
+            *mf_idx << " r___=" << idx.r___;
+        }
+        std::cout << std::endl;
+        time = now();
+        std::cout << "building SA_Phi" << std::flush;
+    }
+
+    // [0..r-1] the input intervals of M_LF that end at a bwt run end, sorted by the suffix array values at their end positions
+    std::vector<pos_t> pi_e;
+    pi_e.reserve(r);
+
+    for (pos_t x=0; x<r_; x++) {
+        if (SA_e[x] != n) pi_e.emplace_back(x);
+    }
+
+    auto comp_pi_e = [this](pos_t i, pos_t j){return SA_e[i] < SA_e[j];};
+    if (p > 1) {
+        ips4o::parallel::sort(pi_e.begin(),pi_e.end(),comp_pi_e);
+    } else {
+        ips4o::sort(pi_e.begin(),pi_e.end(),comp_pi_e);
+    }
+
+    idx._SA_Phi = interleaved_vectors<pos_t,pos_t>({(uint8_t)(idx._M_Phi.width_idx()/8)});
+    idx._SA_Phi.resize_no_init(r_);
+
+    // mark the input intervals of M_LF that do not end at a bwt run end
+    #pragma omp parallel for num_threads(p)
+    for (uint64_t x=0; x<r_; x++) {
+        if (SA_e[x] == n) idx._SA_Phi.template set<0,pos_t>(x,idx.r___);
+    }
+
+    /* each SA_e[x] != n is the starting position of an output interval of M_Phi, so simultaneously iterate over the output
+    intervals of M_Phi and the values in SA_e in ascending order, skipping the output intervals added by the balancing algorithm */
+    pos_t i = 0;
+
+    for (pos_t x : pi_e) {
+        while (idx._M_Phi.q(pi_mphi_fwd[i]) != SA_e[x]) {
+            i++;
+        }
+
+        idx._SA_Phi.template set<0,pos_t>(x,pi_mphi_fwd[i]);
+        i++;
+    }
+
+    SA_e.clear();
+    SA_e.shrink_to_fit();
+
+    if (log) {
+        if (mf_idx != NULL) *mf_idx << " time_build_saphi=" << time_diff_ns(time,now());
+        time = log_runtime(time);
+    }
+}
+
 template <move_r_support support, typename sym_t, typename pos_t>
 void move_r<support,sym_t,pos_t>::construction::build_saphim1() {
     time = now();
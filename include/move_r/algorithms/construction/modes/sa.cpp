@@ -68,6 +68,116 @@ void move_r<support,sym_t,pos_t>::construction::build_sa() {
     }
 }
 
+template <move_r_support support, typename sym_t, typename pos_t>
+template <typename sa_sint_t>
+void move_r<support,sym_t,pos_t>::construction::build_plcp_samples() {
+    if (log) {
+        time = now();
+        std::cout << "building PLCP samples" << std::flush;
+    }
+
+    std::vector<sa_sint_t>& SA = get_sa<sa_sint_t>(); // [0..n-1] The suffix array
+
+    // [0..p-1] pairs <j,PLCP[j]> of the irreducible positions j found by each thread
+    std::vector<std::vector<std::pair<pos_t,pos_t>>> PLCP_s_thr(p);
+
+    // SA[0] = n-1 is irreducible and PLCP[n-1] = 0
+    PLCP_s_thr[0].emplace_back(std::make_pair(n-1,0));
+
+    #pragma omp parallel for schedule(dynamic,65536) num_threads(p)
+    for (uint64_t i=1; i<n; i++) {
+        pos_t j = SA[i];
+        pos_t j_ = SA[i-1];
+
+        // skip i, if it is not the starting position of a bwt run, i.e., L[i] = L[i-1]
+        if (j != 0 && j_ != 0 && T<i_sym_t>(j-1) == T<i_sym_t>(j_-1)) continue;
+
+        // compute PLCP[j] = lcp(T[j..n-1],T[j'..n-1]); because T[n-1] = 0 is unique, this stops before n-1
+        pos_t l = 0;
+        while (T<i_sym_t>(j+l) == T<i_sym_t>(j_+l)) l++;
+        PLCP_s_thr[omp_get_thread_num()].emplace_back(std::make_pair(j,l));
+    }
+
+    // [0..r-1] pairs <j,PLCP[j]> of all irreducible positions j
+    std::vector<std::pair<pos_t,pos_t>> PLCP_s;
+    uint64_t num_irr = 0;
+    for (uint16_t i_p=0; i_p<p; i_p++) num_irr += PLCP_s_thr[i_p].size();
+    PLCP_s.reserve(num_irr);
+
+    for (uint16_t i_p=0; i_p<p; i_p++) {
+        PLCP_s.insert(PLCP_s.end(),PLCP_s_thr[i_p].begin(),PLCP_s_thr[i_p].end());
+        PLCP_s_thr[i_p].clear();
+        PLCP_s_thr[i_p].shrink_to_fit();
+    }
+
+    if (p == 1) {
+        ips4o::sort(PLCP_s.begin(),PLCP_s.end());
+    } else {
+        ips4o::parallel::sort(PLCP_s.begin(),PLCP_s.end());
+    }
+
+    pos_t max_plcp = 0;
+    for (auto& [j,l] : PLCP_s) max_plcp = std::max(max_plcp,l);
+
+    sdsl::sd_vector_builder PLCP_I_builder(n,PLCP_s.size());
+    idx._PLCP_s = interleaved_vectors<pos_t,pos_t>({(uint8_t)std::max<double>(1,std::ceil(std::log2(max_plcp+1)/(double)8))});
+    idx._PLCP_s.resize_no_init(PLCP_s.size());
+
+    for (pos_t k=0; k<PLCP_s.size(); k++) {
+        PLCP_I_builder.set(PLCP_s[k].first);
+        idx._PLCP_s.template set<0,pos_t>(k,PLCP_s[k].second);
+    }
+
+    idx._PLCP_I = sd_array<pos_t>(sdsl::sd_vector<>(PLCP_I_builder));
+
+    if (log) {
+        if (mf_idx != NULL) *mf_idx << " time_build_plcp=" << time_diff_ns(time,now());
+        time = log_runtime(time);
+    }
+}
+
+template <move_r_support support, typename sym_t, typename pos_t>
+template <typename sa_sint_t>
+void move_r<support,sym_t,pos_t>::construction::build_documents() {
+    idx.build_document_starts(doc_starts);
+
+    if constexpr (supports_multiple_locate) {
+        std::vector<sa_sint_t>& SA = get_sa<sa_sint_t>(); // [0..n-1] The suffix array
+        idx.build_ilcp(SA,[this](pos_t j){return T<i_sym_t>(j);},log);
+    }
+}
+
+template <move_r_support support, typename sym_t, typename pos_t>
+template <typename sa_sint_t>
+void move_r<support,sym_t,pos_t>::construction::build_thresholds() {
+    if constexpr (supports_multiple_locate) {
+        if (log) {
+            time = now();
+            std::cout << "building the thresholds" << std::flush;
+        }
+
+        std::vector<sa_sint_t>& SA = get_sa<sa_sint_t>(); // [0..n-1] The suffix array
+        idx.thresholds_of_runs(SA,[this](pos_t j){return T<i_sym_t>(j);},THR_r,SA_e_r);
+
+        if (log) {
+            if (mf_idx != NULL) *mf_idx << " time_build_thr=" << time_diff_ns(time,now());
+            time = log_runtime(time);
+        }
+    }
+}
+
+template <move_r_support support, typename sym_t, typename pos_t>
+void move_r<support,sym_t,pos_t>::construction::store_thresholds() {
+    if constexpr (supports_multiple_locate) {
+        idx.build_thresholds(THR_r,SA_e_r);
+
+        THR_r.clear();
+        THR_r.shrink_to_fit();
+        SA_e_r.clear();
+        SA_e_r.shrink_to_fit();
+    }
+}
+
 template <move_r_support support, typename sym_t, typename pos_t>
 void move_r<support,sym_t,pos_t>::construction::store_mapintext() {
     if (log) {
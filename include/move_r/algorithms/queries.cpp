@@ -3,7 +3,7 @@
 #include <move_r/move_r.hpp>
 
 template <move_r_support support, typename sym_t, typename pos_t>
-void move_r<support,sym_t,pos_t>::setup_phi_m1_move_pair(pos_t& x, pos_t& s, pos_t& s_) const requires(support == _locate_move) {
+void move_r<support,sym_t,pos_t>::setup_phi_m1_move_pair(pos_t& x, pos_t& s, pos_t& s_) const requires(uses_m_phi_m1) {
     // the index of the pair in M_Phi^{-1} creating the output interval with starting position s = SA[M_LF.p[x]]
     pos_t x_s_ = SA_Phi_m1(x);
 
@@ -14,6 +14,18 @@ void move_r<support,sym_t,pos_t>::setup_phi_m1_move_pair(pos_t& x, pos_t& s, pos
     s = M_Phi_m1().p(s_)+M_Phi_m1().offs(x_s_);
 }
 
+template <move_r_support support, typename sym_t, typename pos_t>
+void move_r<support,sym_t,pos_t>::setup_phi_move_pair(pos_t& x, pos_t& s, pos_t& s_) const requires(uses_m_phi) {
+    // the index of the pair in M_Phi creating the output interval with starting position s = SA[M_LF.p[x+1]-1]
+    pos_t x_s_ = SA_Phi(x);
+
+    // set s_ to the index of the input interval in M_Phi containing s
+    s_ = M_Phi().idx(x_s_);
+    
+    // compute s
+    s = M_Phi().p(s_)+M_Phi().offs(x_s_);
+}
+
 template <move_r_support support, typename sym_t, typename pos_t>
 sym_t move_r<support,sym_t,pos_t>::BWT(pos_t i) const {
     // find the index of the input interval in M_LF containing i with a binary search.
@@ -36,6 +48,11 @@ pos_t move_r<support,sym_t,pos_t>::SA(pos_t i) const requires(supports_multiple_
 
         return s;
     } else {
+        // if i is a sampled suffix array position, SA[i] is stored in SA_sr
+        if (sr_sa != 0 && i % sr_sa == 0) {
+            return _SA_sr.template get<0,pos_t>(i/sr_sa);
+        }
+
         // index of the input interval in M_LF containing i.
         pos_t x = bin_search_max_leq<pos_t>(i,0,r_-1,[this](pos_t x_){return M_LF().p(x_);});
 
@@ -52,9 +69,46 @@ pos_t move_r<support,sym_t,pos_t>::SA(pos_t i) const requires(supports_multiple_
             }
         }
 
-        // decrement x until the starting position of the x-th input interval of M_LF is a starting position of a bwt run
-        while (SA_Phi_m1(x) == r__) {
-            x--;
+        if constexpr (uses_m_phi) {
+            // increment x_e until the end position of the x_e-th input interval of M_LF is an end position of a bwt run
+            pos_t x_e = x;
+
+            while (SA_Phi(x_e) == r___) {
+                x_e++;
+            }
+
+            // decrement x until the starting position of the x-th input interval of M_LF is a starting position of a bwt run
+            while (SA_Phi_m1(x) == r__) {
+                x--;
+            }
+
+            // position in the suffix array of the current suffix s
+            pos_t j = M_LF().p(x_e+1)-1;
+            // nearest position to the left of i, at which SA is known (start of the bwt run or a suffix array sample)
+            pos_t i_s = M_LF().p(x);
+            if (sr_sa != 0) i_s = std::max<pos_t>(i_s,i-i%sr_sa);
+
+            // if the end of the bwt run is closer to i than i_s, perform Phi-move queries from there
+            if (j-i < i-i_s) {
+                // index of the input interval in M_Phi containing s
+                pos_t s_;
+                // the current suffix (s = SA[j])
+                pos_t s;
+
+                setup_phi_move_pair(x_e,s,s_);
+
+                while (j > i) {
+                    M_Phi().move(s,s_);
+                    j--;
+                }
+
+                return s;
+            }
+        } else {
+            // decrement x until the starting position of the x-th input interval of M_LF is a starting position of a bwt run
+            while (SA_Phi_m1(x) == r__) {
+                x--;
+            }
         }
 
         // begin iterating at the start of the x-th run, because there is a
@@ -68,21 +122,130 @@ pos_t move_r<support,sym_t,pos_t>::SA(pos_t i) const requires(supports_multiple_
         // the current suffix (s = SA[j])
         pos_t s;
 
-        setup_phi_m1_move_pair(x,s,s_);
+        // if there is a suffix array sample in SA_sr between the start of the run and i, begin iterating there instead
+        if (sr_sa != 0 && i-i%sr_sa > j) {
+            j = i-i%sr_sa;
+            s = _SA_sr.template get<0,pos_t>(j/sr_sa);
+            s_ = _SA_sr.template get<1,pos_t>(j/sr_sa);
+        } else {
+            setup_phi_m1_move_pair(x,s,s_);
+        }
 
         // Perform Phi-move queries until s is the suffix at position
         // i; in each iteration, s = SA[j] = \Phi^{i-j}(SA[i]) holds.
-        while (j < i) {
-            // Set s = \Phi(s)
-            M_Phi_m1().move(s,s_);
-            j++;
-        }
+        with_m_phi_m1_rows(s_,[&](const auto& m_phi_m1){
+            while (j < i) {
+                // Set s = \Phi(s)
+                m_phi_m1.move(s,s_);
+                j++;
+            }
+        });
 
         // Since j = i, now s = SA[i] holds.
         return s;
     }
 }
 
+template <move_r_support support, typename sym_t, typename pos_t>
+pos_t move_r<support,sym_t,pos_t>::ISA(pos_t j) const {
+    // SA[0] = n-1
+    if (j == n-1) return 0;
+
+    // the nearest text position j' >= j-1, for which the position i in the bwt with L[i] = T[j'] is known
+    pos_t j_;
+    // The position in the bwt of the current character in T.
+    pos_t i;
+    // index of the input interval in M_LF containing i.
+    pos_t x;
+
+    if (sr_isa != 0) {
+        // index of the sample at the nearest sampled text position j' >= j-1
+        pos_t k = (j == 0 ? 0 : j-1)/sr_isa;
+        j_ = std::min<uint64_t>((uint64_t{k}+1)*sr_isa-1,n-2);
+        i = _ISA_s.template get<0,pos_t>(k);
+        x = _ISA_s.template get<1,pos_t>(k);
+    } else {
+        // the section of the input, in which the iteration starts
+        uint16_t s = p_r == 1 ? 0 : bin_search_min_geq<pos_t>(j == 0 ? 0 : j-1,0,p_r-1,[this](pos_t x_){return _D_e[x_].second;});
+        j_ = s == p_r-1 ? n-2 : _D_e[s].second;
+        x = s == p_r-1 ? 0 : _D_e[s].first;
+        i = s == p_r-1 ? 0 : M_LF().p(x);
+    }
+
+    // L[i] = T[j'], so SA[i] = j'+1; perform LF steps until SA[i] = j
+    with_m_lf_rows(x,[&](const auto& m_lf){
+        for (pos_t t = j_+1; t > j; t--) {
+            // Set i <- LF(i).
+            m_lf.move(i,x);
+        }
+    });
+
+    return i;
+}
+
+template <move_r_support support, typename sym_t, typename pos_t>
+std::vector<std::tuple<sym_t,pos_t,pos_t>> move_r<support,sym_t,pos_t>::interval_symbols(pos_t b, pos_t e) const {
+    std::vector<std::tuple<sym_t,pos_t,pos_t>> symbols;
+    if (b > e || e > n-1) return symbols;
+
+    // indices of the input intervals in M_LF containing b and e
+    pos_t b_ = bin_search_max_leq<pos_t>(b,0,r_-1,[this](pos_t x){return M_LF().p(x);});
+    pos_t e_ = bin_search_max_leq<pos_t>(e,b_,r_-1,[this](pos_t x){return M_LF().p(x);});
+
+    interval_symbols(b,e,b_,e_,[this,&symbols](i_sym_t c, pos_t b_c, pos_t e_c, pos_t, pos_t){
+        symbols.emplace_back(unmap_symbol(c),b_c,e_c);
+    });
+
+    return symbols;
+}
+
+template <move_r_support support, typename sym_t, typename pos_t>
+template <typename report_t>
+void move_r<support,sym_t,pos_t>::interval_symbols(pos_t b, pos_t e, pos_t b_, pos_t e_, report_t&& report) const {
+    // reports c with the suffix array interval [LF(i_f),LF(i_l)], where L'[x_f] = L'[x_l] = c, i_f = max(b,p(x_f)) and i_l = min(e,p(x_l+1)-1)
+    auto report_symbol = [&](i_sym_t c, pos_t x_f, pos_t x_l){
+        pos_t b_c = std::max(b,M_LF().p(x_f));
+        pos_t e_c = std::min(e,M_LF().p(x_l+1)-1);
+        M_LF().move(b_c,x_f);
+        M_LF().move(e_c,x_l);
+        report(c,b_c,e_c,x_f,x_l);
+    };
+
+    if (e_-b_ < sigma-1) {
+        // pairs (L'[x],x) for x in [b',e']
+        std::vector<std::pair<i_sym_t,pos_t>> runs;
+        runs.reserve(e_-b_+1);
+
+        for (pos_t x=b_; x<=e_; x++) {
+            if (L_(x) != 0) runs.emplace_back(L_(x),x);
+        }
+
+        std::sort(runs.begin(),runs.end());
+
+        // report the first and the last run of each symbol
+        uint64_t k = 0;
+
+        while (k < runs.size()) {
+            uint64_t k_ = k+1;
+            while (k_ < runs.size() && runs[k_].first == runs[k].first) k_++;
+            report_symbol(runs[k].first,runs[k].second,runs[k_-1].second);
+            k = k_;
+        }
+    } else {
+        for (uint64_t c=1; c<(byte_alphabet ? 256 : sigma); c++) {
+            if (!RS_L_().contains(c)) continue;
+
+            // number of occurrences of c in L'[0..b'-1] and in L'[0..e']
+            pos_t rnk_b = RS_L_().rank(c,b_);
+            pos_t rnk_e = RS_L_().rank(c,e_)+(L_(e_) == c);
+
+            if (rnk_e > rnk_b) {
+                report_symbol(c,RS_L_().select(c,rnk_b+1),RS_L_().select(c,rnk_e));
+            }
+        }
+    }
+}
+
 template <move_r_support support, typename sym_t, typename pos_t>
 bool move_r<support,sym_t,pos_t>::query_context::prepend(sym_t sym) {
     pos_t b_tmp = b;
@@ -94,7 +257,27 @@ bool move_r<support,sym_t,pos_t>::query_context::prepend(sym_t sym) {
     pos_t hat_e_ap_z_tmp = hat_e_ap_z;
     int64_t z_tmp = z;
 
+    // number of occurrences of P in the input that are preceded by a symbol smaller than sym
+    pos_t num_smaller = 0;
+
+    if (idx->bidirectional) {
+        num_smaller = idx->template count_smaller<false>(idx->map_symbol(sym),b,e,b_,e_);
+    }
+
     if (idx->backward_search_step(sym,b,e,b_,e_,hat_b_ap_y,y,hat_e_ap_z,z)) {
+        // if the step has been a Case 1 step, the toehold has been reset to a suffix array sample
+        if (y != y_tmp+1) sample_fwd = true;
+
+        if (idx->bidirectional) {
+            /* the suffix array interval of (symP)^rev = P^rev sym in the reversed input is the sub-interval of
+            [b_rev,e_rev] that starts after the num_smaller suffixes P^rev c with c < sym */
+            b_rev += num_smaller;
+            e_rev = b_rev+(e-b);
+            b__rev = bin_search_max_leq<pos_t>(b_rev,b__rev,e__rev,[this](pos_t x){return idx->M_LF_rev().p(x);});
+            e__rev = bin_search_max_leq<pos_t>(e_rev,b__rev,e__rev,[this](pos_t x){return idx->M_LF_rev().p(x);});
+            sample_rev = false;
+        }
+
         l++;
         i = b;
         
@@ -113,12 +296,79 @@ bool move_r<support,sym_t,pos_t>::query_context::prepend(sym_t sym) {
     }
 }
 
+template <move_r_support support, typename sym_t, typename pos_t>
+pos_t move_r<support,sym_t,pos_t>::query_context::prepend_many(const sym_t* P, pos_t len) {
+    pos_t j = len;
+    while (j > 0 && prepend(P[j-1])) j--;
+    return len-j;
+}
+
+template <move_r_support support, typename sym_t, typename pos_t>
+bool move_r<support,sym_t,pos_t>::query_context::append(sym_t sym) {
+    if (!idx->bidirectional) return false;
+
+    pos_t b_rev_tmp = b_rev;
+    pos_t e_rev_tmp = e_rev;
+    pos_t b__rev_tmp = b__rev;
+    pos_t e__rev_tmp = e__rev;
+    pos_t hat_b_ap_y_rev_tmp = hat_b_ap_y_rev;
+    int64_t y_rev_tmp = y_rev;
+    pos_t hat_e_ap_z_rev_tmp = hat_e_ap_z_rev;
+    int64_t z_rev_tmp = z_rev;
+
+    // number of occurrences of P in the input that are followed by a symbol smaller than sym
+    pos_t num_smaller = idx->template count_smaller<true>(idx->map_symbol(sym),b_rev,e_rev,b__rev,e__rev);
+
+    // Psym occurs in the input <=> (Psym)^rev = sym P^rev occurs in the reversed input
+    if (idx->template backward_search_step<true>(sym,b_rev,e_rev,b__rev,e__rev,hat_b_ap_y_rev,y_rev,hat_e_ap_z_rev,z_rev)) {
+        if (y_rev != y_rev_tmp+1) sample_rev = true;
+
+        /* the suffix array interval of Psym is the sub-interval of [b,e] that starts after the
+        num_smaller suffixes Pc with c < sym */
+        b += num_smaller;
+        e = b+(e_rev-b_rev);
+        b_ = bin_search_max_leq<pos_t>(b,b_,e_,[this](pos_t x){return idx->M_LF().p(x);});
+        e_ = bin_search_max_leq<pos_t>(e,b_,e_,[this](pos_t x){return idx->M_LF().p(x);});
+        sample_fwd = false;
+
+        l++;
+        i = b;
+
+        return true;
+    } else {
+        b_rev = b_rev_tmp;
+        e_rev = e_rev_tmp;
+        b__rev = b__rev_tmp;
+        e__rev = e__rev_tmp;
+        hat_b_ap_y_rev = hat_b_ap_y_rev_tmp;
+        y_rev = y_rev_tmp;
+        hat_e_ap_z_rev = hat_e_ap_z_rev_tmp;
+        z_rev = z_rev_tmp;
+
+        return false;
+    }
+}
+
+template <move_r_support support, typename sym_t, typename pos_t>
+void move_r<support,sym_t,pos_t>::query_context::init_sa_b() requires(supports_multiple_locate) {
+    if constexpr (support == _locate_rlzdsa) {
+        s = sample_fwd ? idx->SA_s(hat_b_ap_y)-(y+1) : idx->SA(b);
+    } else {
+        if (sample_fwd) {
+            idx->init_phi_m1(b,e,s,s_,hat_b_ap_y,y);
+        } else {
+            s = idx->SA(b);
+            s_ = bin_search_max_leq<pos_t>(s,0,idx->r__-1,[this](pos_t x){return idx->M_Phi_m1().p(x);});
+        }
+    }
+}
+
 template <move_r_support support, typename sym_t, typename pos_t>
 pos_t move_r<support,sym_t,pos_t>::query_context::next_occ() requires(supports_multiple_locate) {
     if constexpr (support == _locate_rlzdsa) {
         if (i == b) {
             // compute the suffix array value at b
-            s = idx->SA_s(hat_b_ap_y)-(y+1);
+            init_sa_b();
             i++;
             
             // check if there is more than one occurrence
@@ -134,11 +384,11 @@ pos_t move_r<support,sym_t,pos_t>::query_context::next_occ() requires(supports_m
     } else {
         if (i == b) {
             // compute the suffix array value at b
-            idx->init_phi_m1(b,e,s,s_,hat_b_ap_y,y);
+            init_sa_b();
             i++;
             return s;
         } else {
-            idx->M_Phi_m1().move(s,s_);
+            idx->with_m_phi_m1_rows(s_,[&](const auto& m_phi_m1){m_phi_m1.move(s,s_);});
             i++;
             return s;
         }
@@ -147,7 +397,14 @@ pos_t move_r<support,sym_t,pos_t>::query_context::next_occ() requires(supports_m
 
 template <move_r_support support, typename sym_t, typename pos_t>
 pos_t move_r<support,sym_t,pos_t>::query_context::one_occ() const requires(supports_locate) {
-    return idx->SA_s(hat_b_ap_y)-(y+1);
+    if (sample_fwd) {
+        return idx->SA_s(hat_b_ap_y)-(y+1);
+    } else if (sample_rev) {
+        // an occurrence of P^rev at position t in the reversed input is an occurrence of P at position (n-1)-t-l
+        return (idx->n-1)-(idx->SA_s_rev(hat_b_ap_y_rev)-(y_rev+1))-l;
+    } else {
+        return idx->sa_in_interval(b,e,b_);
+    }
 }
 
 template <move_r_support support, typename sym_t, typename pos_t>
@@ -157,7 +414,7 @@ void move_r<support,sym_t,pos_t>::query_context::locate(std::vector<pos_t>& Occ)
     if constexpr (support == _locate_rlzdsa) {
         if (i == b) {
             // compute the suffix array value at b
-            s = idx->SA_s(hat_b_ap_y)-(y+1);
+            init_sa_b();
             Occ.emplace_back(s);
             i++;
             
@@ -174,59 +431,99 @@ void move_r<support,sym_t,pos_t>::query_context::locate(std::vector<pos_t>& Occ)
     } else {
         // compute the suffix array value at b
         if (i == b) {
-            idx->init_phi_m1(b,e,s,s_,hat_b_ap_y,y);
+            init_sa_b();
             Occ.emplace_back(s);
             i++;
         }
         
         // compute the remaining occurrences SA(b,e]
-        while (i <= e) {
-            idx->M_Phi_m1().move(s,s_);
-            Occ.emplace_back(s);
-            i++;
-        }
+        idx->with_m_phi_m1_rows(s_,[&](const auto& m_phi_m1){
+            while (i <= e) {
+                m_phi_m1.move(s,s_);
+                Occ.emplace_back(s);
+                i++;
+            }
+        });
+    }
+}
+
+template <move_r_support support, typename sym_t, typename pos_t>
+void move_r<support,sym_t,pos_t>::query_context::locate(std::vector<pos_t>& Occ, pos_t max_occ) requires(supports_multiple_locate) {
+    pos_t num_occ = std::min(max_occ,num_occ_rem());
+    Occ.reserve(Occ.size()+num_occ);
+
+    for (pos_t k=0; k<num_occ; k++) {
+        Occ.emplace_back(next_occ());
     }
 }
 
 template <move_r_support support, typename sym_t, typename pos_t>
+void move_r<support,sym_t,pos_t>::query_context::locate_spread(std::vector<pos_t>& Occ, pos_t k) const requires(supports_multiple_locate) {
+    if (k == 0 || b > e) return;
+
+    // compute SA[b] in a copy of the context, so the occurrences reported by next_occ() and locate() are not affected
+    query_context query = *this;
+    query.s_ = 0;
+    query.init_sa_b();
+    idx->locate_spread(b,e,k,query.s,query.s_,Occ);
+}
+
+template <move_r_support support, typename sym_t, typename pos_t>
+template <bool rev>
 bool move_r<support,sym_t,pos_t>::backward_search_step(
     sym_t sym,
     pos_t& b, pos_t& e,
     pos_t& b_, pos_t& e_,
     pos_t& hat_b_ap_y, int64_t& y,
     pos_t& hat_e_ap_z, int64_t& z
+) const {
+    if (!backward_search_find_runs<rev>(sym,b,e,b_,e_,hat_b_ap_y,y,hat_e_ap_z,z)) {
+        return false;
+    }
+
+    backward_search_lf<rev>(b,e,b_,e_);
+    return true;
+}
+
+template <move_r_support support, typename sym_t, typename pos_t>
+template <bool rev>
+bool move_r<support,sym_t,pos_t>::backward_search_find_runs(
+    sym_t sym,
+    pos_t& b, pos_t& e,
+    pos_t& b_, pos_t& e_,
+    pos_t& hat_b_ap_y, int64_t& y,
+    pos_t& hat_e_ap_z, int64_t& z
 ) const {
     // If the characters have been remapped internally, the pattern also has to be remapped.
     i_sym_t i_sym = map_symbol(sym);
 
-    // If sym does not occur in L', then P[i..m] does not occur in T
+    /* If sym does not occur in L', then P[i..m] does not occur in T; symbols that do not occur in the input
+    can be mapped to 0, which is the terminator in L', so they have to be rejected explicitly */
     if constexpr (byte_alphabet) {
-        if (!RS_L_().contains(i_sym)) return false;
+        if (i_sym == 0 || !RS_L__dir<rev>().contains(i_sym)) return false;
     } else {
         if (i_sym == 0) return false;
     }
 
     // Find the lexicographically smallest suffix in the current suffix array interval that is prefixed by P[i]
-    if (i_sym != L_(b_)) {
+    if (i_sym != M_LF_dir<rev>().L_(b_)) {
         /* To do so, we can at first find the first (sub-)run with character P[i] after the b_-th (sub-)run, save
         its index in b_ and set b to its start position M_LF.p(b_). */
 
         if constexpr (byte_alphabet) {
-            pos_t max_b_ = std::min<pos_t>(b_+max_scan_l_,e_);
-
-            while (b_ < max_b_ && i_sym != L_(b_)) {
-                b_++;
-            }
+            b_ = M_LF_dir<rev>().find_l_(i_sym,b_,std::min<pos_t>(b_+max_scan_l_,e_));
         }
 
-        if (int_alphabet || (i_sym != L_(b_) && b_ < e_)) {
-            b_ = RS_L_().rank(i_sym,b_);
-            if (b_ == RS_L_().frequency(i_sym)) return false;
-            b_ = RS_L_().select(i_sym,b_+1);
+        /* if the scan has not found P[i] (possibly because it has reached e_, which it does not check), use
+        rank-select queries; if b_ = e_, they detect that P[i] does not occur in L'[b_,e_] */
+        if (int_alphabet || i_sym != M_LF_dir<rev>().L_(b_)) {
+            b_ = RS_L__dir<rev>().rank(i_sym,b_);
+            if (b_ == RS_L__dir<rev>().frequency(i_sym)) return false;
+            b_ = RS_L__dir<rev>().select(i_sym,b_+1);
             if (b_ > e_) return false;
         }
         
-        b = M_LF().p(b_);
+        b = M_LF_dir<rev>().p(b_);
         
         // update y (Case 1).
         y = 0;
@@ -237,23 +534,19 @@ bool move_r<support,sym_t,pos_t>::backward_search_step(
     }
 
     // Find the lexicographically largest suffix in the current suffix array interval that is prefixed by P[i]
-    if (i_sym != L_(e_)) {
+    if (i_sym != M_LF_dir<rev>().L_(e_)) {
         /* To do so, we can at first find the (sub-)last run with character P[i] before the e_-th (sub-)run, save
         its index in e_ and set e to its end position M_LF.p(e_+1)-1. */
 
         if constexpr (byte_alphabet) {
-            pos_t min_e_ = std::max<pos_t>(e_ <= max_scan_l_ ? 0 : e_-max_scan_l_,b_);
-
-            while (e_ > min_e_ && i_sym != L_(e_)) {
-                e_--;
-            }
+            e_ = M_LF_dir<rev>().rfind_l_(i_sym,std::max<pos_t>(e_ <= max_scan_l_ ? 0 : e_-max_scan_l_,b_),e_);
         }
 
-        if (int_alphabet || (i_sym != L_(e_) && e_ > b_)) {
-            e_ = RS_L_().select(i_sym,RS_L_().rank(i_sym,e_));
+        if (int_alphabet || (i_sym != M_LF_dir<rev>().L_(e_) && e_ > b_)) {
+            e_ = RS_L__dir<rev>().select(i_sym,RS_L__dir<rev>().rank(i_sym,e_));
         }
         
-        e = M_LF().p(e_+1)-1;
+        e = M_LF_dir<rev>().p(e_+1)-1;
         
         // update z (Case 1).
         z = 0;
@@ -272,15 +565,22 @@ bool move_r<support,sym_t,pos_t>::backward_search_step(
     b <= e holds. */
 
     // If the suffix array interval is empty, P does not occur in T, so return false.
-    if (b > e) return false;
-    
-    /* Else, set b <- LF(b) and e <- LF(e). The following two optimizations increase query throughput slightly
+    return b <= e;
+}
+
+template <move_r_support support, typename sym_t, typename pos_t>
+template <bool rev>
+void move_r<support,sym_t,pos_t>::backward_search_lf(
+    pos_t& b, pos_t& e,
+    pos_t& b_, pos_t& e_
+) const {
+    /* Set b <- LF(b) and e <- LF(e). The following two optimizations increase query throughput slightly
         if there are only few occurrences */
     if (b_ == e_) {
         if (b == e) {
             /* If \hat{b'}_i == \hat{e'}_i and b'_i = e'_i, then computing
             (e_i,\hat{e}_i) <- M_LF.move(e'_i,\hat{e'}_i) is redundant */
-            M_LF().move(b,b_);
+            M_LF_dir<rev>().move(b,b_);
             e = b;
             e_ = b_;
         } else {
@@ -288,20 +588,74 @@ bool move_r<support,sym_t,pos_t>::backward_search_step(
             \hat{b'}_i < \hat{e'}_i, hence we can compute \hat{e'}_i by setting e_ <- \hat{b'}_i = b_ and
             incrementing e_ until e < M_LF.p[e_+1] holds; This takes O(a) time because of the a-balancedness property */
             pos_t diff_eb = e - b;
-            M_LF().move(b,b_);
+            M_LF_dir<rev>().move(b,b_);
             e = b + diff_eb;
             e_ = b_;
             
-            while (e >= M_LF().p(e_+1)) {
+            while (e >= M_LF_dir<rev>().p(e_+1)) {
                 e_++;
             }
         }
     } else {
-        M_LF().move(b,b_);
-        M_LF().move(e,e_);
+        M_LF_dir<rev>().move(b,b_);
+        M_LF_dir<rev>().move(e,e_);
     }
+}
 
-    return true;
+template <move_r_support support, typename sym_t, typename pos_t>
+template <bool rev>
+pos_t move_r<support,sym_t,pos_t>::count_smaller(i_sym_t sym, pos_t b, pos_t e, pos_t b_, pos_t e_) const {
+    pos_t cnt = 0;
+
+    if (e_-b_ <= max_scan_l_ || e_-b_ <= sym) {
+        // scan the input intervals of M_LF overlapping [b,e]
+        for (pos_t x=b_; x<=e_; x++) {
+            if (M_LF_dir<rev>().L_(x) < sym) {
+                cnt += std::min<pos_t>(e,M_LF_dir<rev>().p(x+1)-1)-std::max<pos_t>(b,M_LF_dir<rev>().p(x))+1;
+            }
+        }
+    } else {
+        /* for each symbol c < sym, find the first and last input intervals x_b and x_e in [b_,e_] with L'[x] = c; since
+        LF is monotonic for a fixed symbol, the number of positions in L[b,e] with c is LF(e_c)-LF(b_c)+1, where b_c
+        and e_c are the first and last positions in [b,e] that lie in x_b and x_e, respectively */
+        for (i_sym_t c=0; c<sym; c++) {
+            if (!RS_L__dir<rev>().contains(c)) continue;
+            pos_t k = RS_L__dir<rev>().rank(c,b_);
+            if (k == RS_L__dir<rev>().frequency(c)) continue;
+            pos_t x_b = RS_L__dir<rev>().select(c,k+1);
+            if (x_b > e_) continue;
+            pos_t x_e = RS_L__dir<rev>().select(c,RS_L__dir<rev>().rank(c,e_+1));
+
+            cnt += (M_LF_dir<rev>().q(x_e)+(std::min<pos_t>(e,M_LF_dir<rev>().p(x_e+1)-1)-M_LF_dir<rev>().p(x_e)))-
+                   (M_LF_dir<rev>().q(x_b)+(std::max<pos_t>(b,M_LF_dir<rev>().p(x_b))-M_LF_dir<rev>().p(x_b)))+1;
+        }
+    }
+
+    return cnt;
+}
+
+template <move_r_support support, typename sym_t, typename pos_t>
+pos_t move_r<support,sym_t,pos_t>::sa_in_interval(pos_t b, pos_t e, pos_t b_) const requires(supports_locate) {
+    // number of LF-steps applied to [b,e], SA[i] = SA[LF^steps(i)]+steps holds for each i in the original interval
+    pos_t steps = 0;
+
+    while (true) {
+        // check the input intervals of M_LF starting in [b,e] for a suffix array sample
+        for (pos_t x = M_LF().p(b_) == b ? b_ : b_+1; x < r_ && M_LF().p(x) <= e; x++) {
+            if constexpr (uses_m_phi_m1) {
+                if (SA_Phi_m1(x) != r__) return SA_s(x)+steps;
+            } else {
+                if (SA_s(x) != n) return SA_s(x)+steps;
+            }
+        }
+
+        /* [b,e] lies in one bwt run (that does not contain the terminator), so LF([b,e]) is again an interval
+        and the suffixes do not wrap around */
+        pos_t diff_eb = e-b;
+        M_LF().move(b,b_);
+        e = b+diff_eb;
+        steps++;
+    }
 }
 
 template <move_r_support support, typename sym_t, typename pos_t>
@@ -309,7 +663,7 @@ void move_r<support,sym_t,pos_t>::init_phi_m1 (
     pos_t& b, pos_t& e,
     pos_t& s, pos_t& s_,
     pos_t& hat_b_ap_y, int64_t& y
-) const requires(support == _locate_move) {
+) const requires(uses_m_phi_m1) {
     setup_phi_m1_move_pair(hat_b_ap_y,s,s_);
     s -= y+1;
 
@@ -321,6 +675,22 @@ void move_r<support,sym_t,pos_t>::init_phi_m1 (
     }
 }
 
+template <move_r_support support, typename sym_t, typename pos_t>
+void move_r<support,sym_t,pos_t>::init_phi (
+    pos_t& b, pos_t& e,
+    pos_t& s, pos_t& s_,
+    pos_t& hat_e_ap_z, int64_t& z
+) const requires(uses_m_phi) {
+    setup_phi_move_pair(hat_e_ap_z,s,s_);
+    s -= z+1;
+
+    // If there is more than one occurrence and s < M_Phi.p[s_], now an input interval of M_Phi before 
+    // the s_-th one contains s, so we have to decrease s_ (see init_phi_m1()).
+    if (b < e && s < M_Phi().p(s_)) {
+        s_ = exp_search_max_leq<pos_t,LEFT>(s,0,s_,[this](pos_t x){return M_Phi().p(x);});
+    }
+}
+
 template <move_r_support support, typename sym_t, typename pos_t>
 void move_r<support,sym_t,pos_t>::init_rlzdsa(
     pos_t& i,
@@ -520,6 +890,95 @@ pos_t move_r<support,sym_t,pos_t>::count(const inp_t& P) const {
     return e-b+1;
 }
 
+template <move_r_support support, typename sym_t, typename pos_t>
+template <typename report_t>
+void move_r<support,sym_t,pos_t>::backward_search_batch(std::span<const inp_t> P, report_t&& report) const {
+    // states of the backward searches that are currently in flight
+    std::array<backward_search_state,batch_width> S;
+    // number of backward searches that are currently in flight
+    uint16_t num_active = 0;
+    // index of the next pattern to start a backward search for
+    pos_t j_next = 0;
+
+    // starts the backward search for the next pattern in st; returns false, if there are no patterns left
+    auto start_next = [&](backward_search_state& st){
+        while (j_next < P.size()) {
+            init_backward_search(st.b,st.e,st.b_,st.e_,st.hat_b_ap_y,st.y,st.hat_e_ap_z,st.z);
+            st.j = j_next++;
+            st.i = (int64_t)P[st.j].size()-1;
+            st.stage = 0;
+
+            // the empty pattern occurs everywhere, so there is nothing to search for
+            if (st.i >= 0) return true;
+            report(st);
+        }
+
+        return false;
+    };
+
+    while (num_active < batch_width && start_next(S[num_active])) {
+        num_active++;
+    }
+
+    while (num_active > 0) {
+        for (uint16_t k=0; k<num_active;) {
+            backward_search_state& st = S[k];
+            bool done = false;
+
+            if (st.stage == 0) {
+                if (backward_search_find_runs(P[st.j][st.i],st.b,st.e,st.b_,st.e_,st.hat_b_ap_y,st.y,st.hat_e_ap_z,st.z)) {
+                    // the next stage reads the b_-th and e_-th pair
+                    M_LF().prefetch(st.b_);
+                    M_LF().prefetch(st.e_);
+                    st.stage = 1;
+                } else {
+                    // make sure the reported interval is empty
+                    st.b = 1;
+                    st.e = 0;
+                    done = true;
+                }
+            } else if (st.stage == 1) {
+                // the move queries in the next stage continue at the output intervals of b_ and e_
+                M_LF().prefetch(M_LF().idx(st.b_));
+                M_LF().prefetch(M_LF().idx(st.e_));
+                st.stage = 2;
+            } else {
+                backward_search_lf(st.b,st.e,st.b_,st.e_);
+
+                if (st.i == 0) {
+                    done = true;
+                } else {
+                    // the next stage reads L'[b_] and L'[e_]
+                    M_LF().prefetch(st.b_);
+                    M_LF().prefetch(st.e_);
+                    st.i--;
+                    st.stage = 0;
+                }
+            }
+
+            if (done) {
+                report(st);
+
+                // replace the finished search with a new one or with the last search in flight
+                if (!start_next(st)) {
+                    num_active--;
+                    st = S[num_active];
+                    continue;
+                }
+            }
+
+            k++;
+        }
+    }
+}
+
+template <move_r_support support, typename sym_t, typename pos_t>
+void move_r<support,sym_t,pos_t>::count_batch(std::span<const inp_t> P, std::span<pos_t> Occ) const {
+    backward_search_batch(P,[&Occ](const backward_search_state& st){
+        Occ[st.j] = st.e >= st.b ? st.e-st.b+1 : 0;
+    });
+}
+
 template <move_r_support support, typename sym_t, typename pos_t>
 void move_r<support,sym_t,pos_t>::locate(const inp_t& P, std::vector<pos_t>& Occ) const requires(supports_multiple_locate) {
     pos_t b,e,b_,e_,hat_b_ap_y,hat_e_ap_z;
@@ -546,94 +1005,1627 @@ void move_r<support,sym_t,pos_t>::locate(const inp_t& P, std::vector<pos_t>& Occ
             init_rlzdsa(i,x_p,x_lp,x_cp,x_r,s_np);
             locate_rlzdsa_right(i,e,s,x_p,x_lp,x_cp,x_r,s_np,Occ);
         }
+    } else if constexpr (uses_m_phi) {
+        uint64_t occ_offs = Occ.size();
+        no_init_resize(Occ,occ_offs+(e-b+1));
+        // Occ_b[i-b] = SA[i]
+        pos_t* Occ_b = &Occ[occ_offs];
+        decode_occ_bi(b,e,hat_b_ap_y,y,hat_e_ap_z,z,[Occ_b,b](pos_t i, pos_t s){Occ_b[i-b] = s;});
     } else {
         pos_t s,s_;
         init_phi_m1(b,e,s,s_,hat_b_ap_y,y);
         Occ.emplace_back(s);
 
         if (b < e) {
-            pos_t i = b+1;
-            
-            while (i <= e) {
-                M_Phi_m1().move(s,s_);
-                Occ.emplace_back(s);
-                i++;
-            }
+            with_m_phi_m1_rows(s_,[&](const auto& m_phi_m1){
+                pos_t i = b+1;
+
+                while (i <= e) {
+                    m_phi_m1.move(s,s_);
+                    Occ.emplace_back(s);
+                    i++;
+                }
+            });
         }
     }
 }
 
 template <move_r_support support, typename sym_t, typename pos_t>
-void move_r<support,sym_t,pos_t>::revert(const std::function<void(pos_t,sym_t)>& report, retrieve_params params) const {
-    adjust_retrieve_params(params,n-2);
-
-    pos_t l = params.l;
-    pos_t r = params.r;
+void move_r<support,sym_t,pos_t>::locate(const inp_t& P, std::vector<pos_t>& Occ, uint16_t num_threads) const requires(supports_multiple_locate) {
+    pos_t b,e,b_,e_,hat_b_ap_y,hat_e_ap_z;
+    int64_t y,z;
 
-    // leftmost section to revert
-    uint16_t s_l;
-    // rightmost section to revert
-    uint16_t s_r;
+    init_backward_search(b,e,b_,e_,hat_b_ap_y,y,hat_e_ap_z,z);
 
-    if (p_r == 1) {
-        s_l = 0;
-        s_r = 0;
-    } else {
-        s_l = bin_search_min_gt<pos_t>(l,0,p_r-1,[this](pos_t x){return _D_e[x].second;});
-        s_r = bin_search_min_geq<pos_t>(r,0,p_r-1,[this](pos_t x){return _D_e[x].second;});
+    for (int64_t i=P.size()-1; i>=0; i--) {
+        if (!backward_search_step(P[i],b,e,b_,e_,hat_b_ap_y,y,hat_e_ap_z,z)) {
+            return;
+        }
     }
 
-    uint16_t p = std::max(
-        (uint16_t)1,                         // use at least one thread
-        std::min({
-            (uint16_t)(s_r-s_l+1),           // use at most s_r-s_l+1 threads
-            (uint16_t)omp_get_max_threads(), // use at most all threads
-            params.num_threads               // use at most the specified number of threads
+    pos_t num_occ = e-b+1;
+
+    uint16_t p = std::max<uint64_t>(
+        1,                                   // use at least one thread
+        std::min<uint64_t>({
+            (uint64_t)omp_get_max_threads(), // use at most all threads
+            num_threads,                     // use at most the specified number of threads
+            num_occ/min_occ_par_locate       // decode at least min_occ_par_locate occurrences per thread
         })
     );
 
+    uint64_t occ_offs = Occ.size();
+    no_init_resize(Occ,occ_offs+num_occ);
+    // Occ_b[i-b] = SA[i]
+    pos_t* Occ_b = &Occ[occ_offs];
+
     #pragma omp parallel num_threads(p)
     {
         // Index in [0..p-1] of the current thread.
         uint16_t i_p = omp_get_thread_num();
+        // number of threads in the team (may be smaller than p, e.g., if this is called from a parallel region)
+        uint16_t p_team = omp_get_num_threads();
+
+        // iteration range start position
+        pos_t b_ip = b+i_p*(num_occ/p_team);
+        // iteration range end position
+        pos_t e_ip = i_p == p_team-1 ? e : b+(i_p+1)*(num_occ/p_team)-1;
+
+        if (i_p == 0) {
+            // SA[b] can be computed from the backward search variables, so the first thread needs no run sample
+            if constexpr (support == _locate_rlzdsa) {
+                pos_t s = SA_s(hat_b_ap_y)-(y+1);
+                Occ_b[0] = s;
+
+                if (b < e_ip) {
+                    pos_t i = b+1;
+                    pos_t x_p,x_lp,x_cp,x_r,s_np;
+
+                    init_rlzdsa(i,x_p,x_lp,x_cp,x_r,s_np);
+
+                    while (i <= e_ip) {
+                        next_rlzdsa(i,s,x_p,x_lp,x_cp,x_r,s_np);
+                        Occ_b[i-1-b] = s;
+                    }
+                }
+            } else {
+                pos_t s,s_;
+                init_phi_m1(b,e,s,s_,hat_b_ap_y,y);
+                Occ_b[0] = s;
+
+                with_m_phi_m1_rows(s_,[&](const auto& m_phi_m1){
+                    for (pos_t i=b+1; i<=e_ip; i++) {
+                        m_phi_m1.move(s,s_);
+                        Occ_b[i-b] = s;
+                    }
+                });
+            }
+        } else if constexpr (uses_m_phi) {
+            if (i_p == p_team-1) {
+                // SA[e] can be computed from the backward search variables, so the last thread decodes from right to left
+                pos_t s,s_;
+                init_phi(b,e,s,s_,hat_e_ap_z,z);
+                Occ_b[e-b] = s;
+
+                for (pos_t i=e; i>b_ip; i--) {
+                    M_Phi().move(s,s_);
+                    Occ_b[i-1-b] = s;
+                }
+            } else {
+                decode_sa(b_ip,e_ip,[Occ_b,b](pos_t i, pos_t s){Occ_b[i-b] = s;});
+            }
+        } else {
+            // start decoding at the nearest run sample or suffix array sample before b_ip
+            decode_sa(b_ip,e_ip,[Occ_b,b](pos_t i, pos_t s){Occ_b[i-b] = s;});
+        }
+    }
+}
 
-        // leftmost section for thread i_p to revert
-        uint16_t sl_ip = s_l+(i_p*(s_r-s_l+1))/p;
-        // rightmost section for thread i_p to revert
-        uint16_t sr_ip = i_p == p-1 ? s_r : s_l+((i_p+1)*(s_r-s_l+1))/p-1;
-
-        // Iteration range start position of thread i_p.
-        pos_t j_l = std::max(l,sl_ip == 0 ? 0 : (_D_e[sl_ip-1].second+1)%n);
-        // Iteration range end position of thread i_p.
-        pos_t j_r = sr_ip == p_r-1 ? n-2 : _D_e[sr_ip].second;
+template <move_r_support support, typename sym_t, typename pos_t>
+template <typename report_t>
+void move_r<support,sym_t,pos_t>::decode_occ(
+    pos_t b, pos_t e, pos_t hat_b_ap_y, int64_t y, report_t&& report
+) const requires(supports_multiple_locate) {
+    if constexpr (support == _locate_rlzdsa) {
+        pos_t s = SA_s(hat_b_ap_y)-(y+1);
+        report(s);
 
-        // index of the input interval in M_LF containing i.
-        pos_t x = sr_ip == p_r-1 ? 0 : _D_e[sr_ip].first;
-        // The position in the bwt of the current character in T.
-        pos_t i = sr_ip == p_r-1 ? 0 : M_LF().p(x);
+        if (b < e) {
+            pos_t i = b+1;
+            pos_t x_p,x_lp,x_cp,x_r,s_np;
 
-        // start iterating at the right iteration range end position
-        pos_t j = j_r;
+            init_rlzdsa(i,x_p,x_lp,x_cp,x_r,s_np);
 
-        // iterate until j = r
-        while (j > r) {
-            // Set i <- LF(i) and j <- j-1.
+            while (i <= e) {
+                next_rlzdsa(i,s,x_p,x_lp,x_cp,x_r,s_np);
+                report(s);
+            }
+        }
+    } else {
+        pos_t s,s_;
+        init_phi_m1(b,e,s,s_,hat_b_ap_y,y);
+        report(s);
+
+        with_m_phi_m1_rows(s_,[&](const auto& m_phi_m1){
+            for (pos_t i=b+1; i<=e; i++) {
+                m_phi_m1.move(s,s_);
+                report(s);
+            }
+        });
+    }
+}
+
+template <move_r_support support, typename sym_t, typename pos_t>
+template <typename report_t>
+void move_r<support,sym_t,pos_t>::decode_occ_bi(
+    pos_t b, pos_t e, pos_t hat_b_ap_y, int64_t y, pos_t hat_e_ap_z, int64_t z, report_t&& report
+) const requires(uses_m_phi) {
+    // s_l = SA[i_l], where s_l lies in the s_l_-th input interval of M_Phi^{-1}
+    pos_t i_l = b;
+    pos_t s_l,s_l_;
+    init_phi_m1(b,e,s_l,s_l_,hat_b_ap_y,y);
+    report(i_l,s_l);
+    if (b == e) return;
+
+    // s_r = SA[i_r], where s_r lies in the s_r_-th input interval of M_Phi
+    pos_t i_r = e;
+    pos_t s_r,s_r_;
+    init_phi(b,e,s_r,s_r_,hat_e_ap_z,z);
+    report(i_r,s_r);
+
+    with_m_phi_m1_rows(s_l_,[&](const auto& m_phi_m1){
+        // decode from both ends, while there are at least two undecoded positions left in (i_l,i_r)
+        while (i_r-i_l > 2) {
+            m_phi_m1.move(s_l,s_l_);
+            M_Phi().move(s_r,s_r_);
+            report(++i_l,s_l);
+            report(--i_r,s_r);
+        }
+
+        if (i_r-i_l == 2) {
+            m_phi_m1.move(s_l,s_l_);
+            report(++i_l,s_l);
+        }
+    });
+}
+
+template <move_r_support support, typename sym_t, typename pos_t>
+void move_r<support,sym_t,pos_t>::locate_spread(
+    pos_t b, pos_t e, pos_t k, pos_t s, pos_t s_, std::vector<pos_t>& Occ
+) const requires(supports_multiple_locate) {
+    uint64_t num_occ = e-b+1;
+    k = std::min<uint64_t>(k,num_occ);
+    Occ.reserve(Occ.size()+k);
+
+    // report SA[b]
+    Occ.emplace_back(s);
+
+    // current position in the suffix array (s = SA[i])
+    pos_t i = b;
+    // variables for decoding the rlzdsa
+    pos_t x_p,x_lp,x_cp,x_r,s_np;
+    // true <=> the rlzdsa context is prepared to decode SA[i+1]
+    bool rlzdsa_initialized = false;
+
+    for (uint64_t t=1; t<k; t++) {
+        // position in the suffix array of the t-th occurrence to report
+        pos_t i_t = b+(t*num_occ)/k;
+
+        // index of the input interval in M_LF containing i_t
+        pos_t x = bin_search_max_leq<pos_t>(i_t,0,r_-1,[this](pos_t x_){return M_LF().p(x_);});
+
+        // decrement x until the starting position of the x-th input interval of M_LF is a starting position of a bwt run
+        if constexpr (support == _locate_rlzdsa) {
+            while (SA_s(x) == n) x--;
+        } else {
+            while (SA_Phi_m1(x) == r__) x--;
+        }
+
+        if (M_LF().p(x) > i) {
+            // the run sample before i_t is closer than SA[i], so start decoding there
+            if constexpr (support == _locate_rlzdsa) {
+                i = i_t;
+                init_rlzdsa(i,s,x_p,x_lp,x_cp,x_r,s_np);
+                next_rlzdsa(i,s,x_p,x_lp,x_cp,x_r,s_np);
+                i--;
+                rlzdsa_initialized = true;
+            } else {
+                i = M_LF().p(x);
+                setup_phi_m1_move_pair(x,s,s_);
+            }
+        }
+
+        // decode up to SA[i_t]
+        if constexpr (support == _locate_rlzdsa) {
+            if (i < i_t) {
+                i++;
+                
+                if (!rlzdsa_initialized) {
+                    init_rlzdsa(i,x_p,x_lp,x_cp,x_r,s_np);
+                    rlzdsa_initialized = true;
+                }
+
+                while (i <= i_t) {
+                    next_rlzdsa(i,s,x_p,x_lp,x_cp,x_r,s_np);
+                }
+
+                i--;
+            }
+        } else {
+            with_m_phi_m1_rows(s_,[&](const auto& m_phi_m1){
+                while (i < i_t) {
+                    m_phi_m1.move(s,s_);
+                    i++;
+                }
+            });
+        }
+
+        Occ.emplace_back(s);
+    }
+}
+
+template <move_r_support support, typename sym_t, typename pos_t>
+void move_r<support,sym_t,pos_t>::locate(const inp_t& P, std::vector<pos_t>& Occ, locate_params params) const requires(supports_multiple_locate) {
+    pos_t b,e,b_,e_,hat_b_ap_y,hat_e_ap_z;
+    int64_t y,z;
+
+    if (params.max_occ == 0) return;
+    init_backward_search(b,e,b_,e_,hat_b_ap_y,y,hat_e_ap_z,z);
+
+    for (int64_t i=P.size()-1; i>=0; i--) {
+        if (!backward_search_step(P[i],b,e,b_,e_,hat_b_ap_y,y,hat_e_ap_z,z)) {
+            return;
+        }
+    }
+
+    if (params.spread && params.max_occ < e-b+1) {
+        pos_t s,s_ = 0;
+
+        if constexpr (support == _locate_rlzdsa) {
+            s = SA_s(hat_b_ap_y)-(y+1);
+        } else {
+            init_phi_m1(b,e,s,s_,hat_b_ap_y,y);
+        }
+
+        locate_spread(b,e,params.max_occ,s,s_,Occ);
+    } else if (uses_m_phi && params.max_occ >= e-b+1) {
+        if constexpr (uses_m_phi) {
+            uint64_t occ_offs = Occ.size();
+            no_init_resize(Occ,occ_offs+(e-b+1));
+            // Occ_b[i-b] = SA[i]
+            pos_t* Occ_b = &Occ[occ_offs];
+            decode_occ_bi(b,e,hat_b_ap_y,y,hat_e_ap_z,z,[Occ_b,b](pos_t i, pos_t s){Occ_b[i-b] = s;});
+        }
+    } else {
+        e = std::min<uint64_t>(e,uint64_t{b}+params.max_occ-1);
+        Occ.reserve(Occ.size()+(e-b+1));
+        decode_occ(b,e,hat_b_ap_y,y,[&Occ](pos_t s){Occ.emplace_back(s);});
+    }
+}
+
+template <move_r_support support, typename sym_t, typename pos_t>
+void move_r<support,sym_t,pos_t>::locate_sorted(
+    pos_t b, pos_t e, pos_t hat_b_ap_y, int64_t y, pos_t* Occ
+) const requires(supports_multiple_locate) {
+    pos_t num_occ = e-b+1;
+
+    if (num_occ < min_occ_radix_sort) {
+        // for few occurrences, clearing and scanning the histograms is more expensive than a comparison sort
+        pos_t* occ = Occ;
+        decode_occ(b,e,hat_b_ap_y,y,[&occ](pos_t s){*occ++ = s;});
+        std::sort(Occ,Occ+num_occ);
+        return;
+    }
+
+    constexpr uint64_t radix = uint64_t{1} << radix_bits_locate_sorted;
+    constexpr pos_t mask = radix-1;
+
+    // number of digits of the largest possible occurrence n-2
+    uint8_t num_digits = (std::bit_width<uint64_t>(n)+radix_bits_locate_sorted-1)/radix_bits_locate_sorted;
+
+    // hist[d*radix+v] = number of occurrences, whiches d-th digit is v
+    std::vector<pos_t> hist(num_digits*radix,0);
+
+    // buffer to decode the occurrences into
+    std::vector<pos_t> buf;
+    no_init_resize(buf,num_occ);
+    pos_t* occ = buf.data();
+
+    // decode the occurrences and count their digits in the same pass
+    decode_occ(b,e,hat_b_ap_y,y,[&occ,&hist,num_digits](pos_t s){
+        *occ++ = s;
+
+        for (uint8_t d=0; d<num_digits; d++) {
+            hist[d*radix+((s >> (d*radix_bits_locate_sorted)) & mask)]++;
+        }
+    });
+
+    pos_t* src = buf.data();
+    pos_t* dst = Occ;
+
+    // sort the occurrences stably by each digit, from the least to the most significant one
+    for (uint8_t d=0; d<num_digits; d++) {
+        uint8_t shift = d*radix_bits_locate_sorted;
+        pos_t* hist_d = &hist[d*radix];
+
+        // if all occurrences have the same d-th digit, the pass would not change their order
+        if (hist_d[(src[0] >> shift) & mask] == num_occ) continue;
+
+        // compute the starting position in dst of each bucket
+        pos_t sum = 0;
+
+        for (uint64_t v=0; v<radix; v++) {
+            pos_t cnt = hist_d[v];
+            hist_d[v] = sum;
+            sum += cnt;
+        }
+
+        for (pos_t k=0; k<num_occ; k++) {
+            pos_t s = src[k];
+            dst[hist_d[(s >> shift) & mask]++] = s;
+        }
+
+        std::swap(src,dst);
+    }
+
+    if (src != Occ) {
+        std::copy(src,src+num_occ,Occ);
+    }
+}
+
+template <move_r_support support, typename sym_t, typename pos_t>
+void move_r<support,sym_t,pos_t>::locate_sorted(const inp_t& P, std::vector<pos_t>& Occ) const requires(supports_multiple_locate) {
+    pos_t b,e,b_,e_,hat_b_ap_y,hat_e_ap_z;
+    int64_t y,z;
+
+    init_backward_search(b,e,b_,e_,hat_b_ap_y,y,hat_e_ap_z,z);
+
+    for (int64_t i=P.size()-1; i>=0; i--) {
+        if (!backward_search_step(P[i],b,e,b_,e_,hat_b_ap_y,y,hat_e_ap_z,z)) {
+            return;
+        }
+    }
+
+    uint64_t occ_offs = Occ.size();
+    no_init_resize(Occ,occ_offs+(e-b+1));
+    locate_sorted(b,e,hat_b_ap_y,y,&Occ[occ_offs]);
+}
+
+template <move_r_support support, typename sym_t, typename pos_t>
+pos_t move_r<support,sym_t,pos_t>::locate_sorted(const inp_t& P, std::span<pos_t> Occ) const requires(supports_multiple_locate) {
+    pos_t b,e,b_,e_,hat_b_ap_y,hat_e_ap_z;
+    int64_t y,z;
+
+    init_backward_search(b,e,b_,e_,hat_b_ap_y,y,hat_e_ap_z,z);
+
+    for (int64_t i=P.size()-1; i>=0; i--) {
+        if (!backward_search_step(P[i],b,e,b_,e_,hat_b_ap_y,y,hat_e_ap_z,z)) {
+            return 0;
+        }
+    }
+
+    pos_t num_occ = e-b+1;
+    if (Occ.size() >= num_occ) locate_sorted(b,e,hat_b_ap_y,y,Occ.data());
+    return num_occ;
+}
+
+template <move_r_support support, typename sym_t, typename pos_t>
+template <typename report_t>
+void move_r<support,sym_t,pos_t>::count_occ_per_document(
+    pos_t b, pos_t e, pos_t hat_b_ap_y, int64_t y, report_t&& report
+) const requires(supports_multiple_locate) {
+    pos_t num_occ = e-b+1;
+    pos_t num_docs = num_documents();
+
+    if (num_docs == 1) {
+        report(0,num_occ);
+        return;
+    }
+
+    if (num_docs <= uint64_t{num_occ}*max_docs_per_occ_dense) {
+        // cnt[d] = number of occurrences in document d
+        std::vector<pos_t> cnt(num_docs,0);
+        decode_occ(b,e,hat_b_ap_y,y,[this,&cnt](pos_t s){cnt[_DS.rank_1(s+1)-1]++;});
+
+        for (pos_t d=0; d<num_docs; d++) {
+            if (cnt[d] != 0) report(d,cnt[d]);
+        }
+    } else {
+        // documents of the occurrences
+        std::vector<pos_t> docs;
+        no_init_resize(docs,num_occ);
+        pos_t* doc = docs.data();
+        decode_occ(b,e,hat_b_ap_y,y,[this,&doc](pos_t s){*doc++ = _DS.rank_1(s+1)-1;});
+        std::sort(docs.begin(),docs.end());
+
+        // report the runs of equal documents
+        pos_t k = 0;
+
+        while (k < num_occ) {
+            pos_t k_ = k+1;
+            while (k_ < num_occ && docs[k_] == docs[k]) k_++;
+            report(docs[k],k_-k);
+            k = k_;
+        }
+    }
+}
+
+template <move_r_support support, typename sym_t, typename pos_t>
+template <typename report_t>
+void move_r<support,sym_t,pos_t>::list_documents_ilcp(
+    pos_t b, pos_t e, pos_t hat_b_ap_y, int64_t y, pos_t m, report_t&& report
+) const requires(supports_multiple_locate) {
+    // number of runs of ILCP
+    pos_t rho = _ILCP_R.num_ones();
+    // the runs of ILCP containing b and e
+    pos_t t_b = _ILCP_R.rank_1(b+1)-1;
+    pos_t t_e = _ILCP_R.rank_1(e+1)-1;
+
+    // ranges [t_l,t_r] of runs of ILCP, in which the runs with values < m have not yet been found
+    std::vector<std::pair<pos_t,pos_t>> ranges = {{t_b,t_e}};
+
+    while (!ranges.empty()) {
+        auto [t_l,t_r] = ranges.back();
+        ranges.pop_back();
+
+        // a run with the minimum value in [t_l,t_r]; if it is >= m, there are no more documents in [t_l,t_r]
+        pos_t t = _ILCP_RMQ(t_l,t_r);
+        if (_ILCP_V.template get<0,pos_t>(t) >= m) continue;
+
+        if (t > t_l) ranges.emplace_back(t_l,t-1);
+        if (t < t_r) ranges.emplace_back(t+1,t_r);
+
+        // every position in [u,v] = [b,e] intersected with the t-th run is the leftmost one of its document in [b,e]
+        pos_t u = std::max(b,_ILCP_R.select_1(t+1));
+        pos_t v = t+1 == rho ? e : std::min<pos_t>(e,_ILCP_R.select_1(t+2)-1);
+
+        if constexpr (support == _locate_rlzdsa) {
+            decode_sa(u,v,[this,&report](pos_t, pos_t s){report(document(s));});
+        } else {
+            // index of the input interval in M_Phi^{-1} containing s
+            pos_t s_;
+            // the current suffix (s = SA[u])
+            pos_t s;
+
+            if (u == b) {
+                // start at the toehold SA[b]
+                pos_t b_ = b;
+                pos_t e_ = e;
+                init_phi_m1(b_,e_,s,s_,hat_b_ap_y,y);
+            } else {
+                // start at the sample SA[u] of the t-th run
+                s = _ILCP_SA.template get<0,pos_t>(t);
+                s_ = bin_search_max_leq<pos_t>(s,0,r__-1,[this](pos_t x){return M_Phi_m1().p(x);});
+            }
+
+            with_m_phi_m1_rows(s_,[&](const auto& m_phi_m1){
+                report(document(s));
+
+                for (pos_t i=u; i<v; i++) {
+                    m_phi_m1.move(s,s_);
+                    report(document(s));
+                }
+            });
+        }
+    }
+}
+
+template <move_r_support support, typename sym_t, typename pos_t>
+void move_r<support,sym_t,pos_t>::list_documents(const inp_t& P, std::vector<pos_t>& Docs) const requires(supports_multiple_locate) {
+    pos_t b,e,b_,e_,hat_b_ap_y,hat_e_ap_z;
+    int64_t y,z;
+
+    init_backward_search(b,e,b_,e_,hat_b_ap_y,y,hat_e_ap_z,z);
+
+    for (int64_t i=P.size()-1; i>=0; i--) {
+        if (!backward_search_step(P[i],b,e,b_,e_,hat_b_ap_y,y,hat_e_ap_z,z)) {
+            return;
+        }
+    }
+
+    uint64_t size_before = Docs.size();
+
+    if (num_documents() == 1) {
+        Docs.emplace_back(0);
+    } else if (has_ilcp()) {
+        list_documents_ilcp(b,e,hat_b_ap_y,y,P.size(),[&Docs](pos_t d){Docs.emplace_back(d);});
+        std::sort(Docs.begin()+size_before,Docs.end());
+    } else {
+        count_occ_per_document(b,e,hat_b_ap_y,y,[&Docs](pos_t d, pos_t){Docs.emplace_back(d);});
+    }
+}
+
+template <move_r_support support, typename sym_t, typename pos_t>
+std::vector<std::pair<pos_t,pos_t>> move_r<support,sym_t,pos_t>::count_per_document(const inp_t& P) const requires(supports_multiple_locate) {
+    std::vector<std::pair<pos_t,pos_t>> Cnt;
+    pos_t b,e,b_,e_,hat_b_ap_y,hat_e_ap_z;
+    int64_t y,z;
+
+    init_backward_search(b,e,b_,e_,hat_b_ap_y,y,hat_e_ap_z,z);
+
+    for (int64_t i=P.size()-1; i>=0; i--) {
+        if (!backward_search_step(P[i],b,e,b_,e_,hat_b_ap_y,y,hat_e_ap_z,z)) {
+            return Cnt;
+        }
+    }
+
+    if (has_ilcp()) {
+        // if P only occurs in one document, all occurrences are in it, so they do not have to be decoded
+        pos_t d_P = 0;
+        pos_t d;
+        list_documents_ilcp(b,e,hat_b_ap_y,y,P.size(),[&d_P,&d](pos_t d_){d_P++; d = d_;});
+
+        if (d_P == 1) {
+            Cnt.emplace_back(d,e-b+1);
+            return Cnt;
+        }
+    }
+
+    count_occ_per_document(b,e,hat_b_ap_y,y,[&Cnt](pos_t d, pos_t c){Cnt.emplace_back(d,c);});
+    return Cnt;
+}
+
+template <move_r_support support, typename sym_t, typename pos_t>
+std::vector<std::pair<pos_t,pos_t>> move_r<support,sym_t,pos_t>::top_k_documents(const inp_t& P, pos_t k) const requires(supports_multiple_locate) {
+    std::vector<std::pair<pos_t,pos_t>> Cnt = count_per_document(P);
+
+    auto more_occ = [](const std::pair<pos_t,pos_t>& p1, const std::pair<pos_t,pos_t>& p2){
+        return p1.second > p2.second || (p1.second == p2.second && p1.first < p2.first);
+    };
+
+    if (k < Cnt.size()) {
+        std::partial_sort(Cnt.begin(),Cnt.begin()+k,Cnt.end(),more_occ);
+        Cnt.resize(k);
+    } else {
+        std::sort(Cnt.begin(),Cnt.end(),more_occ);
+    }
+
+    return Cnt;
+}
+
+template <move_r_support support, typename sym_t, typename pos_t>
+void move_r<support,sym_t,pos_t>::locate_batch(
+    std::span<const inp_t> P,
+    std::vector<pos_t>& Occ, std::vector<uint64_t>& Occ_offs
+) const requires(supports_multiple_locate) {
+    // [0..|P|-1] final states of the backward searches
+    std::vector<backward_search_state> S_bs(P.size());
+
+    backward_search_batch(P,[&S_bs](const backward_search_state& st){
+        S_bs[st.j] = st;
+    });
+
+    // compute the offsets of the patterns' occurrences in Occ
+    no_init_resize(Occ_offs,P.size()+1);
+    Occ_offs[0] = Occ.size();
+
+    for (pos_t j=0; j<P.size(); j++) {
+        Occ_offs[j+1] = Occ_offs[j]+(S_bs[j].e >= S_bs[j].b ? S_bs[j].e-S_bs[j].b+1 : 0);
+    }
+
+    no_init_resize(Occ,Occ_offs[P.size()]);
+
+    // stores the variables needed to decode the occurrences of one pattern
+    struct decoder {
+        uint64_t o; // next position in Occ to write to
+        pos_t i; // current position in the suffix array interval
+        pos_t e; // right interval limit of the suffix array interval
+        pos_t s; // current suffix s = SA[i]
+        pos_t s_; // row index (see with_m_phi_m1_rows(f)) of the input inteval of M_Phi^{-1} containing s
+        pos_t x_p,x_lp,x_cp,x_r,s_np; // variables for decoding the rlzdsa
+    };
+
+    // decoders that are currently in flight
+    std::array<decoder,batch_width> D;
+    // number of decoders that are currently in flight
+    uint16_t num_active = 0;
+    // index of the next pattern to decode the occurrences of
+    pos_t j_next = 0;
+
+    /* decodes the occurrences of all patterns using the rows m_phi_m1 of M_Phi^{-1}; to_row translates an index of
+    an input interval in M_Phi^{-1} to a row index in m_phi_m1 (see with_m_phi_m1_rows(f)) */
+    auto decode = [&](const auto& m_phi_m1, auto&& to_row){
+        /* sets up d to decode the occurrences of the next pattern with at least two occurrences (patterns
+        with only one occurrence are reported directly); returns false, if there are no patterns left */
+        auto start_next = [&](decoder& d){
+            while (j_next < P.size()) {
+                backward_search_state& st = S_bs[j_next];
+                d.o = Occ_offs[j_next];
+                j_next++;
+
+                if (st.b > st.e) continue;
+
+                d.i = st.b;
+                d.e = st.e;
+
+                // compute SA[b]
+                if constexpr (support == _locate_rlzdsa) {
+                    d.s = SA_s(st.hat_b_ap_y)-(st.y+1);
+                } else {
+                    init_phi_m1(st.b,st.e,d.s,d.s_,st.hat_b_ap_y,st.y);
+                    d.s_ = to_row(d.s_);
+                }
+
+                Occ[d.o++] = d.s;
+
+                if (st.b < st.e) {
+                    if constexpr (support == _locate_rlzdsa) {
+                        d.i++;
+                        init_rlzdsa(d.i,d.x_p,d.x_lp,d.x_cp,d.x_r,d.s_np);
+                    } else {
+                        // the next move query starts at the output interval of s_
+                        m_phi_m1.prefetch(m_phi_m1.idx(d.s_));
+                    }
+
+                    return true;
+                }
+            }
+
+            return false;
+        };
+
+        while (num_active < batch_width && start_next(D[num_active])) {
+            num_active++;
+        }
+
+        while (num_active > 0) {
+            for (uint16_t k=0; k<num_active;) {
+                decoder& d = D[k];
+                bool done;
+
+                if constexpr (support == _locate_rlzdsa) {
+                    // decode SA[i] and set i <- i+1
+                    next_rlzdsa(d.i,d.s,d.x_p,d.x_lp,d.x_cp,d.x_r,d.s_np);
+                    Occ[d.o++] = d.s;
+                    done = d.i > d.e;
+                } else {
+                    // set s <- SA[i+1] and i <- i+1
+                    m_phi_m1.move(d.s,d.s_);
+                    Occ[d.o++] = d.s;
+                    d.i++;
+                    done = d.i == d.e;
+
+                    if (!done) {
+                        m_phi_m1.prefetch(m_phi_m1.idx(d.s_));
+                    }
+                }
+
+                // replace the finished decoder with a new one or with the last decoder in flight
+                if (done && !start_next(d)) {
+                    num_active--;
+                    d = D[num_active];
+                    continue;
+                }
+
+                k++;
+            }
+        }
+    };
+
+    if constexpr (support == _locate_rlzdsa) {
+        // the rlzdsa does not use M_Phi^{-1}
+        decode(nullptr,nullptr);
+    } else {
+        with_m_phi_m1_rows(decode);
+    }
+}
+
+template <move_r_support support, typename sym_t, typename pos_t>
+template <bool report_pos>
+void move_r<support,sym_t,pos_t>::matching_statistics(
+    const inp_t& P, pos_t* MS_len, pos_t* MS_pos
+) const requires(supports_multiple_locate) {
+    pos_t m = P.size();
+
+    // if report_pos = false, the positions are only needed to compute the lengths
+    std::vector<pos_t> MS_pos_tmp;
+    if constexpr (!report_pos) {
+        no_init_resize(MS_pos_tmp,m);
+        MS_pos = MS_pos_tmp.data();
+    }
+
+    // current position in the bwt, initially 0 with SA[0] = n-1, which shares no prefix with any pattern
+    pos_t i = 0;
+    // index of the input interval in M_LF containing i
+    pos_t x = 0;
+    // SA[i]
+    pos_t s = n-1;
+
+    /* first pass: for j = |P|-1,...,0, T[SA[i]..] shares the longest prefix with P[j+1..] among all suffixes of the
+    input; if L[i] = P[j], then SA[LF(i)] = SA[i]-1 is the position of a longest prefix of P[j..] in the input; else,
+    this holds for the end position e of the previous or the start position s' of the next run with symbol P[j] in the
+    bwt, whichever suffix shares the longer prefix with T[SA[i]..], i.e., for e, iff i is smaller than the threshold of
+    the run starting at s' (MS_pos[j] = n <=> P[j] does not occur in the input) */
+    for (pos_t j=m; j>0;) {
+        j--;
+        i_sym_t sym = map_symbol(P[j]);
+
+        // symbols that do not occur in the input are mapped to 0, which is the terminator in L'
+        if (sym == 0 || !_RS_L_.contains(sym)) {
+            MS_pos[j] = n;
+            continue;
+        }
+
+        if (sym != L_(x)) {
+            // number of input intervals with symbol P[j] before x
+            pos_t k = _RS_L_.rank(sym,x);
+            // the first input interval with symbol P[j] after x (or r', if there is none)
+            pos_t x_d = k < _RS_L_.frequency(sym) ? _RS_L_.select(sym,k+1) : r_;
+
+            if (x_d != r_ && (k == 0 || i >= THR(x_d))) {
+                // restart at the start of the next run with symbol P[j]
+                x = x_d;
+                i = _M_LF.p(x);
+                s = SA_s(x);
+            } else {
+                // restart at the end of the previous run with symbol P[j]
+                x = _RS_L_.select(sym,k);
+                i = _M_LF.p(x+1)-1;
+                s = SA_run_end(x);
+            }
+        }
+
+        // set i <- LF(i) and s <- SA[LF(i)] = SA[i]-1
+        _M_LF.move(i,x);
+        s--;
+        MS_pos[j] = s;
+    }
+
+    // the section T[T_l..T_r] of the input extracted last (initially none, so T_r+1 = n is never accessed)
+    inp_t T_sec;
+    pos_t T_l = n;
+    pos_t T_r = n-1;
+    // length of the next section to extract; it doubles while the comparisons continue right after the last section
+    pos_t len_sec = 0;
+    // minimum length of an extracted section, such that extracting a section costs at most twice its length
+    pos_t len_sec_min = std::max<pos_t>(64,sr_isa);
+
+    // returns T[t] for t in [0..n-2]
+    auto T_at = [&](pos_t t){
+        if (t < T_l || t > T_r) {
+            len_sec = t == T_r+1 ? 2*len_sec : len_sec_min;
+            T_l = t;
+            T_r = std::min<uint64_t>(uint64_t{t}+len_sec-1,n-2);
+            T_sec = extract(T_l,T_r);
+        }
+
+        return T_sec[t-T_l];
+    };
+
+    /* second pass: for j = 0,...,|P|-1, P[j..j+l) is the longest prefix of P[j..] that occurs in the input; it
+    occurs at MS_pos[j], and since P[j-1..j-1+MS_len[j-1]) occurs, MS_len[j] >= MS_len[j-1]-1 */
+    pos_t l = 0;
+
+    for (pos_t j=0; j<m; j++) {
+        if (MS_pos[j] == n) {
+            l = 0;
+        } else if (l > 1 && MS_pos[j] == MS_pos[j-1]+1) {
+            // the longest match at MS_pos[j-1] ends at the same position in the input as the one at MS_pos[j]
+            l--;
+        } else {
+            // T[MS_pos[j]] = P[j] (see the first pass), so at least max(1,l-1) symbols match
+            l = std::max<pos_t>(l,2)-1;
+            while (j+l < m && MS_pos[j]+l < n-1 && T_at(MS_pos[j]+l) == P[j+l]) l++;
+        }
+
+        MS_len[j] = l;
+
+        if constexpr (report_pos) {
+            // MS_pos[j] is only read again, if l > 1
+            if (l == 0) MS_pos[j] = 0;
+        }
+    }
+}
+
+template <move_r_support support, typename sym_t, typename pos_t>
+void move_r<support,sym_t,pos_t>::matching_statistics(
+    std::span<const inp_t> P, std::vector<std::vector<pos_t>>& MS_len,
+    uint16_t num_threads
+) const requires(supports_multiple_locate) {
+    check_thresholds();
+    MS_len.resize(P.size());
+
+    #pragma omp parallel for schedule(dynamic,16) num_threads(num_threads)
+    for (uint64_t j=0; j<P.size(); j++) {
+        no_init_resize(MS_len[j],P[j].size());
+        matching_statistics<false>(P[j],MS_len[j].data(),NULL);
+    }
+}
+
+template <move_r_support support, typename sym_t, typename pos_t>
+std::vector<std::tuple<pos_t,pos_t,pos_t>> move_r<support,sym_t,pos_t>::maximal_exact_matches(
+    const inp_t& P, pos_t min_len
+) const requires(supports_multiple_locate) {
+    std::vector<std::tuple<pos_t,pos_t,pos_t>> MEMs;
+    check_thresholds();
+
+    std::vector<pos_t> MS_len,MS_pos;
+    no_init_resize(MS_len,P.size());
+    no_init_resize(MS_pos,P.size());
+    matching_statistics<true>(P,MS_len.data(),MS_pos.data());
+
+    /* P[i..i+MS_len[i]) is right-maximal by definition; it is left-maximal, iff P[i-1..i+MS_len[i]) does
+    not occur, i.e., iff i = 0 or MS_len[i-1] <= MS_len[i] */
+    for (pos_t i=0; i<P.size(); i++) {
+        if (MS_len[i] >= std::max<pos_t>(min_len,1) && (i == 0 || MS_len[i-1] <= MS_len[i])) {
+            MEMs.emplace_back(std::make_tuple(i,MS_len[i],MS_pos[i]));
+        }
+    }
+
+    return MEMs;
+}
+
+template <move_r_support support, typename sym_t, typename pos_t>
+void move_r<support,sym_t,pos_t>::maximal_exact_matches(
+    std::span<const inp_t> P, pos_t min_len,
+    std::vector<std::vector<std::tuple<pos_t,pos_t,pos_t>>>& MEMs,
+    uint16_t num_threads
+) const requires(supports_multiple_locate) {
+    check_thresholds();
+    MEMs.resize(P.size());
+
+    #pragma omp parallel for schedule(dynamic,16) num_threads(num_threads)
+    for (uint64_t j=0; j<P.size(); j++) {
+        MEMs[j] = maximal_exact_matches(P[j],min_len);
+    }
+}
+
+template <move_r_support support, typename sym_t, typename pos_t>
+template <typename sa_t, typename t_t>
+void move_r<support,sym_t,pos_t>::thresholds_of_runs(
+    const sa_t& SA, t_t&& T,
+    std::vector<pos_t>& THR_r, std::vector<pos_t>& SA_e_r
+) const requires(supports_multiple_locate) {
+    std::vector<pos_t> PLCP = plcp_array(SA,T);
+
+    // returns L[i] = T[SA[i]-1] (the terminator is 0)
+    auto L = [&](pos_t i){return SA[i] == 0 ? uint64_t{0} : uint64_t{T(SA[i]-1)};};
+
+    // run_end[c] = the end position of the last bwt run with symbol c before the current run, or n if there is none
+    std::vector<pos_t> run_end;
+    /* stack of the pairs <i',LCP[i']> with i' <= i and LCP[i'] < LCP[i''] for all i' < i'' <= i, i.e., the
+    minimum of LCP[i_0..i] is the LCP value of the first pair on the stack with i' >= i_0 */
+    std::vector<std::pair<pos_t,pos_t>> LCP_min;
+    // symbol of the current bwt run
+    uint64_t c_cur = 0;
+
+    THR_r.clear();
+    SA_e_r.clear();
+
+    for (pos_t i=0; i<n; i++) {
+        pos_t lcp = i == 0 ? 0 : PLCP[SA[i]];
+        while (!LCP_min.empty() && LCP_min.back().second >= lcp) LCP_min.pop_back();
+        LCP_min.emplace_back(i,lcp);
+
+        uint64_t c = L(i);
+        if (i != 0 && c == c_cur) continue;
+
+        // i is the starting position of a bwt run, so i-1 is the end position of the previous one
+        if (i != 0) {
+            run_end[c_cur] = i-1;
+            SA_e_r.emplace_back(SA[i-1]);
+        }
+
+        if (c >= run_end.size()) run_end.resize(c+1,n);
+
+        if (run_end[c] == n) {
+            THR_r.emplace_back(0);
+        } else {
+            // the threshold is the position of the minimum in LCP[run_end[c]+1..i]
+            THR_r.emplace_back(std::lower_bound(LCP_min.begin(),LCP_min.end(),run_end[c]+1,
+                [](const std::pair<pos_t,pos_t>& p, pos_t i_){return p.first < i_;}
+            )->first);
+        }
+
+        c_cur = c;
+    }
+
+    SA_e_r.emplace_back(SA[n-1]);
+}
+
+template <move_r_support support, typename sym_t, typename pos_t>
+void move_r<support,sym_t,pos_t>::build_thresholds(
+    const std::vector<pos_t>& THR_r, const std::vector<pos_t>& SA_e_r
+) requires(supports_multiple_locate) {
+    uint8_t width = std::ceil(std::log2(n+1)/(double)8);
+
+    if constexpr (uses_m_phi) {
+        // SA[M_LF.p[x+1]-1] = SA_e[x]
+        _THR = interleaved_vectors<pos_t,pos_t>({width});
+    } else {
+        _THR = interleaved_vectors<pos_t,pos_t>({width,width});
+    }
+
+    _THR.resize_no_init(r_);
+
+    // indices of the next bwt run, whose start and end position have not yet been reached
+    pos_t k_s = 0;
+    pos_t k_e = 0;
+
+    // the input intervals of M_LF that have been created by the balancing algorithm continue the previous bwt run
+    for (pos_t x=0; x<r_; x++) {
+        _THR.template set<0,pos_t>(x,x == 0 || L_(x) != L_(x-1) ? THR_r[k_s++] : 0);
+
+        if constexpr (!uses_m_phi) {
+            _THR.template set<1,pos_t>(x,x == r_-1 || L_(x+1) != L_(x) ? SA_e_r[k_e++] : 0);
+        }
+    }
+}
+
+template <move_r_support support, typename sym_t, typename pos_t>
+void move_r<support,sym_t,pos_t>::build_thresholds(uint16_t num_threads, bool log) requires(supports_multiple_locate) {
+    std::chrono::steady_clock::time_point time;
+
+    if (log) {
+        time = now();
+        std::cout << "building the thresholds" << std::flush;
+    }
+
+    // decode the suffix array and the input with the index
+    std::vector<pos_t> SA_dec;
+    no_init_resize(SA_dec,n);
+    SA([&SA_dec](pos_t i, pos_t s){SA_dec[i] = s;},{.num_threads = num_threads});
+    inp_t T_dec = revert({.num_threads = num_threads});
+
+    std::vector<pos_t> THR_r,SA_e_r;
+    thresholds_of_runs(SA_dec,[this,&T_dec](pos_t j){return map_symbol(T_dec[j]);},THR_r,SA_e_r);
+    build_thresholds(THR_r,SA_e_r);
+
+    if (log) log_runtime(time);
+}
+
+template <move_r_support support, typename sym_t, typename pos_t>
+std::vector<typename move_r<support,sym_t,pos_t>::approx_match> move_r<support,sym_t,pos_t>::approximate_matches(
+    const inp_t& P, approx_params params
+) const {
+    uint16_t p = std::max<uint16_t>(1,std::min<uint16_t>(omp_get_max_threads(),params.num_threads));
+    pos_t m = P.size();
+
+    approx_search search;
+    search.P = &P;
+    search.params = params;
+    search.matches.resize(p);
+    search.D.resize(m+1,0);
+
+    if (bidirectional) {
+        /* extend P[j..i-1] to the right until it does not occur in the input; then, P[0..i-1] contains one more
+        disjoint substring that does not occur in the input, each of which contains at least one error */
+        auto query_lb = query();
+
+        for (pos_t i=0; i<m; i++) {
+            if (query_lb.append(P[i])) {
+                search.D[i+1] = search.D[i];
+            } else {
+                search.D[i+1] = search.D[i]+1;
+                query_lb.reset();
+            }
+        }
+    }
+
+    if (p == 1) {
+        approximate_matches(&search,query(),m,0,max_task_depth_approx);
+    } else {
+        #pragma omp parallel num_threads(p)
+        {
+            #pragma omp single
+            {
+                approximate_matches(&search,query(),m,0,0);
+            }
+        }
+    }
+
+    std::vector<approx_match> matches;
+
+    for (uint16_t i_p=0; i_p<p; i_p++) {
+        matches.insert(matches.end(),search.matches[i_p].begin(),search.matches[i_p].end());
+    }
+
+    /* the same substring can be matched by different alignments (only with edits), so keep only the one with the
+    fewest errors, which is the first one among the equal substrings after sorting */
+    std::sort(matches.begin(),matches.end());
+    matches.erase(std::unique(matches.begin(),matches.end(),[](const approx_match& m1, const approx_match& m2){
+        return m1.b == m2.b && m1.e == m2.e && m1.length == m2.length;
+    }),matches.end());
+
+    return matches;
+}
+
+template <move_r_support support, typename sym_t, typename pos_t>
+void move_r<support,sym_t,pos_t>::approximate_matches(
+    approx_search* search, query_context query, pos_t i, pos_t errors, uint8_t depth
+) const {
+    const inp_t& P = *search->P;
+    pos_t k = search->params.k;
+
+    if (errors+search->D[i] > k) return;
+
+    if (errors == k) {
+        // no errors are left, so the rest of the pattern has to be matched exactly
+        while (i > 0) {
+            if (!query.prepend(P[i-1])) return;
+            i--;
+        }
+    }
+
+    if (i == 0) {
+        if (query.length() > 0) {
+            auto [b,e] = query.sa_interval();
+            /* with one thread, the search does not open a parallel region, so omp_get_thread_num() may be the thread
+            number in an enclosing parallel region (e.g. if approximate_matches() is called for many patterns at once) */
+            uint16_t i_p = search->matches.size() == 1 ? 0 : omp_get_thread_num();
+            search->matches[i_p].emplace_back(approx_match{b,e,query.length(),errors});
+        }
+
+        return;
+    }
+
+    // explores a child branch, in a separate task if it is near the root of the search tree
+    auto explore = [this,search,depth](query_context query_c, pos_t i_c, pos_t errors_c){
+        if (depth < max_task_depth_approx) {
+            /* the task may run after this frame (and the closure) is gone, so it must not access the captures of
+            the closure; copy them into locals that are passed to the task by value instead (search points to the
+            approx_search of the top-level call, which only returns after all tasks have finished) */
+            const move_r* index = this;
+            approx_search* search_c = search;
+            uint8_t depth_c = depth+1;
+
+            #pragma omp task firstprivate(index,search_c,query_c,i_c,errors_c,depth_c)
+            {
+                index->approximate_matches(search_c,query_c,i_c,errors_c,depth_c);
+            }
+        } else {
+            approximate_matches(search,query_c,i_c,errors_c,depth+1);
+        }
+    };
+
+    // the symbols that precede the current match
+    std::vector<sym_t> symbols;
+    interval_symbols(query.b,query.e,query.b_,query.e_,[this,&symbols](i_sym_t c, pos_t, pos_t, pos_t, pos_t){
+        symbols.emplace_back(unmap_symbol(c));
+    });
+
+    for (sym_t c : symbols) {
+        query_context query_c = query;
+        if (!query_c.prepend(c)) continue;
+
+        // match (or substitute) P[i-1] with c
+        explore(query_c,i-1,errors+(c != P[i-1]));
+
+        // insert c before P[i..|P|-1]
+        if (search->params.edits && query.length() > 0) explore(query_c,i,errors+1);
+    }
+
+    // delete P[i-1]
+    if (search->params.edits) explore(query,i-1,errors+1);
+}
+
+template <move_r_support support, typename sym_t, typename pos_t>
+void move_r<support,sym_t,pos_t>::revert(const std::function<void(pos_t,sym_t)>& report, retrieve_params params) const {
+    adjust_retrieve_params(params,n-2);
+
+    pos_t l = params.l;
+    pos_t r = params.r;
+
+    /* if the text position samples have been built, split [l,r] into equally long parts and extract each of them
+    starting at the nearest sample to its right, which allows using any number of threads */
+    if (sr_isa != 0) {
+        uint16_t p = std::max(
+            (uint16_t)1,                                                 // use at least one thread
+            (uint16_t)std::min<uint64_t>({
+                (uint64_t{r}-l)/sr_isa+1,                                // use at most one thread per sample
+                (uint64_t)omp_get_max_threads(),                         // use at most all threads
+                params.num_threads                                       // use at most the specified number of threads
+            })
+        );
+
+        #pragma omp parallel for schedule(static,1) num_threads(p)
+        for (uint16_t i_p=0; i_p<p; i_p++) {
+            extract(
+                l+((uint64_t{r}-l+1)*i_p)/p,
+                l+((uint64_t{r}-l+1)*(i_p+1))/p-1,
+                report
+            );
+        }
+
+        return;
+    }
+
+    // leftmost section to revert
+    uint16_t s_l;
+    // rightmost section to revert
+    uint16_t s_r;
+
+    if (p_r == 1) {
+        s_l = 0;
+        s_r = 0;
+    } else {
+        s_l = bin_search_min_geq<pos_t>(l,0,p_r-1,[this](pos_t x){return _D_e[x].second;});
+        s_r = bin_search_min_geq<pos_t>(r,0,p_r-1,[this](pos_t x){return _D_e[x].second;});
+    }
+
+    uint16_t p = std::max(
+        (uint16_t)1,                         // use at least one thread
+        std::min({
+            (uint16_t)(s_r-s_l+1),           // use at most s_r-s_l+1 threads
+            (uint16_t)omp_get_max_threads(), // use at most all threads
+            params.num_threads               // use at most the specified number of threads
+        })
+    );
+
+    #pragma omp parallel num_threads(p)
+    {
+        // Index in [0..p-1] of the current thread.
+        uint16_t i_p = omp_get_thread_num();
+
+        // leftmost section for thread i_p to revert
+        uint16_t sl_ip = s_l+(i_p*(s_r-s_l+1))/p;
+        // rightmost section for thread i_p to revert
+        uint16_t sr_ip = i_p == p-1 ? s_r : s_l+((i_p+1)*(s_r-s_l+1))/p-1;
+
+        // Iteration range start position of thread i_p.
+        pos_t j_l = std::max(l,sl_ip == 0 ? 0 : (_D_e[sl_ip-1].second+1)%n);
+        // Iteration range end position of thread i_p.
+        pos_t j_r = sr_ip == p_r-1 ? n-2 : _D_e[sr_ip].second;
+
+        // index of the input interval in M_LF containing i.
+        pos_t x = sr_ip == p_r-1 ? 0 : _D_e[sr_ip].first;
+        // The position in the bwt of the current character in T.
+        pos_t i = sr_ip == p_r-1 ? 0 : M_LF().p(x);
+
+        // start iterating at the right iteration range end position
+        pos_t j = j_r;
+
+        with_m_lf_rows(x,[&](const auto& m_lf){
+            // iterate until j = r
+            while (j > r) {
+                // Set i <- LF(i) and j <- j-1.
+                m_lf.move(i,x);
+                j--;
+            }
+
+            // Report T[r] = T[j] = L[i] = L'[x]
+            report(j,unmap_symbol(m_lf.L_(x)));
+
+            // report T[l,r-1] from right to left
+            while (j > j_l) {
+                // Set i <- LF(i) and j <- j-1.
+                m_lf.move(i,x);
+                j--;
+                // Report T[j] = L[i] = L'[x].
+                report(j,unmap_symbol(m_lf.L_(x)));
+            }
+        });
+    }
+}
+
+template <move_r_support support, typename sym_t, typename pos_t>
+void move_r<support,sym_t,pos_t>::reorder_rows(uint16_t num_threads, bool log) {
+    std::chrono::steady_clock::time_point time;
+
+    if (log) {
+        time = now();
+        std::cout << "reordering the rows of M_LF" << std::flush;
+    }
+
+    // order the rows of M_LF by the first time reverting the input, i.e. starting at (i,x) = (0,0), visits them
+    _M_LF_ro = move_data_structure_reordered<pos_t,i_sym_t>(_M_LF,
+        move_data_structure_reordered<pos_t,i_sym_t>::walk_order(_M_LF,0,0,n),num_threads);
+
+    if (log) time = log_runtime(time);
+
+    if constexpr (uses_m_phi_m1) {
+        if (log) std::cout << "reordering the rows of M_Phi^{-1}" << std::flush;
+
+        // order the rows of M_Phi^{-1} by the first time decoding SA with Phi^{-1}, starting at (s,s_) = (0,0), visits them
+        _M_Phi_m1_ro = move_data_structure_reordered<pos_t>(_M_Phi_m1,
+            move_data_structure_reordered<pos_t>::walk_order(_M_Phi_m1,0,0,n),num_threads);
+
+        if (log) log_runtime(time);
+    }
+}
+
+template <move_r_support support, typename sym_t, typename pos_t>
+void move_r<support,sym_t,pos_t>::build_isa_samples(pos_t sample_rate, uint16_t num_threads, bool log) {
+    std::chrono::steady_clock::time_point time;
+
+    if (log) {
+        time = now();
+        std::cout << "building ISA_s (sample rate: " << sample_rate << ")" << std::flush;
+    }
+
+    sr_isa = std::max<pos_t>(1,sample_rate);
+    _ISA_s = interleaved_vectors<pos_t,pos_t>({
+        (uint8_t)std::ceil(std::log2(n+1)/(double)8),
+        (uint8_t)std::ceil(std::log2(r_+1)/(double)8)
+    });
+    _ISA_s.resize_no_init((n-2)/sr_isa+1);
+
+    uint16_t p = std::max<uint16_t>(1,std::min<uint16_t>({p_r,(uint16_t)omp_get_max_threads(),num_threads}));
+
+    // revert the sections of the input in parallel and sample every sr_isa-th text position
+    #pragma omp parallel for schedule(dynamic,1) num_threads(p)
+    for (uint16_t s=0; s<p_r; s++) {
+        // Iteration range start position of section s.
+        pos_t j_l = s == 0 ? 0 : (_D_e[s-1].second+1)%n;
+        // index of the input interval in M_LF containing i.
+        pos_t x = s == p_r-1 ? 0 : _D_e[s].first;
+        // The position in the bwt of the current character in T.
+        pos_t i = s == p_r-1 ? 0 : M_LF().p(x);
+        // start iterating at the right iteration range end position
+        pos_t j = s == p_r-1 ? n-2 : _D_e[s].second;
+
+        while (true) {
+            // L[i] = T[j], so store <i,x> if j is a sampled position
+            if (j % sr_isa == sr_isa-1 || j == n-2) {
+                _ISA_s.template set<0,pos_t>(j/sr_isa,i);
+                _ISA_s.template set<1,pos_t>(j/sr_isa,x);
+            }
+
+            if (j == j_l) break;
+
+            // Set i <- LF(i) and j <- j-1.
             M_LF().move(i,x);
             j--;
         }
+    }
+
+    if (log) log_runtime(time);
+}
+
+template <move_r_support support, typename sym_t, typename pos_t>
+void move_r<support,sym_t,pos_t>::build_sa_samples(pos_t sample_rate, uint16_t num_threads, bool log) requires(uses_m_phi_m1) {
+    std::chrono::steady_clock::time_point time;
+
+    if (log) {
+        time = now();
+        std::cout << "building SA_sr (sample rate: " << sample_rate << ")" << std::flush;
+    }
+
+    sr_sa = std::max<pos_t>(1,sample_rate);
+    _SA_sr = interleaved_vectors<pos_t,pos_t>({
+        (uint8_t)std::ceil(std::log2(n+1)/(double)8),
+        (uint8_t)std::ceil(std::log2(r__+1)/(double)8)
+    });
+    _SA_sr.resize_no_init((n-1)/sr_sa+1);
+
+    uint16_t p = std::max<uint16_t>(1,std::min<uint16_t>((uint16_t)omp_get_max_threads(),num_threads));
+
+    // decode the bwt runs in parallel and sample SA at every sr_sa-th position
+    #pragma omp parallel for schedule(dynamic,256) num_threads(p)
+    for (pos_t x=0; x<r_; x++) {
+        // skip the input intervals of M_LF that do not start a bwt run
+        if (SA_Phi_m1(x) == r__) continue;
+
+        // position in the suffix array of the current suffix s
+        pos_t j = M_LF().p(x);
+        // end position of the bwt run starting at j
+        pos_t x_e = x+1;
+        while (x_e < r_ && SA_Phi_m1(x_e) == r__) x_e++;
+        pos_t i_e = M_LF().p(x_e)-1;
+        // last sampled position in the bwt run
+        pos_t i_l = i_e-i_e%sr_sa;
+
+        // skip the bwt run, if it does not contain a sampled position
+        if (i_l < j) continue;
+
+        // index of the input interval in M_Phi^{-1} containing s
+        pos_t s_;
+        // the current suffix (s = SA[j])
+        pos_t s;
+
+        setup_phi_m1_move_pair(x,s,s_);
+
+        while (true) {
+            if (j % sr_sa == 0) {
+                _SA_sr.template set<0,pos_t>(j/sr_sa,s);
+                _SA_sr.template set<1,pos_t>(j/sr_sa,s_);
+            }
+
+            if (j == i_l) break;
+
+            // Set s = \Phi(s)
+            M_Phi_m1().move(s,s_);
+            j++;
+        }
+    }
+
+    if (log) log_runtime(time);
+}
+
+template <move_r_support support, typename sym_t, typename pos_t>
+template <typename report_t>
+void move_r<support,sym_t,pos_t>::extract(pos_t l, pos_t r, report_t&& report) const {
+    if (r > n-2) r = n-2;
+    if (l > r) return;
+
+    if (sr_isa == 0) {
+        revert(report,{.l = l, .r = r, .num_threads = 1});
+        return;
+    }
+
+    // index of the sample at the nearest sampled text position j >= r
+    pos_t k = r/sr_isa;
+    // the sampled text position
+    pos_t j = std::min<uint64_t>((uint64_t{k}+1)*sr_isa-1,n-2);
+    // The position in the bwt of the current character in T.
+    pos_t i = _ISA_s.template get<0,pos_t>(k);
+    // index of the input interval in M_LF containing i.
+    pos_t x = _ISA_s.template get<1,pos_t>(k);
+
+    with_m_lf_rows(x,[&](const auto& m_lf){
+        // iterate until j = r
+        while (j > r) {
+            // Set i <- LF(i) and j <- j-1.
+            m_lf.move(i,x);
+            j--;
+        }
 
         // Report T[r] = T[j] = L[i] = L'[x]
-        report(j,unmap_symbol(L_(x)));
+        report(j,unmap_symbol(m_lf.L_(x)));
 
         // report T[l,r-1] from right to left
-        while (j > j_l) {
+        while (j > l) {
             // Set i <- LF(i) and j <- j-1.
-            M_LF().move(i,x);
+            m_lf.move(i,x);
             j--;
             // Report T[j] = L[i] = L'[x].
-            report(j,unmap_symbol(L_(x)));
+            report(j,unmap_symbol(m_lf.L_(x)));
+        }
+    });
+}
+
+template <move_r_support support, typename sym_t, typename pos_t>
+template <typename int_t>
+void move_r<support,sym_t,pos_t>::build_document_starts(const std::vector<int_t>& doc_starts) {
+    bool add_start_0 = doc_starts.empty() || doc_starts.front() != 0;
+    sdsl::sd_vector_builder DS_builder(n-1,doc_starts.size()+add_start_0);
+    if (add_start_0) DS_builder.set(0);
+    for (int_t j : doc_starts) DS_builder.set(j);
+    _DS = sd_array<pos_t>(sdsl::sd_vector<>(DS_builder));
+
+    _ILCP_R = sd_array<pos_t>();
+    _ILCP_V = interleaved_vectors<pos_t,pos_t>();
+    _ILCP_RMQ = sdsl::rmq_succinct_sct<>();
+    _ILCP_SA = interleaved_vectors<pos_t,pos_t>();
+}
+
+template <move_r_support support, typename sym_t, typename pos_t>
+template <typename sa_t, typename t_t>
+std::vector<pos_t> move_r<support,sym_t,pos_t>::plcp_array(const sa_t& SA, t_t&& T) const {
+    // [0..n-1] Phi, which is overwritten with PLCP by Kasai's algorithm
+    std::vector<pos_t> PLCP;
+    no_init_resize(PLCP,n);
+
+    for (uint64_t i=1; i<n; i++) {
+        PLCP[SA[i]] = SA[i-1];
+    }
+
+    // PLCP[j] >= PLCP[j-1]-1, so l only has to be increased by n in total; T[n-1] is unique, so it is not compared
+    pos_t l = 0;
+
+    for (pos_t j=0; j<n-1; j++) {
+        pos_t j_ = PLCP[j];
+        while (j+l < n-1 && j_+l < n-1 && T(j+l) == T(j_+l)) l++;
+        PLCP[j] = l;
+        if (l > 0) l--;
+    }
+
+    PLCP[n-1] = 0;
+    return PLCP;
+}
+
+template <move_r_support support, typename sym_t, typename pos_t>
+template <typename sa_t, typename t_t>
+void move_r<support,sym_t,pos_t>::build_ilcp(const sa_t& SA, t_t&& T, bool log) requires(supports_multiple_locate) {
+    std::chrono::steady_clock::time_point time;
+
+    if (log) {
+        time = now();
+        std::cout << "building ILCP" << std::flush;
+    }
+
+    std::vector<pos_t> PLCP = plcp_array(SA,T);
+
+    // [0..d-1] last[d] = the last position i in the suffix array with SA[i] in document d, or n if there is none yet
+    std::vector<pos_t> last(num_documents(),n);
+    /* stack of the pairs <i',LCP[i']> with i' <= i and LCP[i'] < LCP[i''] for all i' < i'' <= i, i.e., the
+    minimum of LCP[i_0..i] is the LCP value of the first pair on the stack with i' >= i_0 */
+    std::vector<std::pair<pos_t,pos_t>> LCP_min;
+    // starting positions, values and suffix array values at the starting positions of the runs of ILCP
+    std::vector<pos_t> R = {0};
+    std::vector<pos_t> V = {0};
+    std::vector<pos_t> SA_R = {(pos_t)SA[0]};
+
+    // SA[0] = n-1 is not in a document, so ILCP[0] = 0 is its own run
+    for (pos_t i=1; i<n; i++) {
+        pos_t s = SA[i];
+        pos_t lcp = PLCP[s];
+        while (!LCP_min.empty() && LCP_min.back().second >= lcp) LCP_min.pop_back();
+        LCP_min.emplace_back(i,lcp);
+
+        pos_t d = document(s);
+        pos_t ilcp = 0;
+
+        if (last[d] != n) {
+            // ILCP[i] = lcp(T[SA[last[d]]..],T[SA[i]..]) = min(LCP[last[d]+1..i])
+            ilcp = std::lower_bound(LCP_min.begin(),LCP_min.end(),last[d]+1,
+                [](const std::pair<pos_t,pos_t>& p, pos_t i_){return p.first < i_;}
+            )->second;
+        }
+
+        last[d] = i;
+
+        if (ilcp != V.back()) {
+            R.emplace_back(i);
+            V.emplace_back(ilcp);
+            SA_R.emplace_back(s);
+        }
+    }
+
+    PLCP.clear();
+    PLCP.shrink_to_fit();
+    pos_t rho = R.size();
+    pos_t max_ilcp = *std::max_element(V.begin(),V.end());
+
+    sdsl::sd_vector_builder ILCP_R_builder(n,rho);
+    for (pos_t i : R) ILCP_R_builder.set(i);
+    _ILCP_R = sd_array<pos_t>(sdsl::sd_vector<>(ILCP_R_builder));
+
+    _ILCP_V = interleaved_vectors<pos_t,pos_t>({(uint8_t)std::max<double>(1,std::ceil(std::log2(max_ilcp+1)/(double)8))});
+    _ILCP_V.resize_no_init(rho);
+    for (pos_t t=0; t<rho; t++) _ILCP_V.template set<0,pos_t>(t,V[t]);
+    _ILCP_RMQ = sdsl::rmq_succinct_sct<>(&V);
+
+    if constexpr (uses_m_phi_m1) {
+        _ILCP_SA = interleaved_vectors<pos_t,pos_t>({(uint8_t)std::ceil(std::log2(n+1)/(double)8)});
+        _ILCP_SA.resize_no_init(rho);
+        for (pos_t t=0; t<rho; t++) _ILCP_SA.template set<0,pos_t>(t,SA_R[t]);
+    }
+
+    if (log) {
+        log_runtime(time);
+        std::cout << "ILCP has " << rho << " runs" << std::endl;
+    }
+}
+
+template <move_r_support support, typename sym_t, typename pos_t>
+void move_r<support,sym_t,pos_t>::build_document_array(
+    const std::vector<pos_t>& doc_starts, uint16_t num_threads, bool log
+) {
+    build_document_starts(doc_starts);
+
+    if constexpr (supports_multiple_locate) {
+        // decode the suffix array and the input with the index
+        std::vector<pos_t> SA_dec;
+        no_init_resize(SA_dec,n);
+        SA([&SA_dec](pos_t i, pos_t s){SA_dec[i] = s;},{.num_threads = num_threads});
+        inp_t T_dec = revert({.num_threads = num_threads});
+
+        build_ilcp(SA_dec,[&T_dec](pos_t j){return T_dec[j];},log);
+    }
+}
+
+template <move_r_support support, typename sym_t, typename pos_t>
+void move_r<support,sym_t,pos_t>::build_document_array(
+    sym_t separator, uint16_t num_threads, bool log
+) requires(supports_multiple_locate) {
+    std::vector<pos_t> doc_starts = locate_sorted(inp_t(1,separator));
+
+    // the documents start right after the occurrences of the separator, except after the last position of the input
+    if (!doc_starts.empty() && doc_starts.back() == n-2) doc_starts.pop_back();
+    for (pos_t& j : doc_starts) j++;
+
+    build_document_array(doc_starts,num_threads,log);
+}
+
+template <move_r_support support, typename sym_t, typename pos_t>
+void move_r<support,sym_t,pos_t>::kmers(pos_t k, const std::function<void(const inp_t&,pos_t)>& report, kmer_params params) const {
+    if (k == 0 || k > n-1) return;
+    params.min_freq = std::max<pos_t>(1,params.min_freq);
+    uint16_t p = std::max<uint16_t>(1,std::min<uint16_t>(omp_get_max_threads(),params.num_threads));
+
+    // suffix array interval [b,e] of a suffix of a k-mer of length d, where b' and e' are the indices of the input intervals in M_LF containing b and e
+    struct kmer_node {
+        pos_t b,e,b_,e_;
+        inp_t suffix;
+    };
+
+    // the nodes of the current level of the search tree
+    std::vector<kmer_node> level;
+    pos_t d = 0;
+
+    {
+        kmer_node root;
+        pos_t hat_b_ap_y,hat_e_ap_z;
+        int64_t y,z;
+        init_backward_search(root.b,root.e,root.b_,root.e_,hat_b_ap_y,y,hat_e_ap_z,z);
+        level.emplace_back(root);
+    }
+
+    // expand the search tree level by level until there are enough subtrees to search in parallel
+    while (d < k && level.size() < p*min_kmer_tasks_per_thread) {
+        std::vector<kmer_node> next_level;
+
+        for (kmer_node& node : level) {
+            interval_symbols(node.b,node.e,node.b_,node.e_,[&](i_sym_t c, pos_t b_c, pos_t e_c, pos_t b__c, pos_t e__c){
+                if (e_c-b_c+1 < params.min_freq) return;
+                inp_t suffix;
+                no_init_resize(suffix,d+1);
+                suffix[0] = unmap_symbol(c);
+                std::copy(node.suffix.begin(),node.suffix.end(),suffix.begin()+1);
+                next_level.emplace_back(kmer_node{b_c,e_c,b__c,e__c,std::move(suffix)});
+            });
+        }
+
+        level = std::move(next_level);
+        d++;
+    }
+
+    #pragma omp parallel num_threads(p)
+    {
+        inp_t kmer;
+        no_init_resize(kmer,k);
+
+        #pragma omp for schedule(dynamic,1)
+        for (uint64_t i=0; i<level.size(); i++) {
+            std::copy(level[i].suffix.begin(),level[i].suffix.end(),kmer.begin()+(k-d));
+            kmers(k,d,level[i].b,level[i].e,level[i].b_,level[i].e_,kmer,report,params);
+        }
+    }
+}
+
+template <move_r_support support, typename sym_t, typename pos_t>
+void move_r<support,sym_t,pos_t>::kmers(
+    pos_t k, pos_t d, pos_t b, pos_t e, pos_t b_, pos_t e_, inp_t& kmer,
+    const std::function<void(const inp_t&,pos_t)>& report, const kmer_params& params
+) const {
+    if (d == k) {
+        if (e-b+1 <= params.max_freq) report(kmer,e-b+1);
+        return;
+    }
+
+    interval_symbols(b,e,b_,e_,[&](i_sym_t c, pos_t b_c, pos_t e_c, pos_t b__c, pos_t e__c){
+        if (e_c-b_c+1 < params.min_freq) return;
+        kmer[k-d-1] = unmap_symbol(c);
+        kmers(k,d+1,b_c,e_c,b__c,e__c,kmer,report,params);
+    });
+}
+
+template <move_r_support support, typename sym_t, typename pos_t>
+uint64_t move_r<support,sym_t,pos_t>::write_kmers(pos_t k, std::string file_name, kmer_params params) const {
+    std::ofstream out(file_name);
+    uint16_t p = std::max<uint16_t>(1,std::min<uint16_t>(omp_get_max_threads(),params.num_threads));
+    uint64_t record_size = k*sizeof(sym_t)+sizeof(pos_t);
+
+    // [0..p-1] per-thread buffers of records
+    std::vector<std::vector<char>> bufs(p);
+    uint64_t num_kmers = 0;
+
+    kmers(k,[&](const inp_t& kmer, pos_t freq){
+        std::vector<char>& buf = bufs[omp_get_thread_num()];
+        uint64_t pos = buf.size();
+        buf.resize(pos+record_size);
+        std::memcpy(&buf[pos],kmer.data(),k*sizeof(sym_t));
+        std::memcpy(&buf[pos+k*sizeof(sym_t)],&freq,sizeof(pos_t));
+
+        if (buf.size() >= kmer_buf_size) {
+            #pragma omp critical
+            {
+                write_to_file(out,buf.data(),buf.size());
+                num_kmers += buf.size()/record_size;
+            }
+
+            buf.clear();
         }
+    },params);
+
+    for (uint16_t i_p=0; i_p<p; i_p++) {
+        write_to_file(out,bufs[i_p].data(),bufs[i_p].size());
+        num_kmers += bufs[i_p].size()/record_size;
     }
+
+    out.close();
+    return num_kmers;
 }
 
 template <move_r_support support, typename sym_t, typename pos_t>
@@ -692,81 +2684,55 @@ void move_r<support,sym_t,pos_t>::BWT(const std::function<void(pos_t,sym_t)>& re
 }
 
 template <move_r_support support, typename sym_t, typename pos_t>
-void move_r<support,sym_t,pos_t>::SA(const std::function<void(pos_t,pos_t)>& report, retrieve_params params) const requires(supports_multiple_locate) {
-    adjust_retrieve_params(params,n-1);
-
-    pos_t l = params.l;
-    pos_t r = params.r;
-
-    uint16_t p = std::max(
-        (uint16_t)1,                                           // use at least one thread
-        std::min({
-            (uint16_t)omp_get_max_threads(),                   // use at most all threads
-            params.num_threads,                                // use at most the specified number of threads
-            (uint16_t)(((r-l+1)*(double)r__)/(10.0*(double)n)) // use at most (r-l+1)*(r/n)*(1/10) threads
-        })
-    );
-
+template <typename report_t>
+void move_r<support,sym_t,pos_t>::decode_sa(pos_t b, pos_t e, report_t&& report) const requires(supports_multiple_locate) {
     if constexpr (support == _locate_rlzdsa) {
-        #pragma omp parallel num_threads(p)
-        {
-            // Index in [0..p-1] of the current thread.
-            uint16_t i_p = omp_get_thread_num();
-
-            // iteration range start position
-            pos_t b = l+i_p*((r-l+1)/p);
-            // iteration range end position
-            pos_t e = i_p == p-1 ? r : l+(i_p+1)*((r-l+1)/p)-1;
-
-            pos_t x_p,x_lp,x_cp,x_r,s_np;
+        pos_t x_p,x_lp,x_cp,x_r,s_np;
 
-            // current position in the suffix array
-            pos_t i = b;
-            // current suffix array value
-            pos_t s;
+        // current position in the suffix array
+        pos_t i = b;
+        // current suffix array value
+        pos_t s;
 
-            // initialize the rlzdsa context to position i = b
-            init_rlzdsa(i,s,x_p,x_lp,x_cp,x_r,s_np);
+        // initialize the rlzdsa context to position i = b
+        init_rlzdsa(i,s,x_p,x_lp,x_cp,x_r,s_np);
 
-            // decode and report SA[b..e]
-            while (i <= e) {
-                next_rlzdsa(i,s,x_p,x_lp,x_cp,x_r,s_np);
-                report(i-1,s);
-            }
+        // decode and report SA[b..e]
+        while (i <= e) {
+            next_rlzdsa(i,s,x_p,x_lp,x_cp,x_r,s_np);
+            report(i-1,s);
         }
     } else {
-        #pragma omp parallel num_threads(p)
-        {
-            // Index in [0..p-1] of the current thread.
-            uint16_t i_p = omp_get_thread_num();
-
-            // iteration range start position
-            pos_t b = l+i_p*((r-l+1)/p);
-            // iteration range end position
-            pos_t e = i_p == p-1 ? r : l+(i_p+1)*((r-l+1)/p)-1;
-
-            // the input interval of M_LF containing i
-            pos_t x = bin_search_max_leq<pos_t>(b,0,r_-1,[this](pos_t x_){return M_LF().p(x_);});
+        // the input interval of M_LF containing i
+        pos_t x = bin_search_max_leq<pos_t>(b,0,r_-1,[this](pos_t x_){return M_LF().p(x_);});
 
-            // decrement x until the starting position of the x-th input interval of M_LF is a starting position of a bwt run
-            while (SA_Phi_m1(x) == r__) {
-                x--;
-            }
+        // decrement x until the starting position of the x-th input interval of M_LF is a starting position of a bwt run
+        while (SA_Phi_m1(x) == r__) {
+            x--;
+        }
 
-            // current position in the suffix array, initially the starting position of the x-th interval of M_LF
-            pos_t i = M_LF().p(x);
+        // current position in the suffix array, initially the starting position of the x-th interval of M_LF
+        pos_t i = M_LF().p(x);
 
-            // index of the input interval in M_Phi^{-1} containing s
-            pos_t s_;
-            /* the current suffix array value (SA[i]), initially the suffix array sample of the x-th run,
-            initially the suffix array value at b */
-            pos_t s;
+        // index of the input interval in M_Phi^{-1} containing s
+        pos_t s_;
+        /* the current suffix array value (SA[i]), initially the suffix array sample of the x-th run,
+        initially the suffix array value at b */
+        pos_t s;
 
+        // if there is a suffix array sample in SA_sr between the start of the run and b, begin iterating there instead
+        if (sr_sa != 0 && b-b%sr_sa > i) {
+            i = b-b%sr_sa;
+            s = _SA_sr.template get<0,pos_t>(i/sr_sa);
+            s_ = _SA_sr.template get<1,pos_t>(i/sr_sa);
+        } else {
             setup_phi_m1_move_pair(x,s,s_);
+        }
 
+        with_m_phi_m1_rows(s_,[&](const auto& m_phi_m1){
             // iterate up to the iteration range starting position
             while (i < b) {
-                M_Phi_m1().move(s,s_);
+                m_phi_m1.move(s,s_);
                 i++;
             }
 
@@ -775,11 +2741,42 @@ void move_r<support,sym_t,pos_t>::SA(const std::function<void(pos_t,pos_t)>& rep
 
             // report the SA-values SA[b+1,e] from left to right
             while (i < e) {
-                M_Phi_m1().move(s,s_);
+                m_phi_m1.move(s,s_);
                 i++;
                 report(i,s);
             }
-        }
+        });
+    }
+}
+
+template <move_r_support support, typename sym_t, typename pos_t>
+void move_r<support,sym_t,pos_t>::SA(const std::function<void(pos_t,pos_t)>& report, retrieve_params params) const requires(supports_multiple_locate) {
+    adjust_retrieve_params(params,n-1);
+
+    pos_t l = params.l;
+    pos_t r = params.r;
+
+    uint16_t p = std::max(
+        (uint16_t)1,                                           // use at least one thread
+        std::min({
+            (uint16_t)omp_get_max_threads(),                   // use at most all threads
+            params.num_threads,                                // use at most the specified number of threads
+            (uint16_t)(((r-l+1)*(double)r__)/(10.0*(double)n)) // use at most (r-l+1)*(r/n)*(1/10) threads
+        })
+    );
+
+    #pragma omp parallel num_threads(p)
+    {
+        // Index in [0..p-1] of the current thread.
+        uint16_t i_p = omp_get_thread_num();
+
+        // iteration range start position
+        pos_t b = l+i_p*((r-l+1)/p);
+        // iteration range end position
+        pos_t e = i_p == p-1 ? r : l+(i_p+1)*((r-l+1)/p)-1;
+
+        // decode and report SA[b..e]
+        decode_sa(b,e,report);
     }
 }
 
@@ -6,6 +6,7 @@
 #include <cstring>
 
 #include <move_r/misc/utils.hpp>
+#include <move_r/misc/huge_page_allocator.hpp>
 
 /**
  * @brief variable-width interleaved vectors (widths are fixed to whole bytes)
@@ -31,7 +32,7 @@ class interleaved_vectors {
     uint64_t width_entry = 0; // sum of the widths of all vectors
 
     // [0..(capacity_vectors+1)*width_entry-1] vector storing the interleaved vectors
-    std::vector<char> data_vectors;
+    std::vector<char,huge_page_allocator<char>> data_vectors;
 
     // [0..num_vectors-1] or shorter; widths of the stored vectors; widths[i] = width of vector i
     std::array<uint64_t,num_vectors> widths;
@@ -192,6 +193,16 @@ class interleaved_vectors {
         return bases[0];
     }
 
+    /**
+     * @brief returns a pointer to the first entry of the vector with index vec (consecutive
+     *        entries of it are bytes_per_entry() bytes apart)
+     * @param vec vector index
+     * @return pointer to the first entry of the vector with index vec
+     */
+    inline char* data(uint8_t vec) const {
+        return bases[vec];
+    }
+
     /**
      * @brief returns the i-th entry of the vector with index 0
      * @param i entry index (0 <= i < size_vectors)
@@ -209,8 +220,8 @@ class interleaved_vectors {
      */
     void reserve(uint64_t capacity, uint16_t num_threads = 1) {
         if (capacity_vectors < capacity) {
-            std::vector<char> new_data_vectors;
-            no_init_resize(new_data_vectors,capacity*width_entry+16);
+            std::vector<char,huge_page_allocator<char>> new_data_vectors;
+            new_data_vectors.resize(capacity*width_entry+16); // huge_page_allocator does not initialize the bytes
 
             //#pragma omp parallel for num_threads(num_threads)
             for (uint64_t i=0; i<size_vectors*width_entry; i++) {
@@ -410,6 +421,14 @@ class interleaved_vectors {
         return *reinterpret_cast<T*>(bases[vec] + i * width_entry);
     }
 
+    /**
+     * @brief prefetches the cache line containing the i-th entry (of all vectors) into the cache
+     * @param i entry index (0 <= i < size_vectors)
+     */
+    inline void prefetch(pos_t i) const {
+        __builtin_prefetch(bases[0] + i * width_entry);
+    }
+
     /**
      * @brief reinterpret the memory at data as interleaved vectors of size size; do not perform any operations that
      * may change the size or the capacity of the interleaved vectors after using this method
@@ -1,9 +1,11 @@
 #pragma once
 
+#include <bit>
 #include <cmath>
 #include <omp.h>
 #include <move_r/misc/utils.hpp>
 #include <move_r/data_structures/interleaved_vectors.hpp>
+#include <move_r/data_structures/packed_interleaved_vectors.hpp>
 
 struct mds_params {
     uint16_t num_threads = omp_get_max_threads(); // the number of threads to use during the construction
@@ -12,6 +14,56 @@ struct mds_params {
     std::ostream* mf = NULL; // measurement file to write runtime data to
 };
 
+/**
+ * @brief policy for answering move queries
+ */
+enum move_policy {
+    _move_plain, // compares the input interval starting positions one after another to find the interval containing the output value
+    /* prefetches the pair of the input interval containing the start of the output interval as soon as its index is known
+    and compares windows of input interval starting positions without branches to find the interval containing the output value */
+    _move_fast
+};
+
+// move policy that is used if none is specified (can be set at compile time, e.g. with -DMOVE_R_MOVE_POLICY=_move_fast)
+#ifndef MOVE_R_MOVE_POLICY
+#define MOVE_R_MOVE_POLICY _move_plain
+#endif
+
+/* controls, whether with_fixed_widths() passes views with compile-time widths to the query loops, if the widths of a
+move data structure are one of the combinations in mds_fixed_widths (can be disabled at compile time with
+-DMOVE_R_FIXED_WIDTHS=false, e.g. to compare both) */
+#ifndef MOVE_R_FIXED_WIDTHS
+#define MOVE_R_FIXED_WIDTHS true
+#endif
+
+// combinations of the widths (in bytes) of D_p, D_idx and D_offs, for which views with compile-time widths are instantiated
+static constexpr std::array<std::array<uint8_t,3>,10> mds_fixed_widths = {{
+    {3,2,1},{3,2,2},{3,3,1},{3,3,2},{4,3,1},{4,3,2},{4,4,1},{4,4,2},{5,4,2},{5,5,2}
+}};
+
+/* combinations of the widths (in bits) of D_p, D_idx and D_offs, for which views of bit-packed move data structures with
+compile-time widths are instantiated (D_idx is 4, 8 or 12 bits narrower than D_p, because k' is usually much smaller than n) */
+static constexpr std::array<std::array<uint8_t,3>,36> mds_packed_fixed_widths = []{
+    std::array<std::array<uint8_t,3>,36> widths;
+    uint8_t c = 0;
+
+    for (uint8_t w_p=20; w_p<=32; w_p+=4) {
+        for (uint8_t w_idx=w_p-12; w_idx<w_p; w_idx+=4) {
+            for (uint8_t w_offs=8; w_offs<=16; w_offs+=4) {
+                widths[c++] = {w_p,w_idx,w_offs};
+            }
+        }
+    }
+
+    return widths;
+}();
+
+template <typename pos_t, uint8_t w_p, uint8_t w_idx, uint8_t w_offs, uint8_t w_l_, typename l_t>
+class move_data_structure_fixed;
+
+template <typename pos_t, uint8_t w_p, uint8_t w_idx, uint8_t w_offs, uint8_t w_l_, typename l_t>
+class move_data_structure_packed_fixed;
+
 /**
  * @brief move data structure
  * @tparam pos_t unsigned integer type of the interval starting positions
@@ -23,6 +75,12 @@ class move_data_structure {
     protected:
     class construction;
 
+    template <typename, uint8_t, uint8_t, uint8_t, uint8_t, typename>
+    friend class move_data_structure_fixed;
+
+    template <typename, uint8_t, uint8_t, uint8_t, uint8_t, typename>
+    friend class move_data_structure_packed_fixed;
+
     using pair_t = std::pair<pos_t,pos_t>; // pair type
     using pair_arr_t = std::vector<pair_t>; // pair array type
 
@@ -35,6 +93,9 @@ class move_data_structure {
     uint8_t omega_offs = 0; // word width of D_offs
     uint8_t omega_l_ = 0; // word width of L_
     interleaved_vectors<pos_t,pos_t> data; // interleaved vectors storing D_p, D_idx and D_offs (and L', for M_LF)
+
+    // number of input interval starting positions that are compared at once by move queries with the policy _move_fast
+    static constexpr pos_t ff_window = 4;
     
     public:
     move_data_structure() = default;
@@ -158,6 +219,59 @@ class move_data_structure {
         set_offs(k_,0);
     }
 
+    /**
+     * @brief returns D_p, D_idx and D_offs interleaved with the smallest bit-granular widths that can store their
+     *        values (instead of widths rounded up to whole bytes); used by the packed layouts of derived classes; if
+     *        the widths rounded up to multiples of 4 bits are one of the combinations in mds_packed_fixed_widths, these
+     *        are used instead, so that with_fixed_widths() can pass views with compile-time widths to the query loops
+     * @return packed interleaved vectors storing D_p, D_idx and D_offs
+     */
+    packed_interleaved_vectors<pos_t,pos_t,3> pack() const {
+        uint16_t num_threads = omp_get_max_threads();
+        pos_t max_offs = 0;
+
+        #pragma omp parallel for reduction(max:max_offs) num_threads(num_threads)
+        for (uint64_t x=0; x<k_; x++) {
+            max_offs = std::max(max_offs,offs(x));
+        }
+
+        std::array<uint8_t,3> widths = {
+            (uint8_t)std::max<int>(1,std::bit_width(n)),
+            (uint8_t)std::max<int>(1,std::bit_width(k_)),
+            (uint8_t)std::max<int>(1,std::bit_width(max_offs))
+        };
+
+        if constexpr (MOVE_R_FIXED_WIDTHS) {
+            std::array<uint8_t,3> widths_rounded = {
+                (uint8_t)(4*((widths[0]+3)/4)),
+                (uint8_t)(4*((widths[1]+3)/4)),
+                (uint8_t)(4*((widths[2]+3)/4))
+            };
+
+            if (std::find(
+                mds_packed_fixed_widths.begin(),mds_packed_fixed_widths.end(),widths_rounded
+            ) != mds_packed_fixed_widths.end()) {
+                widths = widths_rounded;
+            }
+        }
+
+        packed_interleaved_vectors<pos_t,pos_t,3> data_packed(widths);
+
+        data_packed.resize(uint64_t{k_}+1);
+
+        // blocks of 8 consecutive entries start at byte boundaries, so they can be written in parallel
+        #pragma omp parallel for num_threads(num_threads)
+        for (uint64_t b=0; b<=k_/8; b++) {
+            for (uint64_t x=8*b; x<std::min<uint64_t>(8*b+8,uint64_t{k_}+1); x++) {
+                data_packed.template set<0,pos_t>(x,p(x));
+                data_packed.template set<1,pos_t>(x,idx(x));
+                data_packed.template set<2,pos_t>(x,offs(x));
+            }
+        }
+
+        return data_packed;
+    }
+
     /**
      * @brief sets D_p[x] to p
      * @param x [0..k'-1] interval index
@@ -222,37 +336,191 @@ class move_data_structure {
         return data.template get<2,pos_t>(x);
     }
 
+    /**
+     * @brief prefetches the x-th pair (D_p[x], D_idx[x] and D_offs[x]) into the cache
+     * @param x [0..k_']
+     */
+    inline void prefetch(pos_t x) const {
+        data.prefetch(x);
+    }
+
+    protected:
+    /**
+     * @brief calculates the move query Move(I,i,x) = (i',x') on the move data structure mds by changing (i,x)
+     *        to (i',x'), with i' = f_I(i) and i' in [p_x', p_x' + d_x'); mds_t only has to provide p(), idx(),
+     *        offs(), prefetch() and num_intervals(), so derived classes that store the pairs in another layout
+     *        can answer move queries with this, too
+     * @tparam policy move policy to use
+     * @tparam mds_t type of the move data structure
+     * @param mds the move data structure
+     * @param i [0..n-1]
+     * @param x [0..k_'-1], where i in [p_x, p_x + d_x)
+     */
+    template <move_policy policy, typename mds_t>
+    static inline void generic_move(const mds_t& mds, pos_t& i, pos_t& x) {
+        if constexpr (policy == _move_plain) {
+            i = mds.q(x)+(i-mds.p(x));
+            x = mds.idx(x);
+            while (i >= mds.p(x+1)) {
+                x++;
+            }
+        } else {
+            // index of the input interval containing q_x; request its pair while the rest of the x-th pair is read
+            pos_t x_ = mds.idx(x);
+            mds.prefetch(x_);
+            i = mds.offs(x)+(i-mds.p(x));
+            i += mds.p(x_);
+            x = x_;
+
+            // most of the time, i already lies in the x-th input interval
+            if (i < mds.p(x+1)) return;
+            x++;
+
+            /* Because of the a-balancedness, the output interval can only overlap few input intervals, so compare i with
+            the next ff_window input interval starting positions at once; since they are increasing, the number of them
+            that are <= i is the number of intervals to skip (the windows must not exceed D_p[k_'] = n) */
+            while (x+ff_window <= mds.num_intervals()) {
+                pos_t num_leq = 0;
+
+                for (pos_t w=1; w<=ff_window; w++) {
+                    num_leq += mds.p(x+w) <= i;
+                }
+
+                x += num_leq;
+                if (num_leq < ff_window) return;
+            }
+
+            while (i >= mds.p(x+1)) {
+                x++;
+            }
+        }
+    }
+
+    public:
     /**
      * @brief calculates the move query Move(I,i,x) = (i',x') by changing (i,x)
      *        to (i',x'), with i' = f_I(i) and i' in [p_x', p_x' + d_x')
+     * @tparam policy move policy to use
      * @param i [0..n-1]
      * @param x [0..k_'-1], where i in [p_x, p_x + d_x)
      */
+    template <move_policy policy = MOVE_R_MOVE_POLICY>
     inline void move(pos_t& i, pos_t& x) const {
-        i = q(x)+(i-p(x));
-        x = idx(x);
-        while (i >= p(x+1)) {
-            x++;
-        }
+        generic_move<policy>(*this,i,x);
     }
 
     /**
      * @brief performs the move query Move(I,i,x) = (i',x') by changing ix = (i,x) to
      *        (i',x'), with i' = f_I(i) and i' in [p_x', p_x' + d_x') and returns (i',x')
+     * @tparam policy move policy to use
      * @param i [0..n-1]
      * @param x [0..k_'-1], where i in [p_x, p_x + d_x)
      * @returns
      */
+    template <move_policy policy = MOVE_R_MOVE_POLICY>
     inline pair_t move(pair_t ix) const {
-        move(ix.first,ix.second);
+        move<policy>(ix.first,ix.second);
         return ix;
     }
 
+    /**
+     * @brief calls f with a view of this move data structure, whose widths are compile-time constants, if they are
+     *        one of the combinations in mds_fixed_widths, else with this move data structure itself; both answer the
+     *        same queries, so f should be a generic lambda, in which the hot query loop runs
+     * @param f function that takes a const reference to a move data structure
+     */
+    template <typename fnc_t>
+    inline void with_fixed_widths(fnc_t&& f) const {
+        dispatch_fixed_widths<0,char>(*this,data,f);
+    }
+
+    protected:
+    /**
+     * @brief calls f with a move_data_structure_fixed view of the interleaved vectors data, if the widths of D_p,
+     *        D_idx and D_offs are one of the combinations in mds_fixed_widths and L' has the width w_l_, else with mds
+     * @tparam w_l_ width of L' (in bytes; 0 = no L')
+     * @tparam l_t type of the entries in L'
+     * @param mds the move data structure
+     * @param data interleaved vectors storing D_p, D_idx and D_offs (and L')
+     * @param f function that takes a const reference to a move data structure
+     */
+    template <uint8_t w_l_, typename l_t, typename mds_t, typename fnc_t>
+    static inline void dispatch_fixed_widths(const mds_t& mds, const interleaved_vectors<pos_t,pos_t>& data, fnc_t&& f) {
+        bool dispatched = false;
+
+        if constexpr (MOVE_R_FIXED_WIDTHS) {
+            for_constexpr<0,mds_fixed_widths.size(),1>([&](auto c){
+                constexpr std::array<uint8_t,3> w = mds_fixed_widths[c];
+
+                if constexpr (std::max({w[0],w[1],w[2]}) <= sizeof(pos_t)) {
+                    if (
+                        !dispatched && data.width(0) == w[0] && data.width(1) == w[1] &&
+                        data.width(2) == w[2] && (w_l_ == 0 || data.width(3) == w_l_)
+                    ) {
+                        dispatched = true;
+                        f(move_data_structure_fixed<pos_t,w[0],w[1],w[2],w_l_,l_t>(data.data(),mds.num_intervals()));
+                    }
+                }
+            });
+        }
+
+        if (!dispatched) f(mds);
+    }
+
+    /**
+     * @brief calls f with a move_data_structure_packed_fixed view of the packed interleaved vectors data_packed, if
+     *        the widths of D_p, D_idx and D_offs are one of the combinations in mds_packed_fixed_widths, else with mds
+     * @tparam w_l_ width of L' (in bytes; 0 = no L')
+     * @tparam l_t type of the entries in L'
+     * @param mds the move data structure
+     * @param data_packed packed interleaved vectors storing D_p, D_idx and D_offs
+     * @param L_ pointer to L', which is stored separately (NULL, if w_l_ = 0)
+     * @param f function that takes a const reference to a move data structure
+     */
+    template <uint8_t w_l_, typename l_t, typename mds_t, typename fnc_t>
+    static inline void dispatch_packed_fixed_widths(
+        const mds_t& mds, const packed_interleaved_vectors<pos_t,pos_t,3>& data_packed, const char* L_, fnc_t&& f
+    ) {
+        bool dispatched = false;
+
+        if constexpr (MOVE_R_FIXED_WIDTHS) {
+            for_constexpr<0,mds_packed_fixed_widths.size(),1>([&](auto c){
+                constexpr std::array<uint8_t,3> w = mds_packed_fixed_widths[c];
+
+                if constexpr (std::max({w[0],w[1],w[2]}) <= 8*sizeof(pos_t)) {
+                    if (
+                        !dispatched && data_packed.width(0) == w[0] &&
+                        data_packed.width(1) == w[1] && data_packed.width(2) == w[2]
+                    ) {
+                        dispatched = true;
+                        f(move_data_structure_packed_fixed<pos_t,w[0],w[1],w[2],w_l_,l_t>(
+                            data_packed.data(),L_,mds.num_intervals()
+                        ));
+                    }
+                }
+            });
+        }
+
+        if (!dispatched) f(mds);
+    }
+
+    public:
     /**
      * @brief serializes the move data structure to an output stream
      * @param out output stream
      */
     void serialize(std::ostream& out) const {
+        serialize(out,data);
+    }
+
+    protected:
+    /**
+     * @brief serializes the move data structure to an output stream, but with the interleaved vectors data_out
+     *        instead of data (used by derived classes that store some of the vectors separately)
+     * @param out output stream
+     * @param data_out interleaved vectors storing D_p, D_idx and D_offs (and L', for M_LF)
+     */
+    void serialize(std::ostream& out, const interleaved_vectors<pos_t,pos_t>& data_out) const {
         out.write((char*)&n,sizeof(pos_t));
         out.write((char*)&k,sizeof(pos_t));
         out.write((char*)&k_,sizeof(pos_t));
@@ -261,9 +529,10 @@ class move_data_structure {
         out.write((char*)&omega_idx,1);
         out.write((char*)&omega_offs,1);
         out.write((char*)&omega_l_,1);
-        data.serialize(out);
+        data_out.serialize(out);
     }
 
+    public:
     /**
      * @brief loads the move data structure from an input stream
      * @param in input stream
@@ -291,4 +560,299 @@ class move_data_structure {
     }
 };
 
+/**
+ * @brief read-only view of a move data structure that stores D_p, D_idx and D_offs (and L') interleaved, whose widths
+ *        are template parameters, so the offsets, the stride and the masks of its accessors are compile-time constants
+ *        (obtained with with_fixed_widths(); it is only valid as long as the move data structure is not changed)
+ * @tparam pos_t unsigned integer type of the interval starting positions
+ * @tparam w_p width of D_p (in bytes)
+ * @tparam w_idx width of D_idx (in bytes)
+ * @tparam w_offs width of D_offs (in bytes)
+ * @tparam w_l_ width of L' (in bytes; 0 = no L')
+ * @tparam l_t type of the entries in L'
+ */
+template <typename pos_t, uint8_t w_p, uint8_t w_idx, uint8_t w_offs, uint8_t w_l_, typename l_t>
+class move_data_structure_fixed {
+    static_assert(std::max({w_p,w_idx,w_offs}) <= sizeof(pos_t) && w_l_ <= sizeof(l_t));
+
+    using pair_t = std::pair<pos_t,pos_t>; // pair type
+
+    static constexpr uint64_t stride = w_p+w_idx+w_offs+w_l_; // number of bytes per entry
+    static constexpr uint64_t offs_idx = w_p; // offset of D_idx in an entry
+    static constexpr uint64_t offs_offs = w_p+w_idx; // offset of D_offs in an entry
+    static constexpr uint64_t offs_l_ = w_p+w_idx+w_offs; // offset of L' in an entry
+
+    const char* data; // pointer to the first entry
+    pos_t k_; // k', number of intervals
+
+    /**
+     * @brief returns the value of width width at the offset offset in the x-th entry (the interleaved vectors are
+     *        padded, so reading sizeof(T) bytes is safe)
+     * @tparam offset offset in the entry (in bytes)
+     * @tparam width width of the value (in bytes)
+     * @tparam T type of the value
+     * @param x [0..k_']
+     * @return the value
+     */
+    template <uint64_t offset, uint8_t width, typename T = pos_t>
+    inline T get(pos_t x) const {
+        T v;
+        std::memcpy(&v,data+x*stride+offset,sizeof(T));
+        if constexpr (width < sizeof(T)) v &= (T{1} << (8*width))-1;
+        return v;
+    }
+
+    public:
+    /**
+     * @brief creates a view of the interleaved entries at data
+     * @param data pointer to the first entry
+     * @param k_ k', number of intervals
+     */
+    move_data_structure_fixed(const char* data, pos_t k_) : data(data), k_(k_) {}
+
+    /**
+     * @brief returns the number k' of intervals in the move data structure
+     * @return k'
+     */
+    inline pos_t num_intervals() const {
+        return k_;
+    }
+
+    /**
+     * @brief returns the size of the viewed entries in bytes
+     * @return size of the viewed entries in bytes
+     */
+    uint64_t size_in_bytes() const {
+        return (uint64_t{k_}+1)*stride;
+    }
+
+    /**
+     * @brief returns D_p[x]
+     * @param x [0..k_']
+     * @return D_p[x]
+     */
+    inline pos_t p(pos_t x) const {
+        return get<0,w_p>(x);
+    }
+
+    /**
+     * @brief returns q_x
+     * @param x [0..k_'-1]
+     * @return q_x
+     */
+    inline pos_t q(pos_t x) const {
+        return p(idx(x))+offs(x);
+    }
+
+    /**
+     * @brief returns D_idx[x]
+     * @param x [0..k_'-1]
+     * @return D_idx[x]
+     */
+    inline pos_t idx(pos_t x) const {
+        return get<offs_idx,w_idx>(x);
+    }
+
+    /**
+     * @brief returns D_offs[x]
+     * @param x [0..k_'-1]
+     * @return D_offs[x]
+     */
+    inline pos_t offs(pos_t x) const {
+        return get<offs_offs,w_offs>(x);
+    }
+
+    /**
+     * @brief returns the value in L_ at position x
+     * @param x index in [0..k_'-1]
+     * @return the value in L_ at position x
+     */
+    inline l_t L_(pos_t x) const requires(w_l_ > 0) {
+        return get<offs_l_,w_l_,l_t>(x);
+    }
+
+    /**
+     * @brief prefetches the x-th entry into the cache
+     * @param x [0..k_']
+     */
+    inline void prefetch(pos_t x) const {
+        __builtin_prefetch(data+x*stride);
+    }
+
+    /**
+     * @brief calculates the move query Move(I,i,x) = (i',x') by changing (i,x)
+     *        to (i',x'), with i' = f_I(i) and i' in [p_x', p_x' + d_x')
+     * @tparam policy move policy to use
+     * @param i [0..n-1]
+     * @param x [0..k_'-1], where i in [p_x, p_x + d_x)
+     */
+    template <move_policy policy = MOVE_R_MOVE_POLICY>
+    inline void move(pos_t& i, pos_t& x) const {
+        move_data_structure<pos_t>::template generic_move<policy>(*this,i,x);
+    }
+
+    /**
+     * @brief performs the move query Move(I,i,x) = (i',x') by changing ix = (i,x) to
+     *        (i',x'), with i' = f_I(i) and i' in [p_x', p_x' + d_x') and returns (i',x')
+     * @tparam policy move policy to use
+     * @param i [0..n-1]
+     * @param x [0..k_'-1], where i in [p_x, p_x + d_x)
+     * @returns
+     */
+    template <move_policy policy = MOVE_R_MOVE_POLICY>
+    inline pair_t move(pair_t ix) const {
+        move<policy>(ix.first,ix.second);
+        return ix;
+    }
+};
+
+/**
+ * @brief read-only view of a move data structure that stores D_p, D_idx and D_offs bit-packed (and L' in a separate
+ *        array), whose widths are template parameters, so the bit offsets, the stride and the masks of its accessors
+ *        are compile-time constants (obtained with with_fixed_widths(); it is only valid as long as the move data
+ *        structure is not changed)
+ * @tparam pos_t unsigned integer type of the interval starting positions
+ * @tparam w_p width of D_p (in bits)
+ * @tparam w_idx width of D_idx (in bits)
+ * @tparam w_offs width of D_offs (in bits)
+ * @tparam w_l_ width of L' (in bytes; 0 = no L')
+ * @tparam l_t type of the entries in L'
+ */
+template <typename pos_t, uint8_t w_p, uint8_t w_idx, uint8_t w_offs, uint8_t w_l_, typename l_t>
+class move_data_structure_packed_fixed {
+    // a value starts at most 7 bits after a byte boundary, so it can be read with one 64-bit load
+    static_assert(std::max({w_p,w_idx,w_offs}) <= std::min<uint64_t>(57,8*sizeof(pos_t)) && w_l_ <= sizeof(l_t));
+
+    using pair_t = std::pair<pos_t,pos_t>; // pair type
+
+    static constexpr uint64_t stride = w_p+w_idx+w_offs; // number of bits per entry
+    static constexpr uint64_t offs_idx = w_p; // offset of D_idx in an entry (in bits)
+    static constexpr uint64_t offs_offs = w_p+w_idx; // offset of D_offs in an entry (in bits)
+
+    const char* data; // pointer to the first entry
+    const char* L_sep; // pointer to the first entry of L'
+    pos_t k_; // k', number of intervals
+
+    /**
+     * @brief returns the value of width width at the bit offset offset in the x-th entry (the packed interleaved
+     *        vectors are padded, so reading 8 bytes is safe)
+     * @tparam offset offset in the entry (in bits)
+     * @tparam width width of the value (in bits)
+     * @param x [0..k_']
+     * @return the value
+     */
+    template <uint64_t offset, uint8_t width>
+    inline pos_t get(pos_t x) const {
+        uint64_t pos = x*stride+offset;
+        uint64_t word;
+        std::memcpy(&word,data+pos/8,8);
+        return (word >> (pos%8)) & ((uint64_t{1} << width)-1);
+    }
+
+    public:
+    /**
+     * @brief creates a view of the packed entries at data
+     * @param data pointer to the first entry
+     * @param L_sep pointer to the first entry of L' (NULL, if w_l_ = 0)
+     * @param k_ k', number of intervals
+     */
+    move_data_structure_packed_fixed(const char* data, const char* L_sep, pos_t k_) : data(data), L_sep(L_sep), k_(k_) {}
+
+    /**
+     * @brief returns the number k' of intervals in the move data structure
+     * @return k'
+     */
+    inline pos_t num_intervals() const {
+        return k_;
+    }
+
+    /**
+     * @brief returns the size of the viewed entries in bytes
+     * @return size of the viewed entries in bytes
+     */
+    uint64_t size_in_bytes() const {
+        return ((uint64_t{k_}+1)*stride+7)/8+(uint64_t{k_}+1)*w_l_;
+    }
+
+    /**
+     * @brief returns D_p[x]
+     * @param x [0..k_']
+     * @return D_p[x]
+     */
+    inline pos_t p(pos_t x) const {
+        return get<0,w_p>(x);
+    }
+
+    /**
+     * @brief returns q_x
+     * @param x [0..k_'-1]
+     * @return q_x
+     */
+    inline pos_t q(pos_t x) const {
+        return p(idx(x))+offs(x);
+    }
+
+    /**
+     * @brief returns D_idx[x]
+     * @param x [0..k_'-1]
+     * @return D_idx[x]
+     */
+    inline pos_t idx(pos_t x) const {
+        return get<offs_idx,w_idx>(x);
+    }
+
+    /**
+     * @brief returns D_offs[x]
+     * @param x [0..k_'-1]
+     * @return D_offs[x]
+     */
+    inline pos_t offs(pos_t x) const {
+        return get<offs_offs,w_offs>(x);
+    }
+
+    /**
+     * @brief returns the value in L_ at position x
+     * @param x index in [0..k_'-1]
+     * @return the value in L_ at position x
+     */
+    inline l_t L_(pos_t x) const requires(w_l_ == 1) {
+        return L_sep[x];
+    }
+
+    /**
+     * @brief prefetches the x-th entry (and L'[x]) into the cache
+     * @param x [0..k_']
+     */
+    inline void prefetch(pos_t x) const {
+        __builtin_prefetch(data+(x*stride)/8);
+        if constexpr (w_l_ > 0) __builtin_prefetch(L_sep+x);
+    }
+
+    /**
+     * @brief calculates the move query Move(I,i,x) = (i',x') by changing (i,x)
+     *        to (i',x'), with i' = f_I(i) and i' in [p_x', p_x' + d_x')
+     * @tparam policy move policy to use
+     * @param i [0..n-1]
+     * @param x [0..k_'-1], where i in [p_x, p_x + d_x)
+     */
+    template <move_policy policy = MOVE_R_MOVE_POLICY>
+    inline void move(pos_t& i, pos_t& x) const {
+        move_data_structure<pos_t>::template generic_move<policy>(*this,i,x);
+    }
+
+    /**
+     * @brief performs the move query Move(I,i,x) = (i',x') by changing ix = (i,x) to
+     *        (i',x'), with i' = f_I(i) and i' in [p_x', p_x' + d_x') and returns (i',x')
+     * @tparam policy move policy to use
+     * @param i [0..n-1]
+     * @param x [0..k_'-1], where i in [p_x, p_x + d_x)
+     * @returns
+     */
+    template <move_policy policy = MOVE_R_MOVE_POLICY>
+    inline pair_t move(pair_t ix) const {
+        move<policy>(ix.first,ix.second);
+        return ix;
+    }
+};
+
 #include "construction/construction.hpp"
\ No newline at end of file
@@ -2,16 +2,47 @@
 
 #include "move_data_structure.hpp"
 
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+/**
+ * @brief layout of the arrays of a move_data_structure_l_
+ */
+enum mds_l_layout {
+    _l_interleaved, // D_p, D_idx, D_offs and L' are interleaved (fastest move queries)
+    _l_separate, // D_p, D_idx and D_offs are interleaved, L' is stored in a separate contiguous array
+    _l_p_separate, // D_idx and D_offs are interleaved, D_p and L' are stored in separate contiguous arrays
+    /* D_p, D_idx and D_offs are interleaved with bit-granular widths, L' is stored in a separate contiguous array
+    (smallest, but the values have to be shifted and masked) */
+    _l_packed
+};
+
+// layout that is used if none is specified (can be set at compile time, e.g. with -DMOVE_R_LAYOUT_L_=_l_separate)
+#ifndef MOVE_R_LAYOUT_L_
+#define MOVE_R_LAYOUT_L_ _l_interleaved
+#endif
+
 /**
  * @brief move data structure, additionally stores a string interleaved with the arrays needed for move queries
  * @tparam pos_t unsigned integer type of the interval starting positions
+ * @tparam l_t type of the entries in L'
+ * @tparam layout layout of the arrays (does not affect the serialized data structure)
  */
-template <typename pos_t = uint32_t, typename l_t = char>
+template <typename pos_t = uint32_t, typename l_t = char, mds_l_layout layout = MOVE_R_LAYOUT_L_>
 class move_data_structure_l_ : public move_data_structure<pos_t> {
     static_assert(std::is_same_v<pos_t,uint32_t> || std::is_same_v<pos_t,uint64_t>);
 
     using pair_t = typename move_data_structure<pos_t>::pair_t; // pair type
     using pair_arr_t = typename move_data_structure<pos_t>::pair_arr_t; // pair array type
+    using ul_t = std::make_unsigned_t<l_t>; // unsigned type of the entries in L'
+
+    // [0..k_'] L' (only if layout != _l_interleaved)
+    interleaved_vectors<ul_t,pos_t,1> L_sep;
+    // [0..k_'] D_p (only if layout == _l_p_separate)
+    interleaved_vectors<pos_t,pos_t,1> D_p_sep;
+    // [0..k_'] D_p, D_idx and D_offs with bit-granular widths (only if layout == _l_packed)
+    packed_interleaved_vectors<pos_t,pos_t,3> D_packed;
 
     /**
      * @brief Constructs a new move data structure from a disjoint interval sequence
@@ -24,9 +55,81 @@ class move_data_structure_l_ : public move_data_structure<pos_t> {
         typename move_data_structure<pos_t>::construction(
             *reinterpret_cast<move_data_structure<pos_t>*>(this),I,n,delete_i,omega_l_,params,NULL
         );
+        separate();
         set_L_(move_data_structure<pos_t>::k_,0);
     }
 
+    /**
+     * @brief moves L' (and D_p, if layout = _l_p_separate) out of the interleaved vectors into separate arrays (if
+     *        layout = _l_packed, D_p, D_idx and D_offs are moved into bit-packed interleaved vectors)
+     */
+    void separate() {
+        if constexpr (layout != _l_interleaved) {
+            interleaved_vectors<pos_t,pos_t>& data = move_data_structure<pos_t>::data;
+            uint64_t size = data.size();
+            interleaved_vectors<pos_t,pos_t> data_sep;
+
+            L_sep = interleaved_vectors<ul_t,pos_t,1>({data.width(3)});
+            L_sep.resize_no_init(size);
+
+            for (uint64_t x=0; x<size; x++) {
+                L_sep.template set<0,ul_t>(x,data.template get<3,ul_t>(x));
+            }
+
+            if constexpr (layout == _l_separate) {
+                data_sep = interleaved_vectors<pos_t,pos_t>({data.width(0),data.width(1),data.width(2)});
+                data_sep.resize_no_init(size);
+
+                for (uint64_t x=0; x<size; x++) {
+                    data_sep.template set<0,pos_t>(x,data.template get<0,pos_t>(x));
+                    data_sep.template set<1,pos_t>(x,data.template get<1,pos_t>(x));
+                    data_sep.template set<2,pos_t>(x,data.template get<2,pos_t>(x));
+                }
+            } else if constexpr (layout == _l_p_separate) {
+                D_p_sep = interleaved_vectors<pos_t,pos_t,1>({data.width(0)});
+                D_p_sep.resize_no_init(size);
+                data_sep = interleaved_vectors<pos_t,pos_t>({data.width(1),data.width(2)});
+                data_sep.resize_no_init(size);
+
+                for (uint64_t x=0; x<size; x++) {
+                    D_p_sep.template set<0,pos_t>(x,data.template get<0,pos_t>(x));
+                    data_sep.template set<0,pos_t>(x,data.template get<1,pos_t>(x));
+                    data_sep.template set<1,pos_t>(x,data.template get<2,pos_t>(x));
+                }
+            } else {
+                D_packed = move_data_structure<pos_t>::pack();
+            }
+
+            data = std::move(data_sep);
+        }
+    }
+
+    /**
+     * @brief returns the arrays of the move data structure interleaved in the layout _l_interleaved
+     * @return interleaved vectors storing D_p, D_idx, D_offs and L'
+     */
+    interleaved_vectors<pos_t,pos_t> interleave() const requires(layout != _l_interleaved) {
+        uint64_t size = L_sep.size();
+
+        interleaved_vectors<pos_t,pos_t> data_il({
+            (uint8_t)(move_data_structure<pos_t>::omega_p/8),
+            (uint8_t)(move_data_structure<pos_t>::omega_idx/8),
+            (uint8_t)(move_data_structure<pos_t>::omega_offs/8),
+            L_sep.width(0)
+        });
+
+        data_il.resize_no_init(size);
+
+        for (uint64_t x=0; x<size; x++) {
+            data_il.template set<0,pos_t>(x,p(x));
+            data_il.template set<1,pos_t>(x,idx(x));
+            data_il.template set<2,pos_t>(x,offs(x));
+            data_il.template set<3,ul_t>(x,L_sep.template get<0,ul_t>(x));
+        }
+
+        return data_il;
+    }
+
     public:
     move_data_structure_l_() = default;
 
@@ -36,7 +139,7 @@ class move_data_structure_l_ : public move_data_structure<pos_t> {
      * @param n n = p_k + d_j
      * @param params construction parameters
      */
-    move_data_structure_l_(pair_arr_t&& I, pos_t n, mds_params params = {}, uint8_t omega_l_ = sizeof(l_t)) {
+    move_data_structure_l_(pair_arr_t&& I, pos_t n, mds_params params = {}, uint8_t omega_l_ = 8*sizeof(l_t)) {
         build(I,n,true,params,omega_l_);
     }
 
@@ -46,10 +149,22 @@ class move_data_structure_l_ : public move_data_structure<pos_t> {
      * @param n n = p_k + d_j
      * @param params construction parameters
      */
-    move_data_structure_l_(pair_arr_t& I, pos_t n, mds_params params = {}, uint8_t omega_l_ = sizeof(l_t)) {
+    move_data_structure_l_(pair_arr_t& I, pos_t n, mds_params params = {}, uint8_t omega_l_ = 8*sizeof(l_t)) {
         build(I,n,false,params,omega_l_);
     }
 
+    /**
+     * @brief returns the size of the data structure in bytes
+     * @return size of the data structure in bytes
+     */
+    uint64_t size_in_bytes() const {
+        uint64_t size = move_data_structure<pos_t>::size_in_bytes();
+        if constexpr (layout != _l_interleaved) size += L_sep.size_in_bytes();
+        if constexpr (layout == _l_p_separate) size += D_p_sep.size_in_bytes();
+        if constexpr (layout == _l_packed) size += D_packed.size_in_bytes();
+        return size;
+    }
+
     /**
      * @brief returns the number omega_l_ of bits used by one entry in L' (word width of L')
      * @return omega_l_ 
@@ -58,29 +173,274 @@ class move_data_structure_l_ : public move_data_structure<pos_t> {
         return move_data_structure<pos_t>::omega_l_;
     }
 
+    /**
+     * @brief returns D_p[x]
+     * @param x [0..k_']
+     * @return D_p[x]
+     */
+    inline pos_t p(pos_t x) const {
+        if constexpr (layout == _l_p_separate) {
+            return D_p_sep.template get<0,pos_t>(x);
+        } else if constexpr (layout == _l_packed) {
+            return D_packed.template get<0,pos_t>(x);
+        } else {
+            return move_data_structure<pos_t>::p(x);
+        }
+    }
+
+    /**
+     * @brief returns q_x
+     * @param x [0..k_'-1]
+     * @return q_x
+     */
+    inline pos_t q(pos_t x) const {
+        return p(idx(x))+offs(x);
+    }
+
+    /**
+     * @brief returns D_idx[x]
+     * @param x [0..k_'-1]
+     * @return D_idx[x]
+     */
+    inline pos_t idx(pos_t x) const {
+        if constexpr (layout == _l_p_separate) {
+            return move_data_structure<pos_t>::data.template get<0,pos_t>(x);
+        } else if constexpr (layout == _l_packed) {
+            return D_packed.template get<1,pos_t>(x);
+        } else {
+            return move_data_structure<pos_t>::idx(x);
+        }
+    }
+
+    /**
+     * @brief returns D_offs[x]
+     * @param x [0..k_'-1]
+     * @return D_offs[x]
+     */
+    inline pos_t offs(pos_t x) const {
+        if constexpr (layout == _l_p_separate) {
+            return move_data_structure<pos_t>::data.template get<1,pos_t>(x);
+        } else if constexpr (layout == _l_packed) {
+            return D_packed.template get<2,pos_t>(x);
+        } else {
+            return move_data_structure<pos_t>::offs(x);
+        }
+    }
+
+    /**
+     * @brief prefetches the x-th entries of all arrays (D_p[x], D_idx[x], D_offs[x] and L'[x]) into the cache
+     * @param x [0..k_']
+     */
+    inline void prefetch(pos_t x) const {
+        if constexpr (layout == _l_packed) {
+            D_packed.prefetch(x);
+        } else {
+            move_data_structure<pos_t>::data.prefetch(x);
+        }
+
+        if constexpr (layout != _l_interleaved) L_sep.prefetch(x);
+        if constexpr (layout == _l_p_separate) D_p_sep.prefetch(x);
+    }
+
+    /**
+     * @brief calculates the move query Move(I,i,x) = (i',x') by changing (i,x)
+     *        to (i',x'), with i' = f_I(i) and i' in [p_x', p_x' + d_x')
+     * @tparam policy move policy to use
+     * @param i [0..n-1]
+     * @param x [0..k_'-1], where i in [p_x, p_x + d_x)
+     */
+    template <move_policy policy = MOVE_R_MOVE_POLICY>
+    inline void move(pos_t& i, pos_t& x) const {
+        move_data_structure<pos_t>::template generic_move<policy>(*this,i,x);
+    }
+
+    /**
+     * @brief performs the move query Move(I,i,x) = (i',x') by changing ix = (i,x) to
+     *        (i',x'), with i' = f_I(i) and i' in [p_x', p_x' + d_x') and returns (i',x')
+     * @tparam policy move policy to use
+     * @param i [0..n-1]
+     * @param x [0..k_'-1], where i in [p_x, p_x + d_x)
+     * @returns
+     */
+    template <move_policy policy = MOVE_R_MOVE_POLICY>
+    inline pair_t move(pair_t ix) const {
+        move<policy>(ix.first,ix.second);
+        return ix;
+    }
+
+    /**
+     * @brief calls f with a view of this move data structure, whose widths (including the width of L') are
+     *        compile-time constants, if the entries of L' are single bytes and L' is interleaved with D_p, D_idx and
+     *        D_offs, whose widths are one of the combinations in mds_fixed_widths, or D_p, D_idx and D_offs are
+     *        bit-packed with one of the combinations in mds_packed_fixed_widths, else with this move data structure
+     *        itself
+     * @param f function that takes a const reference to a move data structure with L'
+     */
+    template <typename fnc_t>
+    inline void with_fixed_widths(fnc_t&& f) const {
+        if constexpr (layout == _l_interleaved && sizeof(l_t) == 1) {
+            move_data_structure<pos_t>::template dispatch_fixed_widths<1,l_t>(*this,move_data_structure<pos_t>::data,f);
+        } else if constexpr (layout == _l_packed && sizeof(l_t) == 1) {
+            move_data_structure<pos_t>::template dispatch_packed_fixed_widths<1,l_t>(*this,D_packed,L_sep.data(),f);
+        } else {
+            f(*this);
+        }
+    }
+
     /**
      * @brief returns the value in L_ at position x
      * @param x index in [0..k_'-1]
      * @return the value in L_ at position x
      */
     inline l_t L_(pos_t x) const {
-        if constexpr (sizeof(l_t) == 1) {
+        if constexpr (layout != _l_interleaved) {
+            if constexpr (sizeof(l_t) == 1) {
+                return L_sep.template get_unsafe<0,l_t>(x);
+            } else {
+                return L_sep.template get<0,l_t>(x);
+            }
+        } else if constexpr (sizeof(l_t) == 1) {
             return move_data_structure<pos_t>::data.template get_unsafe<3,l_t>(x);
         } else {
             return move_data_structure<pos_t>::data.template get<3,l_t>(x);
         }
     }
 
+    /**
+     * @brief returns the smallest x in [x_b,x_e) with L_[x] = v, or x_e if there is no such x (with AVX2,
+     *        the entries of L_ are compared 32 at a time if L_ is stored separately, else gathered and
+     *        compared eight at a time)
+     * @param v a value
+     * @param x_b index in [0..k_'-1]
+     * @param x_e index in [x_b..k_']
+     * @return the smallest x in [x_b,x_e) with L_[x] = v, or x_e
+     */
+    inline pos_t find_l_(l_t v, pos_t x_b, pos_t x_e) const requires(sizeof(l_t) == 1) {
+        pos_t x = x_b;
+
+#ifdef __AVX2__
+        if constexpr (layout != _l_interleaved) {
+            const char* base = L_sep.data();
+            const __m256i vals = _mm256_set1_epi8(v);
+
+            while (x+32 <= x_e) {
+                uint32_t eq = _mm256_movemask_epi8(_mm256_cmpeq_epi8(
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(base+x)),vals));
+                if (eq != 0) return x+__builtin_ctz(eq);
+                x += 32;
+            }
+        } else {
+            const char* base = move_data_structure<pos_t>::data.data(3);
+            const uint64_t stride = move_data_structure<pos_t>::data.bytes_per_entry();
+            const __m256i offs = _mm256_mullo_epi32(_mm256_setr_epi32(0,1,2,3,4,5,6,7),_mm256_set1_epi32(stride));
+            const __m256i vals = _mm256_set1_epi32(uint8_t(v));
+            const __m256i mask = _mm256_set1_epi32(0xFF);
+
+            while (x+8 <= x_e) {
+                __m256i l_ = _mm256_and_si256(_mm256_i32gather_epi32(
+                    reinterpret_cast<const int*>(base+x*stride),offs,1),mask);
+                uint32_t eq = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(l_,vals)));
+                if (eq != 0) return x+__builtin_ctz(eq);
+                x += 8;
+            }
+        }
+#endif
+
+        while (x < x_e && L_(x) != v) x++;
+        return x;
+    }
+
+    /**
+     * @brief returns the largest x in (x_b,x_e] with L_[x] = v, or x_b if there is no such x (with AVX2,
+     *        the entries of L_ are compared 32 at a time if L_ is stored separately, else gathered and
+     *        compared eight at a time)
+     * @param v a value
+     * @param x_b index in [0..k_'-1]
+     * @param x_e index in [x_b..k_'-1]
+     * @return the largest x in (x_b,x_e] with L_[x] = v, or x_b
+     */
+    inline pos_t rfind_l_(l_t v, pos_t x_b, pos_t x_e) const requires(sizeof(l_t) == 1) {
+        pos_t x = x_e;
+
+#ifdef __AVX2__
+        if constexpr (layout != _l_interleaved) {
+            const char* base = L_sep.data();
+            const __m256i vals = _mm256_set1_epi8(v);
+
+            while (x >= x_b+32) {
+                uint32_t eq = _mm256_movemask_epi8(_mm256_cmpeq_epi8(
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(base+(x-31))),vals));
+                if (eq != 0) return x-31+(31-__builtin_clz(eq));
+                x -= 32;
+            }
+        } else {
+            const char* base = move_data_structure<pos_t>::data.data(3);
+            const uint64_t stride = move_data_structure<pos_t>::data.bytes_per_entry();
+            const __m256i offs = _mm256_mullo_epi32(_mm256_setr_epi32(0,1,2,3,4,5,6,7),_mm256_set1_epi32(stride));
+            const __m256i vals = _mm256_set1_epi32(uint8_t(v));
+            const __m256i mask = _mm256_set1_epi32(0xFF);
+
+            while (x >= x_b+8) {
+                __m256i l_ = _mm256_and_si256(_mm256_i32gather_epi32(
+                    reinterpret_cast<const int*>(base+(x-7)*stride),offs,1),mask);
+                uint32_t eq = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(l_,vals)));
+                if (eq != 0) return x-7+(31-__builtin_clz(eq));
+                x -= 8;
+            }
+        }
+#endif
+
+        while (x > x_b && L_(x) != v) x--;
+        return x;
+    }
+
     /**
      * @brief sets the value in L_ at position x to c
      * @param x index in [0..k_'-1]
      * @param v a value
      */
     inline void set_L_(pos_t x, l_t v) {
-        if constexpr (sizeof(l_t) == 1) {
+        if constexpr (layout != _l_interleaved) {
+            if constexpr (sizeof(l_t) == 1) {
+                L_sep.template set_unsafe<0,l_t>(x,v);
+            } else {
+                L_sep.template set<0,l_t>(x,v);
+            }
+        } else if constexpr (sizeof(l_t) == 1) {
             move_data_structure<pos_t>::data.template set_unsafe<3,l_t>(x,v);
         } else {
             move_data_structure<pos_t>::data.template set<3,l_t>(x,v);
         }
     }
-};
\ No newline at end of file
+
+    /**
+     * @brief serializes the move data structure to an output stream (always in the layout _l_interleaved)
+     * @param out output stream
+     */
+    void serialize(std::ostream& out) const {
+        if constexpr (layout == _l_interleaved) {
+            move_data_structure<pos_t>::serialize(out);
+        } else {
+            move_data_structure<pos_t>::serialize(out,interleave());
+        }
+    }
+
+    /**
+     * @brief loads the move data structure from an input stream
+     * @param in input stream
+     */
+    void load(std::istream& in) {
+        move_data_structure<pos_t>::load(in);
+        separate();
+    }
+
+    std::ostream& operator>>(std::ostream& os) const {
+        serialize(os);
+        return os;
+    }
+
+    std::istream& operator<<(std::istream& is) {
+        load(is);
+        return is;
+    }
+};
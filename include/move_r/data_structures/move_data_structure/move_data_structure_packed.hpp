@@ -0,0 +1,198 @@
+#pragma once
+
+#include "move_data_structure.hpp"
+
+// controls, whether move_r stores M_Phi^{-1} and M_Phi bit-packed (can be set at compile time, e.g. with -DMOVE_R_PACKED_PHI=true)
+#ifndef MOVE_R_PACKED_PHI
+#define MOVE_R_PACKED_PHI false
+#endif
+
+/**
+ * @brief move data structure that stores D_p, D_idx and D_offs interleaved with bit-granular widths (smaller than
+ *        move_data_structure, but the values have to be shifted and masked)
+ * @tparam pos_t unsigned integer type of the interval starting positions
+ */
+template <typename pos_t = uint32_t>
+class move_data_structure_packed : public move_data_structure<pos_t> {
+    static_assert(std::is_same_v<pos_t,uint32_t> || std::is_same_v<pos_t,uint64_t>);
+
+    using pair_t = typename move_data_structure<pos_t>::pair_t; // pair type
+    using pair_arr_t = typename move_data_structure<pos_t>::pair_arr_t; // pair array type
+
+    // [0..k_'] D_p, D_idx and D_offs with bit-granular widths
+    packed_interleaved_vectors<pos_t,pos_t,3> data_packed;
+
+    /**
+     * @brief moves D_p, D_idx and D_offs out of the interleaved vectors into the packed interleaved vectors
+     */
+    void pack() {
+        data_packed = move_data_structure<pos_t>::pack();
+        move_data_structure<pos_t>::data = interleaved_vectors<pos_t,pos_t>();
+    }
+
+    /**
+     * @brief returns D_p, D_idx and D_offs interleaved with widths rounded up to whole bytes
+     * @return interleaved vectors storing D_p, D_idx and D_offs
+     */
+    interleaved_vectors<pos_t,pos_t> interleave() const {
+        uint64_t size = data_packed.size();
+
+        interleaved_vectors<pos_t,pos_t> data_il({
+            (uint8_t)(move_data_structure<pos_t>::omega_p/8),
+            (uint8_t)(move_data_structure<pos_t>::omega_idx/8),
+            (uint8_t)(move_data_structure<pos_t>::omega_offs/8)
+        });
+
+        data_il.resize_no_init(size);
+
+        for (uint64_t x=0; x<size; x++) {
+            data_il.template set<0,pos_t>(x,p(x));
+            data_il.template set<1,pos_t>(x,idx(x));
+            data_il.template set<2,pos_t>(x,offs(x));
+        }
+
+        return data_il;
+    }
+
+    public:
+    move_data_structure_packed() = default;
+
+    /**
+     * @brief Constructs a new move data structure from a disjoint interval sequence
+     * @param I a disjoint interval sequence
+     * @param n n = p_k + d_j
+     * @param params construction parameters
+     * @param pi_mphi vector to move pi into after the construction
+     */
+    move_data_structure_packed(pair_arr_t&& I, pos_t n, mds_params params = {}, std::vector<pos_t>* pi_mphi = NULL)
+        : move_data_structure<pos_t>(std::move(I),n,params,pi_mphi) {
+        pack();
+    }
+
+    /**
+     * @brief Constructs a new move data structure from a disjoint interval sequence
+     * @param I a disjoint interval sequence
+     * @param n n = p_k + d_j
+     * @param params construction parameters
+     * @param pi_mphi vector to move pi into after the construction
+     */
+    move_data_structure_packed(pair_arr_t& I, pos_t n, mds_params params = {}, std::vector<pos_t>* pi_mphi = NULL)
+        : move_data_structure<pos_t>(I,n,params,pi_mphi) {
+        pack();
+    }
+
+    /**
+     * @brief returns the size of the data structure in bytes
+     * @return size of the data structure in bytes
+     */
+    uint64_t size_in_bytes() const {
+        return move_data_structure<pos_t>::size_in_bytes()+data_packed.size_in_bytes();
+    }
+
+    /**
+     * @brief returns D_p[x]
+     * @param x [0..k_']
+     * @return D_p[x]
+     */
+    inline pos_t p(pos_t x) const {
+        return data_packed.template get<0,pos_t>(x);
+    }
+
+    /**
+     * @brief returns q_x
+     * @param x [0..k_'-1]
+     * @return q_x
+     */
+    inline pos_t q(pos_t x) const {
+        return p(idx(x))+offs(x);
+    }
+
+    /**
+     * @brief returns D_idx[x]
+     * @param x [0..k_'-1]
+     * @return D_idx[x]
+     */
+    inline pos_t idx(pos_t x) const {
+        return data_packed.template get<1,pos_t>(x);
+    }
+
+    /**
+     * @brief returns D_offs[x]
+     * @param x [0..k_'-1]
+     * @return D_offs[x]
+     */
+    inline pos_t offs(pos_t x) const {
+        return data_packed.template get<2,pos_t>(x);
+    }
+
+    /**
+     * @brief prefetches the x-th pair (D_p[x], D_idx[x] and D_offs[x]) into the cache
+     * @param x [0..k_']
+     */
+    inline void prefetch(pos_t x) const {
+        data_packed.prefetch(x);
+    }
+
+    /**
+     * @brief calculates the move query Move(I,i,x) = (i',x') by changing (i,x)
+     *        to (i',x'), with i' = f_I(i) and i' in [p_x', p_x' + d_x')
+     * @tparam policy move policy to use
+     * @param i [0..n-1]
+     * @param x [0..k_'-1], where i in [p_x, p_x + d_x)
+     */
+    template <move_policy policy = MOVE_R_MOVE_POLICY>
+    inline void move(pos_t& i, pos_t& x) const {
+        move_data_structure<pos_t>::template generic_move<policy>(*this,i,x);
+    }
+
+    /**
+     * @brief performs the move query Move(I,i,x) = (i',x') by changing ix = (i,x) to
+     *        (i',x'), with i' = f_I(i) and i' in [p_x', p_x' + d_x') and returns (i',x')
+     * @tparam policy move policy to use
+     * @param i [0..n-1]
+     * @param x [0..k_'-1], where i in [p_x, p_x + d_x)
+     * @returns
+     */
+    template <move_policy policy = MOVE_R_MOVE_POLICY>
+    inline pair_t move(pair_t ix) const {
+        move<policy>(ix.first,ix.second);
+        return ix;
+    }
+
+    /**
+     * @brief calls f with a view of this move data structure, whose widths are compile-time constants, if they are
+     *        one of the combinations in mds_packed_fixed_widths, else with this move data structure itself
+     * @param f function that takes a const reference to a move data structure
+     */
+    template <typename fnc_t>
+    inline void with_fixed_widths(fnc_t&& f) const {
+        move_data_structure<pos_t>::template dispatch_packed_fixed_widths<0,char>(*this,data_packed,NULL,f);
+    }
+
+    /**
+     * @brief serializes the move data structure to an output stream (in the same format as move_data_structure)
+     * @param out output stream
+     */
+    void serialize(std::ostream& out) const {
+        move_data_structure<pos_t>::serialize(out,interleave());
+    }
+
+    /**
+     * @brief loads the move data structure from an input stream
+     * @param in input stream
+     */
+    void load(std::istream& in) {
+        move_data_structure<pos_t>::load(in);
+        pack();
+    }
+
+    std::ostream& operator>>(std::ostream& os) const {
+        serialize(os);
+        return os;
+    }
+
+    std::istream& operator<<(std::istream& is) {
+        load(is);
+        return is;
+    }
+};
@@ -0,0 +1,463 @@
+#pragma once
+
+#include "move_data_structure.hpp"
+
+/**
+ * @brief copy of a move data structure (and L', if l_t is not void), whose rows are stored in another (physical)
+ *        order, e.g. in the order in which a chain of move queries visits them first, so chains of move queries in
+ *        repetitive regions of the input access consecutive rows; p, idx, offs, L_ and move take and return the row
+ *        indices of the original move data structure (logical row indices) and translate them, rows() returns a view
+ *        that works on the physical row indices directly (for chains of move queries, translate the row index once
+ *        with to_physical() before and with to_logical() after the chain)
+ * @tparam pos_t unsigned integer type of the interval starting positions
+ * @tparam l_t type of the entries in L' (void = no L')
+ */
+template <typename pos_t = uint32_t, typename l_t = void>
+class move_data_structure_reordered {
+    static_assert(std::is_same_v<pos_t,uint32_t> || std::is_same_v<pos_t,uint64_t>);
+
+    using pair_t = std::pair<pos_t,pos_t>; // pair type
+    static constexpr bool has_l_ = !std::is_same_v<l_t,void>; // true <=> L' is stored
+
+    pos_t n = 0; // n = p_{k_'}
+    pos_t k_ = 0; // k', number of intervals
+
+    /* [0..k_'-1] the rows in physical order; the physical row y stores D_p[x], the physical index of the row D_idx[x],
+    D_offs[x], the interval length d_x = D_p[x+1]-D_p[x], the physical index pi[x+1] of the next row (and L'[x]) of the
+    logical row x = sigma[y]; d_x is stored with the width of D_offs (the construction limits both to 2^omega_offs-1) */
+    interleaved_vectors<pos_t,pos_t> data;
+    // [0..k_'] pi[x] = physical index of the logical row x (pi[k_'] = k_')
+    interleaved_vectors<pos_t,pos_t> pi;
+    // [0..k_'-1] sigma[y] = logical index of the physical row y
+    interleaved_vectors<pos_t,pos_t> sigma;
+
+    public:
+    /**
+     * @brief view of a move_data_structure_reordered, whose row indices are physical row indices; if w_p > 0, the
+     *        widths (in bytes) of the rows are compile-time constants (see with_fixed_widths())
+     * @tparam w_p width of D_p (0 = widths are not fixed)
+     * @tparam w_idx width of D_idx and of the physical indices of the next rows
+     * @tparam w_offs width of D_offs and of the interval lengths
+     * @tparam w_l_ width of L'
+     */
+    template <uint8_t w_p = 0, uint8_t w_idx = 0, uint8_t w_offs = 0, uint8_t w_l_ = 0>
+    class physical_rows {
+        static constexpr bool fixed = w_p > 0; // true <=> the widths are compile-time constants
+        static constexpr uint64_t stride = w_p+2*w_idx+2*w_offs+w_l_; // number of bytes per row (if fixed)
+
+        const move_data_structure_reordered* mds; // the move data structure
+
+        /**
+         * @brief returns the value in the vector vec of the y-th row
+         * @tparam vec vector index (0 = D_p, 1 = D_idx, 2 = D_offs, 3 = d, 4 = next, 5 = L')
+         * @tparam T type of the value
+         * @param y [0..k_'-1]
+         * @return the value
+         */
+        template <uint8_t vec, typename T = pos_t>
+        inline T get(pos_t y) const {
+            if constexpr (fixed) {
+                constexpr std::array<uint8_t,6> widths = {w_p,w_idx,w_offs,w_offs,w_idx,w_l_};
+                uint64_t offset = 0;
+                for (uint8_t v=0; v<vec; v++) offset += widths[v];
+
+                // the interleaved vectors are padded, so reading sizeof(T) bytes is safe
+                T v;
+                std::memcpy(&v,mds->data.data()+y*stride+offset,sizeof(T));
+                if constexpr (widths[vec] < sizeof(T)) v &= (T{1} << (8*widths[vec]))-1;
+                return v;
+            } else {
+                return mds->data.template get<vec,T>(y);
+            }
+        }
+
+        public:
+        /**
+         * @brief creates a view of the rows of mds
+         * @param mds a reordered move data structure
+         */
+        physical_rows(const move_data_structure_reordered* mds) : mds(mds) {}
+
+        /**
+         * @brief returns the number k' of intervals in the move data structure
+         * @return k'
+         */
+        inline pos_t num_intervals() const {
+            return mds->k_;
+        }
+
+        /**
+         * @brief returns the size of the move data structure in bytes
+         * @return size of the move data structure in bytes
+         */
+        uint64_t size_in_bytes() const {
+            return mds->size_in_bytes();
+        }
+
+        /**
+         * @brief returns D_p[sigma[y]]
+         * @param y [0..k_'-1]
+         * @return D_p[sigma[y]]
+         */
+        inline pos_t p(pos_t y) const {
+            return get<0>(y);
+        }
+
+        /**
+         * @brief returns pi[D_idx[sigma[y]]], the physical index of the row D_idx[sigma[y]]
+         * @param y [0..k_'-1]
+         * @return pi[D_idx[sigma[y]]]
+         */
+        inline pos_t idx(pos_t y) const {
+            return get<1>(y);
+        }
+
+        /**
+         * @brief returns D_offs[sigma[y]]
+         * @param y [0..k_'-1]
+         * @return D_offs[sigma[y]]
+         */
+        inline pos_t offs(pos_t y) const {
+            return get<2>(y);
+        }
+
+        /**
+         * @brief returns the length d_{sigma[y]} = D_p[sigma[y]+1]-D_p[sigma[y]] of the interval of the y-th row
+         * @param y [0..k_'-1]
+         * @return d_{sigma[y]}
+         */
+        inline pos_t d(pos_t y) const {
+            return get<3>(y);
+        }
+
+        /**
+         * @brief returns pi[sigma[y]+1], the physical index of the row following the y-th row in logical order
+         * @param y [0..k_'-1]
+         * @return pi[sigma[y]+1]
+         */
+        inline pos_t next(pos_t y) const {
+            return get<4>(y);
+        }
+
+        /**
+         * @brief returns L'[sigma[y]]
+         * @param y [0..k_'-1]
+         * @return L'[sigma[y]]
+         */
+        inline l_t L_(pos_t y) const requires(has_l_) {
+            return get<5,l_t>(y);
+        }
+
+        /**
+         * @brief prefetches the y-th row into the cache
+         * @param y [0..k_'-1]
+         */
+        inline void prefetch(pos_t y) const {
+            mds->data.prefetch(y);
+        }
+
+        /**
+         * @brief calculates the move query Move(I,i,x) = (i',x') by changing (i,y) to (i',y'), with i' = f_I(i),
+         *        y = pi[x] and y' = pi[x']; the rows store the physical indices of their target rows and of their
+         *        logical successors, and their interval lengths, so no row index has to be translated
+         * @tparam policy move policy to use (_move_fast prefetches the target row before reading the rest of the row)
+         * @param i [0..n-1]
+         * @param y [0..k_'-1], where i in [p_{sigma[y]}, p_{sigma[y]} + d_{sigma[y]})
+         */
+        template <move_policy policy = MOVE_R_MOVE_POLICY>
+        inline void move(pos_t& i, pos_t& y) const {
+            pos_t y_ = idx(y);
+            if constexpr (policy == _move_fast) prefetch(y_);
+            i = offs(y)+(i-p(y));
+            i += p(y_);
+            y = y_;
+
+            while (p(y)+d(y) <= i) {
+                y = next(y);
+            }
+        }
+
+        /**
+         * @brief performs the move query Move(I,i,x) = (i',x') by changing iy = (i,y) to (i',y'), with i' = f_I(i),
+         *        y = pi[x] and y' = pi[x'], and returns (i',y')
+         * @tparam policy move policy to use
+         * @param iy (i,y), where i in [0..n-1] and i in [p_{sigma[y]}, p_{sigma[y]} + d_{sigma[y]})
+         * @return (i',y')
+         */
+        template <move_policy policy = MOVE_R_MOVE_POLICY>
+        inline pair_t move(pair_t iy) const {
+            move<policy>(iy.first,iy.second);
+            return iy;
+        }
+    };
+
+    move_data_structure_reordered() = default;
+
+    /**
+     * @brief copies the move data structure mds (and its L', if l_t is not void) and stores its rows in the order
+     *        order
+     * @param mds a move data structure
+     * @param order [0..k_'-1] permutation of [0..k_'-1]; order[y] = logical index of the row stored at physical
+     *        position y
+     * @param num_threads maximum number of threads to use
+     */
+    template <typename mds_t>
+    move_data_structure_reordered(const mds_t& mds, const std::vector<pos_t>& order, uint16_t num_threads = 1) {
+        k_ = mds.num_intervals();
+        n = mds.p(k_);
+
+        auto width = [](uint64_t max_val){return (uint8_t)std::max<uint8_t>(1,(std::bit_width(max_val)+7)/8);};
+        pos_t max_offs_d = 0; // maximum offset or interval length
+
+        #pragma omp parallel for reduction(max:max_offs_d) num_threads(num_threads)
+        for (pos_t x=0; x<k_; x++) {
+            max_offs_d = std::max({max_offs_d,mds.offs(x),mds.p(x+1)-mds.p(x)});
+        }
+
+        uint8_t width_l_ = 0;
+        if constexpr (has_l_) width_l_ = mds.width_l_()/8;
+
+        data = interleaved_vectors<pos_t,pos_t>({
+            width(n),width(k_),width(max_offs_d),width(max_offs_d),width(k_),width_l_
+        });
+        pi = interleaved_vectors<pos_t,pos_t>({width(k_)});
+        sigma = interleaved_vectors<pos_t,pos_t>({width(k_)});
+        data.resize_no_init(k_);
+        pi.resize_no_init(k_+1);
+        sigma.resize_no_init(k_);
+        pi.template set<0,pos_t>(k_,k_);
+
+        #pragma omp parallel for num_threads(num_threads)
+        for (pos_t y=0; y<k_; y++) {
+            pi.template set<0,pos_t>(order[y],y);
+            sigma.template set<0,pos_t>(y,order[y]);
+        }
+
+        #pragma omp parallel for num_threads(num_threads)
+        for (pos_t y=0; y<k_; y++) {
+            pos_t x = order[y];
+            data.template set<0,pos_t>(y,mds.p(x));
+            data.template set<1,pos_t>(y,to_physical(mds.idx(x)));
+            data.template set<2,pos_t>(y,mds.offs(x));
+            data.template set<3,pos_t>(y,mds.p(x+1)-mds.p(x));
+            data.template set<4,pos_t>(y,to_physical(x+1));
+            if constexpr (has_l_) data.template set<5,l_t>(y,mds.L_(x));
+        }
+    }
+
+    /**
+     * @brief returns the order, in which a chain of move queries starting with (i,x) visits the rows of mds first
+     *        (followed by the rows that are not visited within max_steps move queries, in increasing order)
+     * @param mds a move data structure
+     * @param i [0..n-1]
+     * @param x [0..k_'-1], where i in [p_x, p_x + d_x)
+     * @param max_steps maximum number of move queries to perform
+     * @return [0..k_'-1] order[y] = y-th visited row
+     */
+    template <typename mds_t>
+    static std::vector<pos_t> walk_order(const mds_t& mds, pos_t i, pos_t x, uint64_t max_steps) {
+        pos_t k_ = mds.num_intervals();
+        std::vector<pos_t> order;
+        order.reserve(k_);
+        std::vector<bool> visited(k_,false);
+
+        for (uint64_t step=0; step<max_steps && order.size()<k_; step++) {
+            if (!visited[x]) {
+                visited[x] = true;
+                order.emplace_back(x);
+            }
+
+            mds.move(i,x);
+        }
+
+        for (pos_t x=0; x<k_; x++) {
+            if (!visited[x]) order.emplace_back(x);
+        }
+
+        return order;
+    }
+
+    /**
+     * @brief returns the size of the data structure in bytes
+     * @return size of the data structure in bytes
+     */
+    uint64_t size_in_bytes() const {
+        return 2*sizeof(pos_t)+data.size_in_bytes()+pi.size_in_bytes()+sigma.size_in_bytes();
+    }
+
+    /**
+     * @brief returns the number k' of intervals in the move data structure
+     * @return k'
+     */
+    inline pos_t num_intervals() const {
+        return k_;
+    }
+
+    /**
+     * @brief returns whether the move data structure is empty
+     * @return whether the move data structure is empty
+     */
+    inline bool empty() const {
+        return k_ == 0;
+    }
+
+    /**
+     * @brief returns pi[x], the physical index of the logical row x
+     * @param x [0..k_']
+     * @return pi[x]
+     */
+    inline pos_t to_physical(pos_t x) const {
+        return pi.template get<0,pos_t>(x);
+    }
+
+    /**
+     * @brief returns sigma[y], the logical index of the physical row y
+     * @param y [0..k_'-1]
+     * @return sigma[y]
+     */
+    inline pos_t to_logical(pos_t y) const {
+        return sigma.template get<0,pos_t>(y);
+    }
+
+    /**
+     * @brief returns a view of the rows, whose row indices are physical row indices
+     * @return view of the rows
+     */
+    inline physical_rows<> rows() const {
+        return physical_rows<>(this);
+    }
+
+    /**
+     * @brief calls f with a view of the rows, whose row indices are physical row indices and whose widths are
+     *        compile-time constants, if the widths of D_p, D_idx and D_offs are one of the combinations in
+     *        mds_fixed_widths, else with rows()
+     * @param f function that takes a const reference to a move data structure
+     */
+    template <typename fnc_t>
+    inline void with_fixed_widths(fnc_t&& f) const {
+        bool dispatched = false;
+
+        if constexpr (MOVE_R_FIXED_WIDTHS) {
+            // width of L' (in bytes), with which the rows with fixed widths are instantiated
+            constexpr uint8_t w_l_ = [](){if constexpr (has_l_) return sizeof(l_t); else return 0;}();
+
+            for_constexpr<0,mds_fixed_widths.size(),1>([&](auto c){
+                constexpr std::array<uint8_t,3> w = mds_fixed_widths[c];
+
+                if constexpr (std::max({w[0],w[1],w[2]}) <= sizeof(pos_t)) {
+                    if (
+                        !dispatched && data.width(0) == w[0] && data.width(1) == w[1] &&
+                        data.width(2) == w[2] && data.width(5) == w_l_
+                    ) {
+                        dispatched = true;
+                        f(physical_rows<w[0],w[1],w[2],w_l_>(this));
+                    }
+                }
+            });
+        }
+
+        if (!dispatched) f(rows());
+    }
+
+    /**
+     * @brief returns D_p[x]
+     * @param x [0..k_']
+     * @return D_p[x]
+     */
+    inline pos_t p(pos_t x) const {
+        return x == k_ ? n : rows().p(to_physical(x));
+    }
+
+    /**
+     * @brief returns q_x
+     * @param x [0..k_'-1]
+     * @return q_x
+     */
+    inline pos_t q(pos_t x) const {
+        return p(idx(x))+offs(x);
+    }
+
+    /**
+     * @brief returns D_idx[x]
+     * @param x [0..k_'-1]
+     * @return D_idx[x]
+     */
+    inline pos_t idx(pos_t x) const {
+        return to_logical(rows().idx(to_physical(x)));
+    }
+
+    /**
+     * @brief returns D_offs[x]
+     * @param x [0..k_'-1]
+     * @return D_offs[x]
+     */
+    inline pos_t offs(pos_t x) const {
+        return rows().offs(to_physical(x));
+    }
+
+    /**
+     * @brief returns L'[x]
+     * @param x [0..k_'-1]
+     * @return L'[x]
+     */
+    inline l_t L_(pos_t x) const requires(has_l_) {
+        return rows().L_(to_physical(x));
+    }
+
+    /**
+     * @brief calculates the move query Move(I,i,x) = (i',x') by changing (i,x)
+     *        to (i',x'), with i' = f_I(i) and i' in [p_x', p_x' + d_x')
+     * @param i [0..n-1]
+     * @param x [0..k_'-1], where i in [p_x, p_x + d_x)
+     */
+    inline void move(pos_t& i, pos_t& x) const {
+        x = to_physical(x);
+        rows().move(i,x);
+        x = to_logical(x);
+    }
+
+    /**
+     * @brief performs the move query Move(I,i,x) = (i',x') by changing ix = (i,x) to
+     *        (i',x'), with i' = f_I(i) and i' in [p_x', p_x' + d_x') and returns (i',x')
+     * @param ix (i,x), where i in [0..n-1] and i in [p_x, p_x + d_x)
+     * @return (i',x')
+     */
+    inline pair_t move(pair_t ix) const {
+        move(ix.first,ix.second);
+        return ix;
+    }
+
+    /**
+     * @brief serializes the move data structure to an output stream
+     * @param out output stream
+     */
+    void serialize(std::ostream& out) const {
+        out.write((char*)&n,sizeof(pos_t));
+        out.write((char*)&k_,sizeof(pos_t));
+        data.serialize(out);
+        pi.serialize(out);
+        sigma.serialize(out);
+    }
+
+    /**
+     * @brief loads the move data structure from an input stream
+     * @param in input stream
+     */
+    void load(std::istream& in) {
+        in.read((char*)&n,sizeof(pos_t));
+        in.read((char*)&k_,sizeof(pos_t));
+        data.load(in);
+        pi.load(in);
+        sigma.load(in);
+    }
+
+    std::ostream& operator>>(std::ostream& os) const {
+        serialize(os);
+        return os;
+    }
+
+    std::istream& operator<<(std::istream& is) {
+        load(is);
+        return is;
+    }
+};
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <memory>
+#include <thread>
+#include <vector>
+#include <sched.h>
+
+#include <move_r/misc/huge_page_allocator.hpp>
+
+/**
+ * @brief returns the CPUs of a NUMA node (all CPUs, if they cannot be determined)
+ * @param node NUMA node
+ * @return the CPUs of the NUMA node
+ */
+inline std::vector<uint16_t> numa_node_cpus(uint16_t node) {
+    // the file contains the CPUs of the node as ranges, e.g. "0-15,32-47"
+    std::ifstream cpulist("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+    std::string list;
+    std::vector<uint16_t> cpus;
+
+    if (cpulist.good() && std::getline(cpulist,list)) {
+        uint16_t first = 0;
+        uint16_t cur = 0;
+        bool in_range = false;
+        list.push_back(',');
+
+        for (char c : list) {
+            if ('0' <= c && c <= '9') {
+                cur = 10*cur+(c-'0');
+            } else if (c == '-') {
+                first = cur;
+                cur = 0;
+                in_range = true;
+            } else if (c == ',') {
+                for (uint16_t cpu=(in_range ? first : cur); cpu<=cur; cpu++) cpus.push_back(cpu);
+                cur = 0;
+                in_range = false;
+            }
+        }
+    }
+
+    if (cpus.empty()) {
+        for (uint16_t cpu=0; cpu<std::thread::hardware_concurrency(); cpu++) cpus.push_back(cpu);
+    }
+
+    return cpus;
+}
+
+/**
+ * @brief restricts the calling thread to the CPUs of a NUMA node
+ * @param node NUMA node
+ * @return whether the thread has been restricted to the CPUs of the node
+ */
+inline bool pin_to_numa_node(uint16_t node) {
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    for (uint16_t cpu : numa_node_cpus(node)) CPU_SET(cpu,&cpu_set);
+    return sched_setaffinity(0,sizeof(cpu_set_t),&cpu_set) == 0;
+}
+
+/**
+ * @brief returns the NUMA node the calling thread is currently running on (0, if it cannot be determined)
+ * @return NUMA node of the calling thread
+ */
+inline uint16_t current_numa_node() {
+#ifdef SYS_getcpu
+    unsigned cpu,node;
+    if (syscall(SYS_getcpu,&cpu,&node,NULL) == 0) return node;
+#endif
+    return 0;
+}
+
+/**
+ * @brief stores one replica of an index in the memory of each NUMA node, so threads can answer queries with the
+ *        replica on their own node instead of paying remote-memory latency on every access
+ * @tparam index_t index type (e.g. move_r<>)
+ */
+template <typename index_t>
+class numa_replicated {
+    // [0..num_replicas-1] replicas of the index; replicas[v] is stored in the memory of NUMA node v
+    std::vector<std::unique_ptr<index_t>> replicas;
+
+    /**
+     * @brief creates the replicas with create(v) on threads running on the NUMA nodes v = 0, ..., num_replicas-1;
+     *        the arrays of replica v that are allocated with huge_page_allocator are bound to node v, the others
+     *        are placed on node v when they are first touched
+     * @param num_replicas number of replicas
+     * @param create function that returns a new replica
+     */
+    template <typename fnc_t>
+    void create_replicas(uint16_t num_replicas, fnc_t&& create) {
+        for (uint16_t v=0; v<num_replicas; v++) {
+            // the allocation policy is global, so the replicas are created one after another
+            std::thread([&](){
+                pin_to_numa_node(v);
+                alloc_policy policy = current_alloc_policy();
+                policy.numa = _numa_bind;
+                policy.node = v;
+                alloc_policy_scope scope(policy);
+                replicas.emplace_back(create());
+            }).join();
+        }
+    }
+
+    public:
+    numa_replicated() = default;
+
+    /**
+     * @brief copies an index into the memory of each NUMA node
+     * @param index the index
+     * @param num_replicas number of replicas (default: number of NUMA nodes)
+     */
+    numa_replicated(const index_t& index, uint16_t num_replicas = num_numa_nodes()) {
+        create_replicas(num_replicas,[&](){return std::make_unique<index_t>(index);});
+    }
+
+    /**
+     * @brief loads an index into the memory of each NUMA node
+     * @param in input stream, from which the index is loaded once per replica
+     * @param num_replicas number of replicas (default: number of NUMA nodes)
+     */
+    numa_replicated(std::istream& in, uint16_t num_replicas = num_numa_nodes()) {
+        std::streampos pos = in.tellg();
+
+        create_replicas(num_replicas,[&](){
+            in.seekg(pos);
+            std::unique_ptr<index_t> replica = std::make_unique<index_t>();
+            replica->load(in);
+            return replica;
+        });
+    }
+
+    /**
+     * @brief returns the number of replicas
+     * @return number of replicas
+     */
+    inline uint16_t num_replicas() const {
+        return replicas.size();
+    }
+
+    /**
+     * @brief returns the replica stored in the memory of a NUMA node
+     * @param node NUMA node in [0..num_replicas()-1]
+     * @return the replica on the NUMA node
+     */
+    inline const index_t& replica(uint16_t node) const {
+        return *replicas[node];
+    }
+
+    /**
+     * @brief returns the replica stored in the memory of the NUMA node the calling thread is running on (threads
+     *        should be pinned to a node, e.g. with pin_to_numa_node(), so they do not migrate to another node)
+     * @return the replica on the NUMA node of the calling thread
+     */
+    inline const index_t& local() const {
+        return *replicas[current_numa_node() % replicas.size()];
+    }
+
+    /**
+     * @brief returns the size of all replicas in bytes
+     * @return size of all replicas in bytes
+     */
+    uint64_t size_in_bytes() const {
+        uint64_t size = 0;
+        for (const std::unique_ptr<index_t>& replica : replicas) size += replica->size_in_bytes();
+        return size;
+    }
+};
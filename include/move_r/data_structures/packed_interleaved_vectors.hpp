@@ -0,0 +1,266 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <iostream>
+#include <cstring>
+
+#include <move_r/misc/utils.hpp>
+#include <move_r/misc/huge_page_allocator.hpp>
+
+/**
+ * @brief variable-width interleaved vectors with bit-granular widths; the entries are packed without padding, so
+ *        an entry of a vector is read with one unaligned 64-bit load, a shift and a mask
+ * @tparam val_t unsigned integer type of the stored values
+ * @tparam pos_t unsigned integer type
+ * @tparam num_vectors number of interleaved vectors
+ */
+template <typename val_t, typename pos_t = uint32_t, uint8_t num_vectors = 8>
+class packed_interleaved_vectors {
+    static_assert(std::is_same_v<pos_t,uint32_t> || std::is_same_v<pos_t,uint64_t>);
+
+    static_assert(
+        std::is_same_v<val_t,uint8_t> ||
+        std::is_same_v<val_t,uint16_t> ||
+        std::is_same_v<val_t,uint32_t> ||
+        std::is_same_v<val_t,uint64_t>
+    );
+
+    static_assert(num_vectors > 0);
+
+    protected:
+    uint64_t size_vectors = 0; // size of each stored vector
+    uint64_t width_entry = 0; // sum of the widths (in bits) of all vectors
+
+    /* [0..ceil(size_vectors*width_entry/8)+7] bytes storing the packed entries; the last 8 bytes are padding, such
+    that the last entry can be read with a 64-bit load, too */
+    std::vector<char,huge_page_allocator<char>> data_vectors;
+
+    // [0..num_vectors-1] widths (in bits) of the stored vectors; widths[i] = width of vector i
+    std::array<uint8_t,num_vectors> widths;
+
+    // [0..num_vectors-1] offsets (in bits) of the vectors inside of an entry
+    std::array<uint16_t,num_vectors> offsets;
+
+    // [0..num_vectors-1] masks that are used to mask off data of other entries when accessing a vector
+    std::array<uint64_t,num_vectors> masks;
+
+    /**
+     * @brief initializes the packed interleaved vectors with the vector-widths stored in widths
+     * @param widths vector containing the widths (in bits) of the interleaved arrays (at most 64 each)
+     */
+    void initialize(std::array<uint8_t,num_vectors> widths) {
+        size_vectors = 0;
+        width_entry = 0;
+
+        for (uint8_t i=0; i<num_vectors; i++) {
+            this->widths[i] = std::min<uint8_t>(64,widths[i]);
+            offsets[i] = width_entry;
+            width_entry += this->widths[i];
+            masks[i] = this->widths[i] == 64 ? std::numeric_limits<uint64_t>::max() : (uint64_t{1} << this->widths[i])-1;
+        }
+
+        data_vectors.clear();
+        data_vectors.resize(8,0);
+        data_vectors.shrink_to_fit();
+    }
+
+    public:
+    packed_interleaved_vectors() {initialize({});}
+    packed_interleaved_vectors(packed_interleaved_vectors&& other) = default;
+    packed_interleaved_vectors(const packed_interleaved_vectors& other) = default;
+    packed_interleaved_vectors& operator=(packed_interleaved_vectors&& other) = default;
+    packed_interleaved_vectors& operator=(const packed_interleaved_vectors& other) = default;
+
+    /**
+     * @brief Construct new packed interleaved vectors
+     * @param widths vector containing the widths (in bits) of the interleaved arrays (at most 64 each)
+     */
+    packed_interleaved_vectors(std::array<uint8_t,num_vectors> widths) {
+        initialize(widths);
+    }
+
+    /**
+     * @brief returns the size of each stored vector
+     * @return the size of each stored vector
+     */
+    inline uint64_t size() const {
+        return size_vectors;
+    }
+
+    /**
+     * @brief returns whether the interleaved vectors are empty
+     * @return whether the interleaved vectors are empty
+     */
+    inline bool empty() const {
+        return size_vectors == 0;
+    }
+
+    /**
+     * @brief returns the size of the data structure in bytes
+     * @return size of the data structure in bytes
+     */
+    uint64_t size_in_bytes() const {
+        return
+            2*sizeof(uint64_t)+ // variables
+            num_vectors*(1+sizeof(uint16_t)+sizeof(uint64_t))+ // widths, offsets and masks
+            data_vectors.size(); // data_vectors
+    }
+
+    /**
+     * @brief returns the total width (number of bits) per entry, that is the sum of all widths
+     * @return number of bits per entry
+     */
+    inline uint64_t bits_per_entry() const {
+        return width_entry;
+    }
+
+    /**
+     * @brief returns the width in bits of the vector with index vec
+     * @param vec vector index
+     * @return its width in bits
+     */
+    inline uint8_t width(uint8_t vec) const {
+        return widths[vec];
+    }
+
+    /**
+     * @brief returns a pointer to the data of the packed interleaved vectors
+     * @return pointer to the data of the packed interleaved vectors
+     */
+    inline const char* data() const {
+        return data_vectors.data();
+    }
+
+    /**
+     * @brief resizes all stored vectors to size and initializes new entries to 0
+     * @param size size
+     */
+    void resize(uint64_t size) {
+        if (size < size_vectors) {
+            // clear the bits of the removed entries, because set() does not overwrite the bits of other entries
+            uint64_t num_bits = size*width_entry;
+
+            if (num_bits % 8 != 0) {
+                data_vectors[num_bits/8] &= (char)((1 << (num_bits % 8))-1);
+            }
+
+            for (uint64_t byte=(num_bits+7)/8; byte<data_vectors.size(); byte++) {
+                data_vectors[byte] = 0;
+            }
+        }
+
+        data_vectors.resize((size*width_entry+7)/8+8,0);
+        size_vectors = size;
+    }
+
+    /**
+     * @brief resizes all stored vectors to size 0
+     */
+    inline void clear() {
+        resize(0);
+    }
+
+    /**
+     * @brief shrinks all stored vectors to their size
+     */
+    void shrink_to_fit() {
+        data_vectors.shrink_to_fit();
+    }
+
+    /**
+     * @brief sets the i-th entry in the vector with index vec to v; only the bytes overlapping the entry are written,
+     *        so concurrent calls are safe if they write to different blocks of 8 consecutive entries
+     * @tparam vec vector index (0 <= vec < num_vectors)
+     * @param i entry index (0 <= i < size_vectors)
+     * @param v value to store (only the lowest width(vec) bits are stored)
+     */
+    template <uint8_t vec, typename T = val_t>
+    inline void set(pos_t i, T v) {
+        static_assert(vec < num_vectors);
+
+        uint64_t pos = i*width_entry+offsets[vec];
+        char* base = &data_vectors[pos/8];
+        uint8_t shift = pos%8;
+        uint8_t num_bytes = (shift+widths[vec]+7)/8;
+        uint64_t val = (uint64_t)v & masks[vec];
+
+        uint64_t word = 0;
+        std::memcpy(&word,base,std::min<uint8_t>(8,num_bytes));
+        word = (word & ~(masks[vec] << shift)) | (val << shift);
+        std::memcpy(base,&word,std::min<uint8_t>(8,num_bytes));
+
+        // a 64-bit entry that does not start at a byte boundary overlaps 9 bytes
+        if (num_bytes > 8) {
+            base[8] = (base[8] & ~(masks[vec] >> (64-shift))) | (val >> (64-shift));
+        }
+    }
+
+    /**
+     * @brief returns the i-th entry in the vector with index vec
+     * @tparam vec vector index (0 <= vec < num_vectors)
+     * @param i entry index (0 <= i < size_vectors)
+     * @return value
+     */
+    template <uint8_t vec, typename T = val_t>
+    inline T get(pos_t i) const {
+        static_assert(vec < num_vectors);
+
+        uint64_t pos = i*width_entry+offsets[vec];
+        uint8_t shift = pos%8;
+        uint64_t word;
+        std::memcpy(&word,&data_vectors[pos/8],8);
+        word >>= shift;
+
+        if constexpr (sizeof(val_t) == 8) {
+            // a 64-bit entry that does not start at a byte boundary overlaps 9 bytes
+            if (shift+widths[vec] > 64) {
+                word |= uint64_t{(uint8_t)data_vectors[pos/8+8]} << (64-shift);
+            }
+        }
+
+        return word & masks[vec];
+    }
+
+    /**
+     * @brief prefetches the cache line containing the i-th entry (of all vectors) into the cache
+     * @param i entry index (0 <= i < size_vectors)
+     */
+    inline void prefetch(pos_t i) const {
+        __builtin_prefetch(&data_vectors[(i*width_entry)/8]);
+    }
+
+    /**
+     * @brief serializes the packed interleaved vectors to an output stream
+     * @param out output stream
+     */
+    void serialize(std::ostream& out) const {
+        out.write((char*)&size_vectors,sizeof(uint64_t));
+        out.write((char*)&widths[0],num_vectors);
+        write_to_file(out,data_vectors.data(),data_vectors.size());
+    }
+
+    /**
+     * @brief loads the packed interleaved vectors from an input stream
+     * @param in input stream
+     */
+    void load(std::istream& in) {
+        uint64_t size;
+        std::array<uint8_t,num_vectors> widths;
+        in.read((char*)&size,sizeof(uint64_t));
+        in.read((char*)&widths[0],num_vectors);
+        initialize(widths);
+        resize(size);
+        read_from_file(in,data_vectors.data(),data_vectors.size());
+    }
+
+    std::ostream& operator>>(std::ostream& os) const {
+        serialize(os);
+        return os;
+    }
+
+    std::istream& operator<<(std::istream& is) {
+        load(is);
+        return is;
+    }
+};
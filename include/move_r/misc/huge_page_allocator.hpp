@@ -0,0 +1,218 @@
+#pragma once
+
+#include <cstdint>
+#include <algorithm>
+#include <array>
+#include <new>
+#include <fstream>
+#include <string>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/**
+ * @brief policy for placing the pages of large arrays on NUMA nodes
+ */
+enum numa_policy : uint8_t {
+    _numa_default = 0, // the kernel's default policy (pages are placed on the node of the thread touching them first)
+    _numa_interleave = 1, // interleave the pages round-robin across all NUMA nodes
+    _numa_bind = 2 // place all pages on one NUMA node
+};
+
+// controls, whether large arrays are backed by transparent huge pages by default (can be set at compile time, e.g. with -DMOVE_R_HUGE_PAGES=true)
+#ifndef MOVE_R_HUGE_PAGES
+#define MOVE_R_HUGE_PAGES false
+#endif
+
+// NUMA policy that is used for large arrays by default (can be set at compile time, e.g. with -DMOVE_R_NUMA_POLICY=_numa_interleave)
+#ifndef MOVE_R_NUMA_POLICY
+#define MOVE_R_NUMA_POLICY _numa_default
+#endif
+
+/**
+ * @brief allocation policy for the large arrays of the index (the data of interleaved vectors)
+ */
+struct alloc_policy {
+    bool huge_pages = MOVE_R_HUGE_PAGES; // back the arrays with 2 MB transparent huge pages (madvise(MADV_HUGEPAGE))
+    numa_policy numa = MOVE_R_NUMA_POLICY; // placement of the pages on the NUMA nodes
+    uint16_t node = 0; // NUMA node to place the pages on (only if numa = _numa_bind)
+};
+
+// size of a transparent huge page; arrays of at least this size are allocated according to the allocation policy
+static constexpr uint64_t huge_page_size = uint64_t{1} << 21;
+
+/**
+ * @brief returns the allocation policy that is currently used for allocating large arrays
+ * @return the current allocation policy
+ */
+inline alloc_policy& current_alloc_policy() {
+    static alloc_policy policy;
+    return policy;
+}
+
+/**
+ * @brief sets the allocation policy that is used for allocating large arrays (it applies to all arrays that are
+ *        allocated afterwards, e.g. while building or loading an index)
+ * @param policy allocation policy
+ */
+inline void set_alloc_policy(alloc_policy policy) {
+    current_alloc_policy() = policy;
+}
+
+/**
+ * @brief sets an allocation policy for the lifetime of the object and restores the previous one afterwards
+ */
+class alloc_policy_scope {
+    alloc_policy previous; // allocation policy before the object was created
+
+    public:
+    /**
+     * @brief sets policy as the current allocation policy
+     * @param policy allocation policy
+     */
+    alloc_policy_scope(alloc_policy policy) : previous(current_alloc_policy()) {
+        set_alloc_policy(policy);
+    }
+
+    ~alloc_policy_scope() {
+        set_alloc_policy(previous);
+    }
+
+    alloc_policy_scope(const alloc_policy_scope&) = delete;
+    alloc_policy_scope& operator=(const alloc_policy_scope&) = delete;
+};
+
+/**
+ * @brief returns the number of NUMA nodes of the system (1, if it cannot be determined)
+ * @return number of NUMA nodes
+ */
+inline uint16_t num_numa_nodes() {
+    // the file contains the online nodes as ranges, e.g. "0-1" or "0,2-3"
+    std::ifstream online("/sys/devices/system/node/online");
+    std::string nodes;
+    if (!online.good() || !std::getline(online,nodes)) return 1;
+    uint16_t max_node = 0;
+    uint16_t cur = 0;
+
+    for (char c : nodes) {
+        if ('0' <= c && c <= '9') {
+            cur = 10*cur+(c-'0');
+        } else {
+            max_node = std::max(max_node,cur);
+            cur = 0;
+        }
+    }
+
+    return std::max(max_node,cur)+1;
+}
+
+/**
+ * @brief applies the allocation policy policy to the memory [addr,addr+size) (the policy is only a hint, so failing
+ *        system calls are ignored)
+ * @param addr address of the memory (must be aligned to the page size)
+ * @param size size of the memory in bytes
+ * @param policy allocation policy
+ */
+inline void apply_alloc_policy(void* addr, uint64_t size, alloc_policy policy) {
+#ifdef MADV_HUGEPAGE
+    if (policy.huge_pages) madvise(addr,size,MADV_HUGEPAGE);
+#endif
+
+#ifdef SYS_mbind
+    if (policy.numa != _numa_default) {
+        static constexpr int mpol_bind = 2;
+        static constexpr int mpol_interleave = 3;
+        static constexpr unsigned mpol_mf_move = 1 << 1;
+        std::array<unsigned long,16> node_mask {};
+
+        if (policy.numa == _numa_bind) {
+            node_mask[policy.node/64] |= 1UL << (policy.node%64);
+        } else {
+            uint16_t num_nodes = std::min<uint16_t>(num_numa_nodes(),64*node_mask.size());
+            for (uint16_t node=0; node<num_nodes; node++) node_mask[node/64] |= 1UL << (node%64);
+        }
+
+        // pages that have already been touched (e.g. if the memory is reused by malloc) are moved
+        syscall(SYS_mbind,addr,size,policy.numa == _numa_bind ? mpol_bind : mpol_interleave,
+            node_mask.data(),64*node_mask.size(),mpol_mf_move);
+    }
+#endif
+}
+
+/**
+ * @brief allocator for the large arrays of the index; allocations of at least huge_page_size bytes are aligned to
+ *        huge_page_size and placed according to the current allocation policy (smaller ones are passed to
+ *        operator new); like default_init_allocator, it does not initialize values on resize()
+ * @tparam T value type
+ */
+template <typename T>
+class huge_page_allocator {
+    static constexpr uint64_t header_size = 16; // bytes before the returned memory storing the allocated address
+
+    public:
+    using value_type = T;
+
+    huge_page_allocator() noexcept = default;
+
+    template <typename U>
+    huge_page_allocator(const huge_page_allocator<U>&) noexcept {}
+
+    /**
+     * @brief allocates memory for n values of type T
+     * @param n number of values
+     * @return pointer to the memory
+     */
+    T* allocate(size_t n) {
+        uint64_t size = n*sizeof(T);
+        if (size < huge_page_size) return static_cast<T*>(::operator new(size));
+        const alloc_policy& policy = current_alloc_policy();
+        char* mem;
+        char* data;
+
+        /* large arrays are still allocated with operator new (so they are counted by malloc_count); the address
+        returned by operator new is stored in front of the returned memory, because deallocate() cannot know the
+        policy that was used for allocating it */
+        if (!policy.huge_pages && policy.numa == _numa_default) {
+            mem = static_cast<char*>(::operator new(size+header_size));
+            data = mem+header_size;
+        } else {
+            uint64_t page_size = sysconf(_SC_PAGE_SIZE);
+            mem = static_cast<char*>(::operator new(size+huge_page_size+header_size+page_size));
+            data = reinterpret_cast<char*>(
+                ((reinterpret_cast<uintptr_t>(mem)+header_size+huge_page_size-1)/huge_page_size)*huge_page_size);
+            apply_alloc_policy(data,((size+page_size-1)/page_size)*page_size,policy);
+        }
+
+        reinterpret_cast<char**>(data)[-1] = mem;
+        return reinterpret_cast<T*>(data);
+    }
+
+    /**
+     * @brief frees memory that has been allocated with allocate(n)
+     * @param ptr pointer to the memory
+     * @param n number of values
+     */
+    void deallocate(T* ptr, size_t n) noexcept {
+        if (n*sizeof(T) < huge_page_size) {
+            ::operator delete(ptr);
+        } else {
+            ::operator delete(reinterpret_cast<char**>(ptr)[-1]);
+        }
+    }
+
+    template <typename U>
+    void construct(U* ptr) noexcept(std::is_nothrow_default_constructible<U>::value) {
+        ::new(static_cast<void*>(ptr)) U;
+    }
+
+    template <typename U, typename... Args>
+    void construct(U* ptr, Args&&... args) {
+        ::new(static_cast<void*>(ptr)) U(std::forward<Args>(args)...);
+    }
+
+    template <typename U>
+    bool operator==(const huge_page_allocator<U>&) const noexcept {return true;}
+
+    template <typename U>
+    bool operator!=(const huge_page_allocator<U>&) const noexcept {return false;}
+};
@@ -2,13 +2,20 @@
 
 #include <iostream>
 #include <type_traits>
+#include <span>
+#include <bit>
+#include <stdexcept>
 #include <omp.h>
 #include <move_r/misc/utils.hpp>
 #include <move_r/data_structures/rank_select_support.hpp>
 #include <move_r/data_structures/interleaved_vectors.hpp>
 #include <move_r/data_structures/move_data_structure/move_data_structure.hpp>
 #include <move_r/data_structures/move_data_structure/move_data_structure_l_.hpp>
+#include <move_r/data_structures/move_data_structure/move_data_structure_packed.hpp>
+#include <move_r/data_structures/move_data_structure/move_data_structure_reordered.hpp>
+#include <move_r/data_structures/numa_replicated.hpp>
 #include <tsl/sparse_map.h>
+#include <sdsl/rmq_support.hpp>
 
 /**
  * @brief type of locate support
@@ -17,9 +24,19 @@ enum move_r_support {
     _count, // only count support (no locate support)
     _locate_one, // support for computing exaclty one occurrence per pattern
     _locate_move, // locate support is implemented using a move data structure to answer Phi^{-1}-queries
-    _locate_rlzdsa // locate support is implemented by relative lepel-ziv encoding the differential suffix array
+    _locate_rlzdsa, // locate support is implemented by relative lepel-ziv encoding the differential suffix array
+    /* like _locate_move, but additionally stores a move data structure to answer Phi-queries, s.t. the occurrences
+       can be decoded from both ends of the suffix array interval at once (appended after _locate_rlzdsa, because the
+       value is serialized, so indexes built before it was added can still be loaded) */
+    _locate_move_bi
 };
 
+// default maximum distance to scan over L' in a backward search step (can be set at compile time, e.g. with
+// -DMOVE_R_MAX_SCAN_L_=64, and changed at runtime with move_r::set_max_scan_l_length())
+#ifndef MOVE_R_MAX_SCAN_L_
+#define MOVE_R_MAX_SCAN_L_ 128
+#endif
+
 /**
  * @brief move-r construction mode
  */
@@ -44,11 +61,36 @@ struct move_r_params {
     std::ostream* mf_idx = NULL; // measurement file for the index construciton
     std::ostream* mf_mds = NULL; // measurement file for the move data structure construction
     std::string name_text_file = ""; // name of the input file (used only for measurement output)
+    /* controls, whether to also build M_LF and RS_L' of the reversed input, which enables extending patterns to the
+       right with query_context::append(); roughly doubles the construction time and the size of M_LF and RS_L' */
+    bool bidirectional = false;
+    /* sample rate of the text position samples used by extract(l,r); one sample is stored every sample_rate_isa
+       text positions, such that extract(l,r) performs at most r-l+sample_rate_isa LF steps; 0 = no samples */
+    uint64_t sample_rate_isa = 0;
+    /* sample rate of the suffix array samples used by SA(i) (only for _locate_move and _locate_move_bi); one sample
+       is stored every sample_rate_sa suffix array positions, such that SA(i) performs less than sample_rate_sa
+       Phi^{-1} move queries; 0 = no samples */
+    uint64_t sample_rate_sa = 0;
+    /* controls, whether to also build the PLCP samples (the O(r) irreducible PLCP values), which enable LCP(i) and
+       lcp_range(b,e); they can be built in the suffix array construction modes and when constructing from a suffix
+       array and a bwt (then, T is restored from them temporarily); with Big-BWT, build_lcp is ignored (a warning
+       is logged, if log = true) */
+    bool build_lcp = false;
+    /* controls, whether to also build the thresholds (one per bwt run), which enable matching_statistics() and
+       maximal_exact_matches() (only for _locate_move, _locate_move_bi and _locate_rlzdsa); they are computed from the
+       suffix array and the input in the suffix array construction modes and when constructing from a suffix array and
+       a bwt (then, T is restored from them temporarily); with Big-BWT, they are computed from the index after the
+       construction (see build_thresholds()) */
+    bool build_thresholds = false;
+    /* starting positions of the documents in the input (see build_document_array()); if not empty, the document
+       array is built, and for _locate_move, _locate_move_bi and _locate_rlzdsa the ILCP runs are computed from the
+       suffix array while it is in memory (with Big-BWT, they are computed from the index after the construction) */
+    std::vector<uint64_t> doc_starts = {};
 };
 
 /**
  * @brief move-r index, size O(r*(a/(a-1)))
- * @tparam support type of locate support (_locate_move or _locate_rlzdsa)
+ * @tparam support type of locate support (_locate_move, _locate_move_bi or _locate_rlzdsa)
  * @tparam sym_t value type (default: char for strings)
  * @tparam pos_t index integer type (use uint32_t if input size < UINT_MAX, else uint64_t)
  */
@@ -86,6 +128,10 @@ class move_r {
     static constexpr bool supports_locate = support != _count; // true <=> the index supports locate
     // true <=> the index supports locating multiple occurrences
     static constexpr bool supports_multiple_locate = supports_locate && support != _locate_one;
+    // true <=> suffix array values are decoded with M_Phi^{-1}
+    static constexpr bool uses_m_phi_m1 = support == _locate_move || support == _locate_move_bi;
+    // true <=> the index also stores M_Phi to decode suffix array values from right to left
+    static constexpr bool uses_m_phi = support == _locate_move_bi;
     static constexpr bool str_input = std::is_same_v<sym_t,char>; // true <=> the input is a string
     static constexpr bool int_input = !str_input; // true <=> the input is an iteger vector
     static constexpr bool byte_alphabet = sizeof(sym_t) == 1; // true <=> the input uses a byte alphabet
@@ -95,12 +141,43 @@ class move_r {
     using map_ext_t = std::vector<sym_t>; // type of map_ext
     using inp_t = std::conditional_t<str_input,std::string,std::vector<sym_t>>; // input container type
     using rsl_t = rank_select_support<i_sym_t,pos_t,true,true>; // type of RS_L'
+    // type of M_Phi^{-1} and M_Phi (bit-packed if MOVE_R_PACKED_PHI = true)
+    using mds_phi_t = std::conditional_t<MOVE_R_PACKED_PHI,move_data_structure_packed<pos_t>,move_data_structure<pos_t>>;
+
+    // type of locate support of the index of the reversed input (only one sample per bwt run is needed for append())
+    static constexpr move_r_support support_rev = supports_locate ? _locate_one : _count;
+
+    // the index of the reversed input is built as a move_r object, whiches data structures are then taken over
+    template <move_r_support, typename, typename> friend class move_r;
 
     // sample rate of the copy phrases in the rlzdsa
     static constexpr pos_t sr_scp = 4;
 
-    // maximum distance to scan over L' to find the first and last occurrences of sym in L'[\hat{b},\hat{e}]
-    static constexpr pos_t max_scan_l_ = 128;
+    // number of backward searches that are interleaved by the batched query methods
+    static constexpr uint16_t batch_width = 16;
+
+    // minimum number of suffix array intervals per thread, whiches subtrees are searched in parallel by kmers()
+    static constexpr uint64_t min_kmer_tasks_per_thread = 16;
+
+    // size of the per-thread buffers of kmers(k,file_name,params) in bytes
+    static constexpr uint64_t kmer_buf_size = 1 << 20;
+
+    // minimum number of occurrences to decode per thread in locate(P,Occ,num_threads)
+    static constexpr pos_t min_occ_par_locate = 16384;
+
+    // number of bits per digit of the radix sort in locate_sorted()
+    static constexpr uint8_t radix_bits_locate_sorted = 8;
+
+    // minimum number of occurrences to sort with a radix sort in locate_sorted() (fewer occurrences are sorted with std::sort)
+    static constexpr pos_t min_occ_radix_sort = 64;
+
+    /* the documents of the occurrences of a pattern are counted in a [0..d-1] array (instead of being sorted), if there
+       are at least d/max_docs_per_occ_dense occurrences, where d is the number of documents (only in
+       count_per_document() and top_k_documents(), and in list_documents(), if the ILCP runs are not built) */
+    static constexpr pos_t max_docs_per_occ_dense = 16;
+
+    // number of search tree levels of approximate_matches(), in which the branches are explored in separate tasks
+    static constexpr uint8_t max_task_depth_approx = 4;
 
     // ############################# INDEX VARIABLES #############################
 
@@ -109,6 +186,7 @@ class move_r {
     pos_t r = 0; // r, the number of runs in L
     pos_t r_ = 0; // r', the number of input/output intervals in M_LF
     pos_t r__ = 0; // r'', the number of input/output intervals in M_Phi^{-1}
+    pos_t r___ = 0; // r''', the number of input/output intervals in M_Phi
     pos_t z = 0; // z, the number of phrases in the rlzdsa
     pos_t z_l = 0; // z_l, the number of literal phrases in the rlzdsa
     pos_t z_c = 0; // z_c, the number of copy-phrases in the rlzdsa
@@ -121,6 +199,15 @@ class move_r {
     bool symbols_remapped = false;
     uint64_t size_map_int = 0; // size of _map_int (for byte_alphabet = false)
 
+    /* maximum distance to scan over L' to find the first and last occurrences of sym in L'[\hat{b},\hat{e}]
+       (not serialized, because it only affects the query performance) */
+    pos_t max_scan_l_ = MOVE_R_MAX_SCAN_L_;
+
+    bool bidirectional = false; // true <=> the index also stores M_LF^rev and RS_L'^rev (and SA_s^rev)
+    pos_t r_rev = 0; // r'^rev, the number of input/output intervals in M_LF^rev
+    pos_t sr_isa = 0; // sample rate of the text position samples (ISA_s); 0 <=> ISA_s is not built
+    pos_t sr_sa = 0; // sample rate of the suffix array samples (SA_sr); 0 <=> SA_sr is not built
+
     // ############################# INDEX DATA STRUCTURES #############################
 
     // mapping function from the alphabet of the input to the internal effective alphabet
@@ -135,16 +222,28 @@ class move_r {
     rsl_t _RS_L_;
 
     // The Move Data Structure for Phi^{-1}.
-    move_data_structure<pos_t> _M_Phi_m1;
+    mds_phi_t _M_Phi_m1;
     // [0..r'-1] stores at position x the index of the output interval of M_Phi^{-1} that starts with SA_s[x] = SA[M_LF.p[x]]
     interleaved_vectors<pos_t,pos_t> _SA_Phi_m1;
 
+    // The Move Data Structure for Phi; only built for _locate_move_bi
+    mds_phi_t _M_Phi;
+    /* [0..r'-1] stores at position x the index of the output interval of M_Phi that starts with SA_e[x] = SA[M_LF.p[x+1]-1],
+    or r''' if M_LF.p[x+1]-1 is not an end position of a bwt run; only built for _locate_move_bi */
+    interleaved_vectors<pos_t,pos_t> _SA_Phi;
+
     /* [0..p_r-1], where D_e[i] = <x,j>, where x in [0,r'-1] and j is minimal, s.t. SA_s[x]=j > i* lfloor (n-1)/p rfloor;
     see the parallel revert algorithm to understand why this is useful. */
     std::vector<std::pair<pos_t,pos_t>> _D_e;
 
     // stores the suffix array values at the starting positions of the input intervals of M_LF, i.e, SA_s[i] = SA[M_LF.p[i]]
     interleaved_vectors<pos_t,pos_t> _SA_s;
+    /* [0..r'-1] stores at position x the threshold t_x of the x-th input interval in M_LF, if it starts a bwt run; if
+    e is the end position of the previous bwt run with the same symbol, then t_x in [e+1,M_LF.p[x]] is a position with
+    LCP[t_x] = min(LCP[e+1..M_LF.p[x]]) (t_x = 0, if there is no such run); for _locate_move and _locate_rlzdsa, it also
+    stores SA[M_LF.p[x+1]-1] at position x, if the x-th input interval ends a bwt run (for _locate_move_bi, this is
+    SA_e[x]); empty <=> the thresholds are not built */
+    interleaved_vectors<pos_t,pos_t> _THR;
     // reference for SA^d (differential suffix array)
     interleaved_vectors<uint64_t,pos_t> _R;
     // bit vector storing the phrase types of the rlzdsa, i.e, PT[i] = 1 <=> phrase i is literal
@@ -157,6 +256,50 @@ class move_r {
     interleaved_vectors<pos_t,pos_t> _SR;
     // literal phrases of the rlzdsa
     interleaved_vectors<pos_t,pos_t> _LP;
+
+    // The Move Data Structure for LF of the reversed input (including L'^rev); only built if bidirectional = true
+    move_data_structure_l_<pos_t,i_sym_t> _M_LF_rev;
+    // rank-select data structure for L'^rev
+    rsl_t _RS_L__rev;
+    // suffix array samples of the reversed input at the starting positions of the input intervals of M_LF^rev
+    interleaved_vectors<pos_t,pos_t> _SA_s_rev;
+
+    /* [0..(n-2)/sr_isa], stores at position k the pair <i,x>, where i is the position in the bwt with L[i] = T[j_k],
+    j_k = min((k+1)*sr_isa-1,n-2), and x is the index of the input interval in M_LF containing i */
+    interleaved_vectors<pos_t,pos_t> _ISA_s;
+
+    /* [0..(n-1)/sr_sa], stores at position k the pair <SA[k*sr_sa],s'>, where s' is the index of the input interval
+    in M_Phi^{-1} containing SA[k*sr_sa]; only built for _locate_move and _locate_move_bi */
+    interleaved_vectors<pos_t,pos_t> _SA_sr;
+
+    /* compressed bit vector of length n-1 marking the starting positions of the documents in the input, i.e., the
+    runs of the document array in text order; empty <=> the document array is not built */
+    sd_array<pos_t> _DS;
+
+    /* compressed bit vector of length n marking the starting positions of the runs of ILCP, where ILCP[i] is the length
+    of the longest common prefix of the suffixes starting at SA[i] and at SA[i'], where i' < i is the largest position
+    with SA[i'] in the same document as SA[i] (0, if there is no such i'); the positions i in [b,e] with ILCP[i] < |P|
+    are the leftmost ones of their documents in the suffix array interval [b,e] of P, which lets list_documents()
+    report each document once without decoding the other occurrences; empty <=> ILCP is not built */
+    sd_array<pos_t> _ILCP_R;
+    // [0..rho-1] stores at position t the value of the t-th run of ILCP, where rho is the number of runs of ILCP
+    interleaved_vectors<pos_t,pos_t> _ILCP_V;
+    // range minimum query support for _ILCP_V
+    sdsl::rmq_succinct_sct<> _ILCP_RMQ;
+    /* [0..rho-1] stores at position t the value SA[i_t], where i_t is the starting position of the t-th run of ILCP;
+    only built for _locate_move and _locate_move_bi (with _locate_rlzdsa, SA[i_t] is decoded from the rlzdsa) */
+    interleaved_vectors<pos_t,pos_t> _ILCP_SA;
+
+    /* copies of M_LF (with L') and M_Phi^{-1}, whose rows are stored in the order in which reverting the input and
+    decoding the suffix array visit them first; empty <=> reorder_rows() has not been called */
+    move_data_structure_reordered<pos_t,i_sym_t> _M_LF_ro;
+    move_data_structure_reordered<pos_t> _M_Phi_m1_ro;
+
+    /* compressed bit vector of length n marking the irreducible positions j_0 < j_1 < ... < j_{r-1} in the input,
+    i.e., the suffix array values at the starting positions of the bwt runs; empty <=> the PLCP samples are not built */
+    sd_array<pos_t> _PLCP_I;
+    // [0..r-1] stores at position k the value PLCP[j_k], where j_k is the k-th irreducible position
+    interleaved_vectors<pos_t,pos_t> _PLCP_s;
     
     // ############################# INTERNAL METHODS #############################
 
@@ -171,6 +314,32 @@ class move_r {
     
     class construction;
 
+    /**
+     * @brief builds the index of the reversed input and takes over its M_LF, RS_L' (and SA_s) as M_LF^rev, RS_L'^rev
+     * (and SA_s^rev); since the symbols are mapped to the internal effective alphabet in the same (order-preserving)
+     * way for the input and the reversed input, both directions use the same internal symbols
+     * @param input the input
+     * @param params construction parameters
+     */
+    void build_reverse(const inp_t& input, move_r_params params) {
+        if (params.log) std::cout << "building the index of the reversed input:" << std::endl;
+
+        params.bidirectional = false;
+        params.mf_idx = NULL;
+        params.mf_mds = NULL;
+        params.doc_starts.clear();
+        params.build_thresholds = false;
+        move_r<support_rev,sym_t,pos_t> idx_rev(inp_t(input.rbegin(),input.rend()),params);
+
+        r_rev = idx_rev.r_;
+        _M_LF_rev = std::move(idx_rev._M_LF);
+        _RS_L__rev = std::move(idx_rev._RS_L_);
+        if constexpr (supports_locate) _SA_s_rev = std::move(idx_rev._SA_s);
+        bidirectional = true;
+
+        if (params.log) std::cout << std::endl << "building the index of the input:" << std::endl;
+    }
+
     // ############################# CONSTRUCTORS #############################
 
     public:
@@ -182,7 +351,13 @@ class move_r {
      * @param params construction parameters
      */
     move_r(inp_t& input, move_r_params params = {}) {
+        if (params.bidirectional) build_reverse(input,params);
         construction(*this,input,false,params);
+        if (params.sample_rate_isa != 0) build_isa_samples(params.sample_rate_isa,params.num_threads,params.log);
+
+        if constexpr (uses_m_phi_m1) {
+            if (params.sample_rate_sa != 0) build_sa_samples(params.sample_rate_sa,params.num_threads,params.log);
+        }
     }
 
     /**
@@ -191,7 +366,13 @@ class move_r {
      * @param params construction parameters
      */
     move_r(inp_t&& input, move_r_params params = {}) {
+        if (params.bidirectional) build_reverse(input,params);
         construction(*this,input,true,params);
+        if (params.sample_rate_isa != 0) build_isa_samples(params.sample_rate_isa,params.num_threads,params.log);
+
+        if constexpr (uses_m_phi_m1) {
+            if (params.sample_rate_sa != 0) build_sa_samples(params.sample_rate_sa,params.num_threads,params.log);
+        }
     }
 
     /**
@@ -200,11 +381,26 @@ class move_r {
      * @param params construction parameters
      */
     move_r(std::ifstream& input_file, move_r_params params = {}) requires(str_input) {
+        if (params.bidirectional) {
+            // the reversed input has to be built in memory
+            std::string input;
+            input_file.seekg(0,std::ios::end);
+            no_init_resize(input,input_file.tellg());
+            input_file.seekg(0,std::ios::beg);
+            read_from_file(input_file,input.data(),input.size());
+            build_reverse(input,params);
+        }
+
         construction(*this,input_file,params);
+        if (params.sample_rate_isa != 0) build_isa_samples(params.sample_rate_isa,params.num_threads,params.log);
+
+        if constexpr (uses_m_phi_m1) {
+            if (params.sample_rate_sa != 0) build_sa_samples(params.sample_rate_sa,params.num_threads,params.log);
+        }
     }
 
     /**
-     * @brief constructs a move_r index from a suffix array and a bwt
+     * @brief constructs a move_r index from a suffix array and a bwt (params.bidirectional is ignored)
      * @tparam sa_sint_t suffix array signed integer type
      * @param suffix_array vector containing the suffix array of the input
      * @param bwt string containing the bwt of the input, where $ = 1
@@ -213,6 +409,11 @@ class move_r {
     template <typename sa_sint_t>
     move_r(std::vector<sa_sint_t>& suffix_array, std::string& bwt, move_r_params params = {}) requires(str_input) {
         construction(*this,suffix_array,bwt,params);
+        if (params.sample_rate_isa != 0) build_isa_samples(params.sample_rate_isa,params.num_threads,params.log);
+
+        if constexpr (uses_m_phi_m1) {
+            if (params.sample_rate_sa != 0) build_sa_samples(params.sample_rate_sa,params.num_threads,params.log);
+        }
     }
 
     // ############################# MISC PUBLIC METHODS #############################
@@ -241,6 +442,58 @@ class move_r {
         return r;
     }
 
+    /**
+     * @brief returns whether the index also stores the data structures of the reversed input, i.e., whether
+     *        query_context::append() can be used
+     * @return whether the index is bidirectional
+     */
+    inline bool is_bidirectional() const {
+        return bidirectional;
+    }
+
+    /**
+     * @brief returns the sample rate of the text position samples used by extract(l,r) (0 if they have not been built)
+     * @return sample rate of the text position samples
+     */
+    inline pos_t sample_rate_isa() const {
+        return sr_isa;
+    }
+
+    /**
+     * @brief returns the sample rate of the suffix array samples used by SA(i) (0 if they have not been built)
+     * @return sample rate of the suffix array samples
+     */
+    inline pos_t sample_rate_sa() const {
+        return sr_sa;
+    }
+
+    /**
+     * @brief returns whether reorder_rows() has been called, i.e., whether reverting and locating use the reordered
+     *        rows of M_LF and M_Phi^{-1}
+     * @return whether the rows have been reordered
+     */
+    inline bool has_reordered_rows() const {
+        return !_M_LF_ro.empty();
+    }
+
+    /**
+     * @brief returns the maximum distance that is scanned over L' in a backward search step before falling back
+     *        to rank-select queries on L' (only relevant for byte alphabets)
+     * @return maximum scan distance over L'
+     */
+    inline pos_t max_scan_l_length() const {
+        return max_scan_l_;
+    }
+
+    /**
+     * @brief sets the maximum distance that is scanned over L' in a backward search step before falling back
+     *        to rank-select queries on L' (only relevant for byte alphabets); 0 always uses rank-select queries
+     * @param max_scan maximum scan distance over L'
+     */
+    inline void set_max_scan_l_length(pos_t max_scan) {
+        max_scan_l_ = max_scan;
+    }
+
     /**
      * @brief returns the number of phrases in the rlzdsa
      * @return number of phrases in the rlzdsa
@@ -277,12 +530,13 @@ class move_r {
      * @brief returns the number omega_idx of bits used by one entry in SA_Phi^{-1} (word width of SA_Phi^{-1})
      * @return omega_idx
      */
-    inline uint8_t width_saphi() const requires(support == _locate_move) {
+    inline uint8_t width_saphi() const requires(uses_m_phi_m1) {
         return omega_idx;
     }
 
     /**
-     * @brief returns the maximum number of threads that can be used to revert the index
+     * @brief returns the maximum number of threads that can be used to revert the index without text position
+     * samples (if they have been built, revert() can use any number of threads)
      * @return maximum number of threads that can be used to revert the index 
      */
     inline uint16_t max_revert_threads() const {
@@ -304,10 +558,17 @@ class move_r {
 
         if constexpr (support == _locate_one) {
             size += _SA_s.size_in_bytes(); // SA_s
-        } else if constexpr (support == _locate_move) {
+        } else if constexpr (uses_m_phi_m1) {
             size +=
                 _M_Phi_m1.size_in_bytes()+ // M_Phi^{-1}
                 _SA_Phi_m1.size_in_bytes(); // SA_Phi^{-1}
+
+            if constexpr (uses_m_phi) {
+                size +=
+                    sizeof(pos_t)+ // r'''
+                    _M_Phi.size_in_bytes()+ // M_Phi
+                    _SA_Phi.size_in_bytes(); // SA_Phi
+            }
         } else if constexpr (support == _locate_rlzdsa) {
             size +=
                 _SA_s.size_in_bytes()+ // SA_s
@@ -319,6 +580,25 @@ class move_r {
                 _PT.size_in_bytes(); // PT
         }
 
+        if (bidirectional) {
+            size +=
+                sizeof(pos_t)+ // r'^rev
+                _M_LF_rev.size_in_bytes()+ // M_LF^rev and L'^rev
+                _RS_L__rev.size_in_bytes(); // RS_L'^rev
+
+            if constexpr (supports_locate) {
+                size += _SA_s_rev.size_in_bytes(); // SA_s^rev
+            }
+        }
+
+        size += sizeof(pos_t)+_ISA_s.size_in_bytes(); // sr_isa and ISA_s
+        size += sizeof(pos_t)+_SA_sr.size_in_bytes(); // sr_sa and SA_sr
+        size += 1+_DS.size_in_bytes(); // DS
+        size += 1+_ILCP_R.size_in_bytes()+_ILCP_V.size_in_bytes()+sdsl::size_in_bytes(_ILCP_RMQ)+_ILCP_SA.size_in_bytes(); // ILCP
+        size += 1+_THR.size_in_bytes(); // thresholds
+        size += 1+_PLCP_I.size_in_bytes()+_PLCP_s.size_in_bytes(); // PLCP_I and PLCP_s
+        size += _M_LF_ro.size_in_bytes()+_M_Phi_m1_ro.size_in_bytes(); // reordered M_LF and M_Phi^{-1}
+
         return size;
     }
 
@@ -340,9 +620,14 @@ class move_r {
 
         if constexpr (support == _locate_one) {
             std::cout << "SA_s: " << format_size(_SA_s.size_in_bytes()) << std::endl;
-        } else if constexpr (support == _locate_move) {
+        } else if constexpr (uses_m_phi_m1) {
             std::cout << "M_Phi^{-1}: " << format_size(_M_Phi_m1.size_in_bytes()) << std::endl;
             std::cout << "SA_Phi^{-1}: " << format_size(_SA_Phi_m1.size_in_bytes()) << std::endl;
+
+            if constexpr (uses_m_phi) {
+                std::cout << "M_Phi: " << format_size(_M_Phi.size_in_bytes()) << std::endl;
+                std::cout << "SA_Phi: " << format_size(_SA_Phi.size_in_bytes()) << std::endl;
+            }
         } else if constexpr (support == _locate_rlzdsa) {
             std::cout << "SA_s: " << format_size(_SA_s.size_in_bytes()) << std::endl;
             std::cout << "R: " << format_size(_R.size_in_bytes()) << std::endl;
@@ -352,6 +637,52 @@ class move_r {
             std::cout << "LP: " << format_size(_LP.size_in_bytes()) << std::endl;
             std::cout << "PT: " << format_size(_PT.size_in_bytes()) << std::endl;
         }
+
+        if (bidirectional) {
+            uint64_t size_l__rev = (_M_LF_rev.width_l_()/8)*(r_rev+1);
+            std::cout << "M_LF^rev: " << format_size(_M_LF_rev.size_in_bytes()-size_l__rev) << std::endl;
+            std::cout << "L'^rev: " << format_size(size_l__rev) << std::endl;
+            std::cout << "RS_L'^rev: " << format_size(_RS_L__rev.size_in_bytes()) << std::endl;
+
+            if constexpr (supports_locate) {
+                std::cout << "SA_s^rev: " << format_size(_SA_s_rev.size_in_bytes()) << std::endl;
+            }
+        }
+
+        if (sr_isa != 0) {
+            std::cout << "ISA_s: " << format_size(_ISA_s.size_in_bytes()) << std::endl;
+        }
+
+        if (sr_sa != 0) {
+            std::cout << "SA_sr: " << format_size(_SA_sr.size_in_bytes()) << std::endl;
+        }
+
+        if (!_DS.empty()) {
+            std::cout << "DS: " << format_size(_DS.size_in_bytes()) << std::endl;
+        }
+
+        if (has_ilcp()) {
+            std::cout << "ILCP: " << format_size(
+                _ILCP_R.size_in_bytes()+_ILCP_V.size_in_bytes()+sdsl::size_in_bytes(_ILCP_RMQ)+_ILCP_SA.size_in_bytes()
+            ) << std::endl;
+        }
+
+        if (has_thresholds()) {
+            std::cout << "thresholds: " << format_size(_THR.size_in_bytes()) << std::endl;
+        }
+
+        if (!_M_LF_ro.empty()) {
+            std::cout << "reordered M_LF: " << format_size(_M_LF_ro.size_in_bytes()) << std::endl;
+        }
+
+        if (!_M_Phi_m1_ro.empty()) {
+            std::cout << "reordered M_Phi^{-1}: " << format_size(_M_Phi_m1_ro.size_in_bytes()) << std::endl;
+        }
+
+        if (has_lcp()) {
+            std::cout << "PLCP_I: " << format_size(_PLCP_I.size_in_bytes()) << std::endl;
+            std::cout << "PLCP_s: " << format_size(_PLCP_s.size_in_bytes()) << std::endl;
+        }
     }
 
     /**
@@ -372,9 +703,14 @@ class move_r {
 
         if constexpr (support == _locate_one) {
             out << "size_sa_s: " << _SA_s.size_in_bytes();
-        } else if constexpr (support == _locate_move) {
+        } else if constexpr (uses_m_phi_m1) {
             out << " size_m_phim1=" << _M_Phi_m1.size_in_bytes();
             out << " size_sa_phim1=" << _SA_Phi_m1.size_in_bytes();
+
+            if constexpr (uses_m_phi) {
+                out << " size_m_phi=" << _M_Phi.size_in_bytes();
+                out << " size_sa_phi=" << _SA_Phi.size_in_bytes();
+            }
         } else if constexpr (support == _locate_rlzdsa) {
             out << "size_sa_s: " << _SA_s.size_in_bytes();
             out << "size_r: " << _R.size_in_bytes();
@@ -384,6 +720,51 @@ class move_r {
             out << "size_lp: " << _LP.size_in_bytes();
             out << "size_pt: " << _PT.size_in_bytes();
         }
+
+        if (bidirectional) {
+            uint64_t size_l__rev = (_M_LF_rev.width_l_()/8)*(r_rev+1);
+            out << " size_m_lf_rev=" << _M_LF_rev.size_in_bytes()-size_l__rev;
+            out << " size_l__rev=" << size_l__rev;
+            out << " size_rs_l__rev=" << _RS_L__rev.size_in_bytes();
+
+            if constexpr (supports_locate) {
+                out << " size_sa_s_rev=" << _SA_s_rev.size_in_bytes();
+            }
+        }
+
+        if (sr_isa != 0) {
+            out << " size_isa_s=" << _ISA_s.size_in_bytes();
+        }
+
+        if (sr_sa != 0) {
+            out << " size_sa_sr=" << _SA_sr.size_in_bytes();
+        }
+
+        if (!_DS.empty()) {
+            out << " size_ds=" << _DS.size_in_bytes();
+        }
+
+        if (has_ilcp()) {
+            out << " size_ilcp=" << _ILCP_R.size_in_bytes()+_ILCP_V.size_in_bytes()+
+                sdsl::size_in_bytes(_ILCP_RMQ)+_ILCP_SA.size_in_bytes();
+        }
+
+        if (has_thresholds()) {
+            out << " size_thr=" << _THR.size_in_bytes();
+        }
+
+        if (!_M_LF_ro.empty()) {
+            out << " size_m_lf_ro=" << _M_LF_ro.size_in_bytes();
+        }
+
+        if (!_M_Phi_m1_ro.empty()) {
+            out << " size_m_phim1_ro=" << _M_Phi_m1_ro.size_in_bytes();
+        }
+
+        if (has_lcp()) {
+            out << " size_plcp_i=" << _PLCP_I.size_in_bytes();
+            out << " size_plcp_s=" << _PLCP_s.size_in_bytes();
+        }
     }
 
     // ############################# PUBLIC ACCESS METHODS #############################
@@ -396,14 +777,30 @@ class move_r {
         return _M_LF;
     }
 
+    /**
+     * @brief returns a reference to M_LF^rev (M_LF of the reversed input)
+     * @return M_LF^rev
+     */
+    inline const move_data_structure_l_<pos_t,i_sym_t>& M_LF_rev() const {
+        return _M_LF_rev;
+    }
+
     /**
      * @brief returns a reference to M_Phi^{-1}
      * @return M_Phi^{-1}
      */
-    inline const move_data_structure<pos_t>& M_Phi_m1() const requires(support == _locate_move) {
+    inline const mds_phi_t& M_Phi_m1() const requires(uses_m_phi_m1) {
         return _M_Phi_m1;
     }
 
+    /**
+     * @brief returns a reference to M_Phi
+     * @return M_Phi
+     */
+    inline const mds_phi_t& M_Phi() const requires(uses_m_phi) {
+        return _M_Phi;
+    }
+
     /**
      * @brief returns a reference to RS_L'
      * @return RS_L'
@@ -412,6 +809,14 @@ class move_r {
         return _RS_L_;
     }
 
+    /**
+     * @brief returns a reference to RS_L'^rev (RS_L' of the reversed input)
+     * @return RS_L'^rev
+     */
+    inline const rsl_t& RS_L__rev() const {
+        return _RS_L__rev;
+    }
+
     /**
      * @brief returns a reference to R
      * @return R
@@ -519,10 +924,29 @@ class move_r {
      * @param x [0..r''-1]
      * @return SA_Phi^{-1}[x]
      */
-    inline pos_t SA_Phi_m1(pos_t x) const requires(support == _locate_move) {
+    inline pos_t SA_Phi_m1(pos_t x) const requires(uses_m_phi_m1) {
         return _SA_Phi_m1[x];
     }
 
+    /**
+     * @brief returns SA_Phi[x]
+     * @param x [0..r'-1]
+     * @return SA_Phi[x]
+     */
+    inline pos_t SA_Phi(pos_t x) const requires(uses_m_phi) {
+        return _SA_Phi[x];
+    }
+
+    /**
+     * @brief returns SA_e[x] = SA[M_LF.p[x+1]-1]
+     * @param x [0..r'-1] the end position of the x-th input
+     * interval in M_LF must be an end position of a bwt run
+     * @return SA_e[x]
+     */
+    inline pos_t SA_e(pos_t x) const requires(uses_m_phi) {
+        return M_Phi().q(SA_Phi(x));
+    }
+
     /**
      * @brief returns SA_s[x]
      * @param x [0..r'-1] the starting position of the x-th input
@@ -530,13 +954,24 @@ class move_r {
      * @return SA_s[x]
      */
     inline pos_t SA_s(pos_t x) const requires(supports_locate) {
-        if constexpr (support == _locate_move) {
+        if constexpr (uses_m_phi_m1) {
             return M_Phi_m1().q(SA_Phi_m1(x));
         } else {
             return _SA_s[x];
         }
     }
 
+    /**
+     * @brief returns SA_s^rev[x], the suffix array value of the reversed input at the starting position of the
+     * x-th input interval in M_LF^rev
+     * @param x [0..r'^rev-1] the starting position of the x-th input interval in M_LF^rev must be a starting
+     * position of a bwt run of the reversed input
+     * @return SA_s^rev[x]
+     */
+    inline pos_t SA_s_rev(pos_t x) const requires(supports_locate) {
+        return _SA_s_rev[x];
+    }
+
     /**
      * @brief returns L'[x]
      * @param x [0..r'-1]
@@ -607,28 +1042,158 @@ class move_r {
     inline sym_t BWT(pos_t i) const;
 
     /**
-     * @brief returns SA[i]
+     * @brief builds the suffix array samples SA_sr (replaces existing ones); for every sample_rate-th suffix array
+     * position i, SA[i] and the index of the input interval in M_Phi^{-1} containing SA[i] are stored, which takes
+     * O(n/sample_rate) words of space; the samples are collected by decoding the bwt runs in parallel
+     * @param sample_rate sample rate (1 <= sample_rate)
+     * @param num_threads maximum number of threads to use
+     * @param log controls, whether to print log messages
+     */
+    void build_sa_samples(pos_t sample_rate, uint16_t num_threads = omp_get_max_threads(), bool log = false) requires(uses_m_phi_m1);
+
+    /**
+     * @brief returns SA[i]; if the suffix array samples have been built, this performs less than sample_rate_sa()
+     * Phi^{-1} move queries, else it can perform up to the length of the bwt run containing i move queries
      * @param x [0..input size]
      * @return SA[i]
      */
     pos_t SA(pos_t i) const requires(supports_multiple_locate);
 
+    /**
+     * @brief returns ISA[j], i.e., the position i in the suffix array with SA[i] = j; if the text position samples
+     * have been built, this performs at most sample_rate_isa() LF steps, else it performs LF steps from the end of the
+     * section of the input (see max_revert_threads()) containing j-1
+     * @param j [0..input size]
+     * @return ISA[j]
+     */
+    pos_t ISA(pos_t j) const;
+
+    /**
+     * @brief returns the distinct symbols in L[b..e] (except the terminator), each with the suffix array interval
+     * [b_c,e_c] = [LF(i_f),LF(i_l)], where i_f and i_l are the first and last occurrence of the symbol c in L[b..e];
+     * so if [b,e] is the suffix array interval of P, then [b_c,e_c] is the one of cP (see
+     * interval_symbols(b,e,b_,e_,report))
+     * @param b [0..input size] left interval limit
+     * @param e [b..input size] right interval limit
+     * @return the tuples (c,b_c,e_c) in increasing order of c
+     */
+    std::vector<std::tuple<sym_t,pos_t,pos_t>> interval_symbols(pos_t b, pos_t e) const;
+
+    /**
+     * @brief the state of a query context (without the index it belongs to); it is trivially copyable, so it can be
+     * stored, copied and written to a stream byte by byte
+     */
+    struct query_state {
+        pos_t l = 0;  // length of the currently matched pattern
+        pos_t b = 0,e = 0,b_ = 0,e_ = 0,hat_b_ap_y = 0,hat_e_ap_z = 0; // variables for backward search
+        int64_t y = 0,z = 0; // variables for backward search
+        pos_t i = 0; // current position in the suffix array interval
+        pos_t s = 0; // current suffix s = SA[i] in the suffix array interval
+        pos_t s_ = 0; // index of the input inteval of M_Phi^{-1} containing s
+        pos_t x_p = 0,x_lp = 0,x_cp = 0,x_r = 0,s_np = 0; // variables for decoding the rlzdsa
+        // variables for the backward search in the reversed input (only used if the index is bidirectional)
+        pos_t b_rev = 0,e_rev = 0,b__rev = 0,e__rev = 0,hat_b_ap_y_rev = 0,hat_e_ap_z_rev = 0;
+        int64_t y_rev = 0,z_rev = 0; // variables for the backward search in the reversed input
+        bool sample_fwd = false; // true <=> SA[b] = SA_s[hat_b_ap_y]-(y+1) holds (false after append())
+        bool sample_rev = false; // true <=> SA^rev[b_rev] = SA_s^rev[hat_b_ap_y_rev]-(y_rev+1) holds (false after prepend())
+
+        /**
+         * @brief writes the query state to an output stream; the variables are written one by one (without padding),
+         * a flag byte is followed by the variables of the backward search and of the blocks of variables for locating,
+         * for decoding the rlzdsa and for the reversed input, of which each is only written if one of its variables
+         * is not 0 (so a state of a unidirectional index takes 17+7*sizeof(pos_t) bytes before locating)
+         * @param out output stream
+         */
+        void serialize(std::ostream& out) const {
+            bool has_loc = i != 0 || s != 0 || s_ != 0;
+            bool has_rlzdsa = x_p != 0 || x_lp != 0 || x_cp != 0 || x_r != 0 || s_np != 0;
+            bool has_rev =
+                b_rev != 0 || e_rev != 0 || b__rev != 0 || e__rev != 0 ||
+                hat_b_ap_y_rev != 0 || hat_e_ap_z_rev != 0 || y_rev != 0 || z_rev != 0;
+            uint8_t flags = sample_fwd | (sample_rev << 1) | (has_loc << 2) | (has_rlzdsa << 3) | (has_rev << 4);
+            out.write((char*)&flags,1);
+
+            for (const pos_t* v : {&l,&b,&e,&b_,&e_,&hat_b_ap_y,&hat_e_ap_z}) out.write((char*)v,sizeof(pos_t));
+            out.write((char*)&y,sizeof(int64_t));
+            out.write((char*)&z,sizeof(int64_t));
+            if (has_loc) for (const pos_t* v : {&i,&s,&s_}) out.write((char*)v,sizeof(pos_t));
+            if (has_rlzdsa) for (const pos_t* v : {&x_p,&x_lp,&x_cp,&x_r,&s_np}) out.write((char*)v,sizeof(pos_t));
+
+            if (has_rev) {
+                for (const pos_t* v : {&b_rev,&e_rev,&b__rev,&e__rev,&hat_b_ap_y_rev,&hat_e_ap_z_rev}) {
+                    out.write((char*)v,sizeof(pos_t));
+                }
+
+                out.write((char*)&y_rev,sizeof(int64_t));
+                out.write((char*)&z_rev,sizeof(int64_t));
+            }
+        }
+
+        /**
+         * @brief reads a query state, that has been written with serialize(), from an input stream
+         * @param in input stream
+         */
+        void load(std::istream& in) {
+            uint8_t flags;
+            in.read((char*)&flags,1);
+            sample_fwd = flags & 1;
+            sample_rev = (flags >> 1) & 1;
+
+            for (pos_t* v : {&l,&b,&e,&b_,&e_,&hat_b_ap_y,&hat_e_ap_z}) in.read((char*)v,sizeof(pos_t));
+            in.read((char*)&y,sizeof(int64_t));
+            in.read((char*)&z,sizeof(int64_t));
+
+            for (pos_t* v : {&i,&s,&s_}) {
+                *v = 0;
+                if (flags & (1 << 2)) in.read((char*)v,sizeof(pos_t));
+            }
+
+            for (pos_t* v : {&x_p,&x_lp,&x_cp,&x_r,&s_np}) {
+                *v = 0;
+                if (flags & (1 << 3)) in.read((char*)v,sizeof(pos_t));
+            }
+
+            for (pos_t* v : {&b_rev,&e_rev,&b__rev,&e__rev,&hat_b_ap_y_rev,&hat_e_ap_z_rev}) {
+                *v = 0;
+                if (flags & (1 << 4)) in.read((char*)v,sizeof(pos_t));
+            }
+
+            y_rev = 0;
+            z_rev = 0;
+
+            if (flags & (1 << 4)) {
+                in.read((char*)&y_rev,sizeof(int64_t));
+                in.read((char*)&z_rev,sizeof(int64_t));
+            }
+        }
+    };
+
     /**
      * @brief stores the variables needed to perform count- and locate-queries
      */
-    struct query_context {
+    struct query_context : protected query_state {
         protected:
 
-        pos_t l;  // length of the currently matched pattern
-        pos_t b,e,b_,e_,hat_b_ap_y,hat_e_ap_z; // variables for backward search
-        int64_t y,z; // variables for backward search
-        pos_t i; // current position in the suffix array interval
-        pos_t s; // current suffix s = SA[i] in the suffix array interval
-        pos_t s_; // index of the input inteval of M_Phi^{-1} containing s
-        pos_t x_p,x_lp,x_cp,x_r,s_np; // variables for decoding the rlzdsa
+        // query_state is a dependent base class, so its members have to be introduced explicitly
+        using query_state::l;
+        using query_state::b,query_state::e,query_state::b_,query_state::e_,query_state::hat_b_ap_y,query_state::hat_e_ap_z;
+        using query_state::y,query_state::z;
+        using query_state::i,query_state::s,query_state::s_;
+        using query_state::x_p,query_state::x_lp,query_state::x_cp,query_state::x_r,query_state::s_np;
+        using query_state::b_rev,query_state::e_rev,query_state::b__rev,query_state::e__rev;
+        using query_state::hat_b_ap_y_rev,query_state::hat_e_ap_z_rev,query_state::y_rev,query_state::z_rev;
+        using query_state::sample_fwd,query_state::sample_rev;
 
         const move_r<support,sym_t,pos_t>* idx; // index to query
 
+        friend class move_r<support,sym_t,pos_t>;
+
+        /**
+         * @brief computes s = SA[b] (and s_ for _locate_move); if the toehold of the backward search is not valid
+         * (because the pattern has been extended to the right with append()), SA[b] is computed with SA(b)
+         */
+        inline void init_sa_b() requires(supports_multiple_locate);
+
         public:
         /**
          * @brief constructs a new query context for the index idx
@@ -644,10 +1209,29 @@ class move_r {
          */
         inline void reset() {
             idx->init_backward_search(b,e,b_,e_,hat_b_ap_y,y,hat_e_ap_z,z);
+            if (idx->bidirectional) idx->template init_backward_search<true>(b_rev,e_rev,b__rev,e__rev,hat_b_ap_y_rev,y_rev,hat_e_ap_z_rev,z_rev);
+            sample_fwd = true;
+            sample_rev = true;
             l = 0;
             i = b;
         }
 
+        /**
+         * @brief returns the state of the query context, which can be restored with restore()
+         * @return the state of the query context
+         */
+        inline query_state state() const {
+            return *this;
+        }
+
+        /**
+         * @brief restores a state of a query context of the same index (see state())
+         * @param state a state of a query context of the same index
+         */
+        inline void restore(const query_state& state) {
+            static_cast<query_state&>(*this) = state;
+        }
+
         /**
          * @brief returns the length of the currently matched pattern
          * @return length of the currently matched pattern
@@ -689,6 +1273,25 @@ class move_r {
          */
         bool prepend(sym_t sym);
 
+        /**
+         * @brief prepends P[len-1], P[len-2], ..., P[0] to the currently matched pattern one after another (see
+         * prepend()), until a symbol cannot be prepended
+         * @param P array of symbols
+         * @param len number of symbols in P
+         * @return the number of prepended symbols, i.e., the length of the longest suffix of P that has been prepended
+         */
+        pos_t prepend_many(const sym_t* P, pos_t len);
+
+        /**
+         * @brief appends sym to the currently matched pattern P (if the index is not bidirectional, false is returned); if Psym occurs in the
+         * input, true is returned and the query context is adjusted to store the information for the pattern Psym;
+         * else, false is returned and the query context is not modified; after appending, the first call to next_occ()
+         * or locate() computes SA[b] with SA(b) until a following prepend() re-establishes the toehold
+         * @param sym 
+         * @return whether Psym occurs in the input
+         */
+        bool append(sym_t sym);
+
         /**
          * @brief reports the next occurrence of the currently matched pattern
          * @return next occurrence
@@ -716,8 +1319,28 @@ class move_r {
             locate(Occ);
             return Occ;
         }
+
+        /**
+         * @brief locates at most max_occ of the remaining (not yet reported) occurrences of the currently matched
+         * pattern (the next ones in suffix array order); the other occurrences can still be reported afterwards
+         * @param Occ vector to append the occurrences to
+         * @param max_occ maximum number of occurrences to locate
+         */
+        void locate(std::vector<pos_t>& Occ, pos_t max_occ) requires(supports_multiple_locate);
+
+        /**
+         * @brief locates min(k,occ) occurrences of the currently matched pattern that are spread evenly over its suffix
+         * array interval [b,e], i.e., SA[b+floor(t*occ/k)] for t in [0,k-1], where occ = e-b+1 (in suffix array order);
+         * each of them is decoded starting at the nearest run sample before it, unless the previous one is closer;
+         * the occurrences reported by next_occ() and locate() are not affected
+         * @param Occ vector to append the occurrences to
+         * @param k number of occurrences to locate
+         */
+        void locate_spread(std::vector<pos_t>& Occ, pos_t k) const requires(supports_multiple_locate);
     };
 
+    static_assert(std::is_trivially_copyable_v<query_state> && std::is_trivially_copyable_v<query_context>);
+
     /**
      * @brief returns a query context for the index
      * @return query_context 
@@ -729,6 +1352,7 @@ class move_r {
     protected:
     /**
      * @brief initializes the variables to start a new backward search
+     * @tparam rev whether to initialize a backward search in the reversed input
      * @param b Left interval limit of the suffix array interval.
      * @param e Right interval limit of the suffix array interval.
      * @param b_ index of the input interval in M_LF containing b.
@@ -738,6 +1362,7 @@ class move_r {
      * @param hat_e_ap_z \hat{e}'_z
      * @param z z
      */
+    template <bool rev = false>
     inline void init_backward_search(
         pos_t& b, pos_t& e,
         pos_t& b_, pos_t& e_,
@@ -747,16 +1372,115 @@ class move_r {
         b = 0;
         e = n-1;
         b_ = 0;
-        e_ = r_-1;
+        e_ = (rev ? r_rev : r_)-1;
         hat_b_ap_y = 0;
         y = -1;
-        hat_e_ap_z = r_-1;
+        hat_e_ap_z = (rev ? r_rev : r_)-1;
         z = -1;
     }
+
+    /**
+     * @brief returns M_LF (rev = false) or M_LF^rev (rev = true)
+     * @tparam rev whether to return M_LF^rev
+     * @return M_LF or M_LF^rev
+     */
+    template <bool rev>
+    inline const move_data_structure_l_<pos_t,i_sym_t>& M_LF_dir() const {
+        if constexpr (rev) return _M_LF_rev; else return _M_LF;
+    }
+
+    /**
+     * @brief calls f with the rows of M_LF that are used for chains of LF steps: the reordered rows with fixed widths
+     *        (x is translated to a physical row index before and back after calling f), if reorder_rows() has been
+     *        called, else M_LF with fixed widths
+     * @param x index of an input interval in M_LF
+     * @param f function that takes a const reference to a move data structure with L'
+     */
+    template <typename fnc_t>
+    inline void with_m_lf_rows(pos_t& x, fnc_t&& f) const {
+        if (_M_LF_ro.empty()) {
+            _M_LF.with_fixed_widths(f);
+        } else {
+            x = _M_LF_ro.to_physical(x);
+            _M_LF_ro.with_fixed_widths(f);
+            x = _M_LF_ro.to_logical(x);
+        }
+    }
+
+    /**
+     * @brief calls f with the rows of M_Phi^{-1} that are used for chains of Phi^{-1} steps: the reordered rows with
+     *        fixed widths (s_ is translated to a physical row index before and back after calling f), if reorder_rows()
+     *        has been called, else M_Phi^{-1} with fixed widths
+     * @param s_ index of an input interval in M_Phi^{-1}
+     * @param f function that takes a const reference to a move data structure
+     */
+    template <typename fnc_t>
+    inline void with_m_phi_m1_rows(pos_t& s_, fnc_t&& f) const requires(uses_m_phi_m1) {
+        if (_M_Phi_m1_ro.empty()) {
+            _M_Phi_m1.with_fixed_widths(f);
+        } else {
+            s_ = _M_Phi_m1_ro.to_physical(s_);
+            _M_Phi_m1_ro.with_fixed_widths(f);
+            s_ = _M_Phi_m1_ro.to_logical(s_);
+        }
+    }
+
+    /**
+     * @brief calls f with the rows of M_Phi^{-1} that are used for chains of Phi^{-1} steps (see
+     *        with_m_phi_m1_rows(s_,f)) and a function that translates an index of an input interval in M_Phi^{-1} to
+     *        a row index in them (for interleaving several chains, whose row indices are translated individually)
+     * @param f function that takes a const reference to a move data structure and a translation function
+     */
+    template <typename fnc_t>
+    inline void with_m_phi_m1_rows(fnc_t&& f) const requires(uses_m_phi_m1) {
+        if (_M_Phi_m1_ro.empty()) {
+            _M_Phi_m1.with_fixed_widths([&f](const auto& m_phi_m1){f(m_phi_m1,[](pos_t s_){return s_;});});
+        } else {
+            _M_Phi_m1_ro.with_fixed_widths([this,&f](const auto& m_phi_m1){
+                f(m_phi_m1,[this](pos_t s_){return _M_Phi_m1_ro.to_physical(s_);});
+            });
+        }
+    }
+
+    /**
+     * @brief returns RS_L' (rev = false) or RS_L'^rev (rev = true)
+     * @tparam rev whether to return RS_L'^rev
+     * @return RS_L' or RS_L'^rev
+     */
+    template <bool rev>
+    inline const rsl_t& RS_L__dir() const {
+        if constexpr (rev) return _RS_L__rev; else return _RS_L_;
+    }
+
+    /**
+     * @brief returns the number of positions in L[b,e] (or L^rev[b,e] if rev = true) with a symbol smaller than sym; if
+     * the interval spans few input intervals of M_LF, they are scanned, else the positions are counted with rank-select
+     * queries on L' for each symbol smaller than sym
+     * @tparam rev whether to count in L^rev
+     * @param sym a symbol in the internal effective alphabet
+     * @param b left interval limit
+     * @param e right interval limit
+     * @param b_ index of the input interval in M_LF containing b
+     * @param e_ index of the input interval in M_LF containing e
+     * @return the number of positions in L[b,e] with a symbol smaller than sym
+     */
+    template <bool rev>
+    pos_t count_smaller(i_sym_t sym, pos_t b, pos_t e, pos_t b_, pos_t e_) const;
+
+    /**
+     * @brief returns SA[i] for some i in [b,e]; to do so, LF is applied to [b,e] until it contains the starting
+     * position of an input interval of M_LF that has a suffix array sample
+     * @param b left interval limit of the suffix array interval
+     * @param e right interval limit of the suffix array interval
+     * @param b_ index of the input interval in M_LF containing b
+     * @return SA[i] for some i in [b,e]
+     */
+    pos_t sa_in_interval(pos_t b, pos_t e, pos_t b_) const requires(supports_locate);
     
     /**
      * @brief prepends sym to the currently matched pattern P, adjusts the variables to store
      * the query context for the pattern symP and returns whether symP occurs in the input
+     * @tparam rev whether to search in the reversed input (with M_LF^rev and RS_L'^rev)
      * @param sym next symbol to match
      * @param b Left interval limit of the suffix array interval.
      * @param e Right interval limit of the suffix array interval.
@@ -768,6 +1492,7 @@ class move_r {
      * @param z z
      * @return whether symP occurs in the input
      */
+    template <bool rev = false>
     bool backward_search_step(
         sym_t sym,
         pos_t& b, pos_t& e,
@@ -777,29 +1502,139 @@ class move_r {
     ) const;
 
     /**
-     * @brief Sets the up a Phi^{-1}-move-pair for the suffix array sample at the starting position of the x-th input interval in M_LF
-     * @param x an input interval in M_LF (the end position of the x-th input interval in M_LF must be a starting position of a BWT run)
-     * @param s variable to store the suffix array sample at position M_LF.p[x]
-     * @param s_ variable to store the index of the input interval in M_Phi^{-1} containing s
-     */
-    inline void setup_phi_m1_move_pair(pos_t& x, pos_t& s, pos_t& s_) const requires(support == _locate_move);
-
-    /**
-     * @brief prepares the variables to decode SA[b]
-     * @param b left interval limit of the suffix array interval
-     * @param e right interval limit of the suffix array interval
-     * @param s variable to store SA[b] in
-     * @param s_ index of the input interval in M_Phi^{-1} containing s
+     * @brief first half of a backward search step: finds the first and last (sub-)runs with symbol sym in
+     * L'[b_,e_], adjusts b, e, b_, e_, hat_b_ap_y, y, hat_e_ap_z and z accordingly and returns whether
+     * symP occurs in the input; afterwards, backward_search_lf has to be called to finish the step
+     * @tparam rev whether to search in the reversed input (with M_LF^rev and RS_L'^rev)
+     * @param sym next symbol to match
+     * @param b Left interval limit of the suffix array interval.
+     * @param e Right interval limit of the suffix array interval.
+     * @param b_ index of the input interval in M_LF containing b.
+     * @param e_ index of the input interval in M_LF containing e.
      * @param hat_b_ap_y \hat{b}'_y
      * @param y y
+     * @param hat_e_ap_z \hat{e}'_z
+     * @param z z
+     * @return whether symP occurs in the input
      */
-    inline void init_phi_m1(
+    template <bool rev = false>
+    inline bool backward_search_find_runs(
+        sym_t sym,
         pos_t& b, pos_t& e,
-        pos_t& s, pos_t& s_,
-        pos_t& hat_b_ap_y, int64_t& y
-    ) const requires(support == _locate_move);
-    
-    /**
+        pos_t& b_, pos_t& e_,
+        pos_t& hat_b_ap_y, int64_t& y,
+        pos_t& hat_e_ap_z, int64_t& z
+    ) const;
+
+    /**
+     * @brief second half of a backward search step: sets b <- LF(b) and e <- LF(e) (and adjusts b_ and e_)
+     * @tparam rev whether to search in the reversed input (with M_LF^rev)
+     * @param b Left interval limit of the suffix array interval.
+     * @param e Right interval limit of the suffix array interval.
+     * @param b_ index of the input interval in M_LF containing b.
+     * @param e_ index of the input interval in M_LF containing e.
+     */
+    template <bool rev = false>
+    inline void backward_search_lf(
+        pos_t& b, pos_t& e,
+        pos_t& b_, pos_t& e_
+    ) const;
+
+    /**
+     * @brief stores the variables of one of the backward searches that are interleaved by the batched query methods
+     */
+    struct backward_search_state {
+        pos_t b,e,b_,e_,hat_b_ap_y,hat_e_ap_z; // variables for backward search
+        int64_t y,z; // variables for backward search
+        int64_t i; // position in the pattern of the next symbol to match
+        pos_t j; // index of the pattern
+        uint8_t stage; // 0: find the runs for P[i], 1: prefetch the output intervals of b_ and e_, 2: set b <- LF(b), e <- LF(e)
+    };
+
+    /**
+     * @brief advances the backward searches of all patterns in P round-robin, such that up to batch_width searches
+     * are in flight at the same time; between two stages of a search, the cache lines needed by its next stage
+     * are prefetched, so the latencies of the cache misses of the different searches overlap
+     * @param P the patterns to search for
+     * @param report function that is called with the state of each finished search (b > e <=> the pattern does not occur)
+     */
+    template <typename report_t>
+    void backward_search_batch(std::span<const inp_t> P, report_t&& report) const;
+
+    /**
+     * @brief decodes SA[b..e] from left to right, starting at the nearest run sample or suffix array sample in SA_sr
+     * (if build_sa_samples() has been called) before b, and calls report(i,SA[i]) for each i in [b,e]
+     * @param b left limit of the suffix array range to decode
+     * @param e right limit of the suffix array range to decode
+     * @param report function that is called with every tuple (i,SA[i]), where i in [b,e]
+     */
+    template <typename report_t>
+    void decode_sa(pos_t b, pos_t e, report_t&& report) const requires(supports_multiple_locate);
+
+    /**
+     * @brief Sets the up a Phi^{-1}-move-pair for the suffix array sample at the starting position of the x-th input interval in M_LF
+     * @param x an input interval in M_LF (the end position of the x-th input interval in M_LF must be a starting position of a BWT run)
+     * @param s variable to store the suffix array sample at position M_LF.p[x]
+     * @param s_ variable to store the index of the input interval in M_Phi^{-1} containing s
+     */
+    inline void setup_phi_m1_move_pair(pos_t& x, pos_t& s, pos_t& s_) const requires(uses_m_phi_m1);
+
+    /**
+     * @brief prepares the variables to decode SA[b]
+     * @param b left interval limit of the suffix array interval
+     * @param e right interval limit of the suffix array interval
+     * @param s variable to store SA[b] in
+     * @param s_ index of the input interval in M_Phi^{-1} containing s
+     * @param hat_b_ap_y \hat{b}'_y
+     * @param y y
+     */
+    inline void init_phi_m1(
+        pos_t& b, pos_t& e,
+        pos_t& s, pos_t& s_,
+        pos_t& hat_b_ap_y, int64_t& y
+    ) const requires(uses_m_phi_m1);
+
+    /**
+     * @brief sets up a Phi-move-pair for the suffix array sample at the end position of the x-th input interval in M_LF
+     * @param x an input interval in M_LF (the end position of the x-th input interval in M_LF must be an end position of a BWT run)
+     * @param s variable to store the suffix array sample at position M_LF.p[x+1]-1
+     * @param s_ variable to store the index of the input interval in M_Phi containing s
+     */
+    inline void setup_phi_move_pair(pos_t& x, pos_t& s, pos_t& s_) const requires(uses_m_phi);
+
+    /**
+     * @brief prepares the variables to decode SA[e] (the toehold is SA[e] = SA_e[hat_e_ap_z]-(z+1))
+     * @param b left interval limit of the suffix array interval
+     * @param e right interval limit of the suffix array interval
+     * @param s variable to store SA[e] in
+     * @param s_ index of the input interval in M_Phi containing s
+     * @param hat_e_ap_z \hat{e}'_z
+     * @param z z
+     */
+    inline void init_phi(
+        pos_t& b, pos_t& e,
+        pos_t& s, pos_t& s_,
+        pos_t& hat_e_ap_z, int64_t& z
+    ) const requires(uses_m_phi);
+
+    /**
+     * @brief decodes SA[b..e] from both ends at once, i.e., SA[b..m] from left to right with M_Phi^{-1}, starting at the
+     * toehold SA[b], and SA[m+1..e] from right to left with M_Phi, starting at the toehold SA[e], where m = b+floor((e-b)/2);
+     * the two dependency chains of move queries are independent, so their memory accesses can overlap
+     * @param b left interval limit of the suffix array interval
+     * @param e right interval limit of the suffix array interval
+     * @param hat_b_ap_y \hat{b}'_y
+     * @param y y
+     * @param hat_e_ap_z \hat{e}'_z
+     * @param z z
+     * @param report function that is called with every tuple (i,SA[i]), where i in [b,e] (in no particular order)
+     */
+    template <typename report_t>
+    void decode_occ_bi(
+        pos_t b, pos_t e, pos_t hat_b_ap_y, int64_t y, pos_t hat_e_ap_z, int64_t z, report_t&& report
+    ) const requires(uses_m_phi);
+    
+    /**
      * @brief prepares the variables to decode SA[i]
      * @param i current position in the suffix array
      * @param x_p phrase-index of the phrase of the rlzdsa contianing i
@@ -845,6 +1680,71 @@ class move_r {
         pos_t& x_p, pos_t& x_lp, pos_t& x_cp, pos_t& x_r, pos_t& s_np
     ) const requires(support == _locate_rlzdsa);
 
+    /**
+     * @brief decodes SA[b..e] from left to right, starting at the toehold SA[b] = SA_s[hat_b_ap_y]-(y+1)
+     * @param b left interval limit of the suffix array interval
+     * @param e right interval limit of the suffix array interval
+     * @param hat_b_ap_y \hat{b}'_y
+     * @param y y
+     * @param report function that is called with SA[i] for each i in [b,e] (in increasing order of i)
+     */
+    template <typename report_t>
+    void decode_occ(pos_t b, pos_t e, pos_t hat_b_ap_y, int64_t y, report_t&& report) const requires(supports_multiple_locate);
+
+    /**
+     * @brief appends min(k,e-b+1) suffix array values SA[b+floor(t*(e-b+1)/k)], t in [0,k-1], to Occ; each of them is
+     * decoded starting at the nearest run sample before it, unless the previously decoded one is closer
+     * @param b left interval limit of the suffix array interval
+     * @param e right interval limit of the suffix array interval
+     * @param k number of suffix array values to decode
+     * @param s SA[b]
+     * @param s_ index of the input interval of M_Phi^{-1} containing SA[b] (only for _locate_move)
+     * @param Occ vector to append the suffix array values to
+     */
+    void locate_spread(pos_t b, pos_t e, pos_t k, pos_t s, pos_t s_, std::vector<pos_t>& Occ) const requires(supports_multiple_locate);
+
+    /**
+     * @brief decodes SA[b..e] (see decode_occ()) and writes it to Occ[0..e-b] in increasing order
+     * @param b left interval limit of the suffix array interval
+     * @param e right interval limit of the suffix array interval
+     * @param hat_b_ap_y \hat{b}'_y
+     * @param y y
+     * @param Occ array to write the sorted suffix array values to
+     */
+    void locate_sorted(pos_t b, pos_t e, pos_t hat_b_ap_y, int64_t y, pos_t* Occ) const requires(supports_multiple_locate);
+
+    /**
+     * @brief decodes SA[b..e] (see decode_occ()) and reports the documents containing the decoded occurrences together
+     * with their numbers of occurrences in increasing order of the documents; this takes O(e-b+1) time, but the
+     * occurrences are never stored, only their documents, which are either counted in an array or sorted (see
+     * max_docs_per_occ_dense)
+     * @param b left interval limit of the suffix array interval
+     * @param e right interval limit of the suffix array interval
+     * @param hat_b_ap_y \hat{b}'_y
+     * @param y y
+     * @param report function that is called with every pair (d,c), where d is a document and c > 0 is the number of
+     * occurrences in d
+     */
+    template <typename report_t>
+    void count_occ_per_document(pos_t b, pos_t e, pos_t hat_b_ap_y, int64_t y, report_t&& report) const requires(supports_multiple_locate);
+
+    /**
+     * @brief reports the documents containing the occurrences of a pattern of length m with the suffix array interval
+     * [b,e] (in no particular order) with Sada's algorithm on the runs of ILCP: range minimum queries over the values
+     * of the runs overlapping [b,e] find the runs with values < m, and in each of them, the positions in [b,e] are the
+     * leftmost ones of their documents, so SA is only decoded there, starting at the sample of the run or at the
+     * toehold SA[b]; this takes O(d_P) range minimum queries and Phi^{-1} move queries, where d_P is the number of
+     * documents containing the pattern (requires has_ilcp())
+     * @param b left interval limit of the suffix array interval
+     * @param e right interval limit of the suffix array interval
+     * @param hat_b_ap_y \hat{b}'_y
+     * @param y y
+     * @param m length of the pattern
+     * @param report function that is called with every document containing the pattern
+     */
+    template <typename report_t>
+    void list_documents_ilcp(pos_t b, pos_t e, pos_t hat_b_ap_y, int64_t y, pos_t m, report_t&& report) const requires(supports_multiple_locate);
+
     /**
      * @brief locates the remaining (not yet reported) occurrences of the currently matched pattern
      * @param i current position in the suffix array
@@ -862,6 +1762,21 @@ class move_r {
         std::vector<pos_t>& Occ
     ) const requires(support == _locate_rlzdsa);
 
+    /**
+     * @brief reports the distinct symbols in L[b..e] (except the terminator) with their suffix array intervals (see
+     * interval_symbols(b,e)); if [b',e'] contains fewer runs than there are symbols, the runs of L' in it are scanned,
+     * which takes time output-sensitive in the number of runs, else each symbol is searched with RS_L'
+     * @param b left interval limit
+     * @param e right interval limit
+     * @param b_ index of the input interval in M_LF containing b
+     * @param e_ index of the input interval in M_LF containing e
+     * @param report function that is called with every tuple (c,b_c,e_c,b__c,e__c) in increasing order of c, where c
+     * is a symbol in the internal effective alphabet and b__c and e__c are the indices of the input intervals in M_LF
+     * containing b_c and e_c
+     */
+    template <typename report_t>
+    void interval_symbols(pos_t b, pos_t e, pos_t b_, pos_t e_, report_t&& report) const;
+
     public:
     /**
      * @brief returns the number of occurrences of P in the input
@@ -870,6 +1785,26 @@ class move_r {
      */
     inline pos_t count(const inp_t& P) const;
 
+    /**
+     * @brief counts the occurrences of each pattern in P; the backward searches of up to batch_width patterns
+     * are interleaved, which hides much of the memory latency if there are many (short) patterns
+     * @param P the patterns to count in the input
+     * @param Occ [0..|P|-1] span to store the numbers of occurrences in (Occ[j] = number of occurrences of P[j])
+     */
+    void count_batch(std::span<const inp_t> P, std::span<pos_t> Occ) const;
+
+    /**
+     * @brief counts the occurrences of each pattern in P (see count_batch(P,Occ))
+     * @param P the patterns to count in the input
+     * @return [0..|P|-1] vector storing the numbers of occurrences of the patterns
+     */
+    inline std::vector<pos_t> count_batch(const std::vector<inp_t>& P) const {
+        std::vector<pos_t> Occ;
+        no_init_resize(Occ,P.size());
+        count_batch(P,Occ);
+        return Occ;
+    }
+
     /**
      * @brief locates the pattern P in the input
      * @param P the pattern to locate in the input
@@ -888,6 +1823,297 @@ class move_r {
      */
     void locate(const inp_t& P, std::vector<pos_t>& Occ) const requires(supports_multiple_locate);
 
+    /**
+     * @brief locates the pattern P in the input and appends the positions of the occurrences to Occ; if P occurs often,
+     * the suffix array interval of P is split into chunks that are decoded in parallel, each starting at the nearest
+     * run sample or suffix array sample (the occurrences are stored in the same order as by locate(P,Occ))
+     * @param P the pattern to locate in the input
+     * @param Occ vector to append the occurrences of P in the input to
+     * @param num_threads maximum number of threads to use (at least min_occ_par_locate occurrences are decoded per thread)
+     */
+    void locate(const inp_t& P, std::vector<pos_t>& Occ, uint16_t num_threads) const requires(supports_multiple_locate);
+
+    /**
+     * @brief parameters for locating only some of the occurrences of a pattern
+     */
+    struct locate_params {
+        pos_t max_occ = std::numeric_limits<pos_t>::max(); // maximum number of occurrences to locate
+        /* false: locate the first max_occ occurrences in suffix array order; true: locate max_occ occurrences that are
+           spread evenly over the suffix array interval (see query_context::locate_spread()) */
+        bool spread = false;
+    };
+
+    /**
+     * @brief locates at most params.max_occ occurrences of the pattern P in the input and appends their positions to
+     * Occ; only these occurrences are decoded, so this takes time independent of the overall number of occurrences
+     * @param P the pattern to locate in the input
+     * @param Occ vector to append the occurrences of P in the input to
+     * @param params parameters
+     */
+    void locate(const inp_t& P, std::vector<pos_t>& Occ, locate_params params) const requires(supports_multiple_locate);
+
+    /**
+     * @brief locates the pattern P in the input and appends the positions of the occurrences to Occ in increasing order;
+     * the digit histograms of an LSD radix sort are counted while decoding the occurrences, so sorting them takes one
+     * pass over the occurrences for each digit that is not equal for all occurrences
+     * @param P the pattern to locate in the input
+     * @param Occ vector to append the (sorted) occurrences of P in the input to
+     */
+    void locate_sorted(const inp_t& P, std::vector<pos_t>& Occ) const requires(supports_multiple_locate);
+
+    /**
+     * @brief locates the pattern P in the input (see locate_sorted(P,Occ))
+     * @param P the pattern to locate in the input
+     * @return a vector containing the occurrences of P in the input in increasing order
+     */
+    inline std::vector<pos_t> locate_sorted(const inp_t& P) const requires(supports_multiple_locate) {
+        std::vector<pos_t> Occ;
+        locate_sorted(P,Occ);
+        return Occ;
+    }
+
+    /**
+     * @brief locates the pattern P in the input and writes the positions of the occurrences to Occ[0..occ-1] in increasing
+     * order (see locate_sorted(P,Occ)), where occ is the number of occurrences of P; if |Occ| < occ, nothing is written
+     * @param P the pattern to locate in the input
+     * @param Occ caller-provided buffer to write the (sorted) occurrences of P in the input to
+     * @return the number of occurrences of P in the input
+     */
+    pos_t locate_sorted(const inp_t& P, std::span<pos_t> Occ) const requires(supports_multiple_locate);
+
+    /**
+     * @brief locates each pattern in P; the backward searches of up to batch_width patterns and the decoding of the
+     * occurrences of up to batch_width patterns are interleaved, which hides much of the memory latency if there are
+     * many patterns; the occurrences of all patterns are appended to Occ, such that the occurrences of P[j] are stored
+     * in Occ[Occ_offs[j]..Occ_offs[j+1]-1]
+     * @param P the patterns to locate in the input
+     * @param Occ vector to append the occurrences of the patterns to
+     * @param Occ_offs vector to store the |P|+1 offsets of the patterns' occurrences in Occ in
+     */
+    void locate_batch(
+        std::span<const inp_t> P,
+        std::vector<pos_t>& Occ, std::vector<uint64_t>& Occ_offs
+    ) const requires(supports_multiple_locate);
+
+    // ############################# MATCHING STATISTICS METHODS #############################
+
+    protected:
+    /**
+     * @brief returns the threshold t_x of the x-th input interval in M_LF (see _THR)
+     * @param x [0..r'-1] the x-th input interval in M_LF must start a bwt run
+     * @return t_x
+     */
+    inline pos_t THR(pos_t x) const {
+        return _THR.template get<0,pos_t>(x);
+    }
+
+    /**
+     * @brief returns SA[M_LF.p[x+1]-1], i.e., the suffix array value at the end position of the x-th input interval in M_LF
+     * @param x [0..r'-1] the end position of the x-th input interval in M_LF must be an end position of a bwt run
+     * @return SA[M_LF.p[x+1]-1]
+     */
+    inline pos_t SA_run_end(pos_t x) const requires(supports_multiple_locate) {
+        if constexpr (uses_m_phi) {
+            return SA_e(x);
+        } else {
+            return _THR.template get<1,pos_t>(x);
+        }
+    }
+
+    /**
+     * @brief computes the matching statistics of P in two passes (the thresholds must have been built): the first pass
+     * matches P from right to left with one LF step per symbol; if L[i] != P[j] at the current position i in the bwt, it
+     * restarts at the end of the previous or at the start of the next bwt run with symbol P[j] (whichever suffix shares
+     * the longer prefix with the one at i, which the threshold of the next run decides) with the suffix array sample
+     * stored there as the toehold, so that the occurrence reached after the LF step is one of the longest matches
+     * (MS_pos); the second pass computes the lengths from left to right by comparing P[j..] with the input at MS_pos[j],
+     * starting at MS_len[j-1]-1 (or skipping the comparison, if MS_pos[j] = MS_pos[j-1]+1), so it compares O(|P|)
+     * symbols in total, which are extracted with extract() (in sections that start at MS_pos[j] for each restart)
+     * @tparam report_pos whether to report MS_pos
+     * @param P a pattern
+     * @param MS_len [0..|P|-1] array to store the lengths of the matching statistics in
+     * @param MS_pos [0..|P|-1] array to store the positions of the matching statistics in (only if report_pos = true)
+     */
+    template <bool report_pos>
+    void matching_statistics(const inp_t& P, pos_t* MS_len, pos_t* MS_pos) const requires(supports_multiple_locate);
+
+    /**
+     * @brief computes the thresholds of the bwt runs from the suffix array and the input (see _THR); the LCP values
+     * are computed with plcp_array(), and the minimum of LCP[e+1..i] is found with a binary search on a stack of the
+     * suffix minima of LCP
+     * @param SA [0..n-1] the suffix array
+     * @param T function that returns T[j] for j in [0..n-2] in the internal effective alphabet
+     * @param THR_r vector to store the thresholds of the bwt runs in (in the order of the runs)
+     * @param SA_e_r vector to store the suffix array values at the end positions of the bwt runs in (in the order of the runs)
+     */
+    template <typename sa_t, typename t_t>
+    void thresholds_of_runs(
+        const sa_t& SA, t_t&& T,
+        std::vector<pos_t>& THR_r, std::vector<pos_t>& SA_e_r
+    ) const requires(supports_multiple_locate);
+
+    /**
+     * @brief stores the thresholds of the bwt runs (see thresholds_of_runs()) at the input intervals of M_LF that start
+     * the runs (and the suffix array values at the end positions of the runs at the input intervals that end them)
+     * @param THR_r thresholds of the bwt runs
+     * @param SA_e_r suffix array values at the end positions of the bwt runs
+     */
+    void build_thresholds(const std::vector<pos_t>& THR_r, const std::vector<pos_t>& SA_e_r) requires(supports_multiple_locate);
+
+    /**
+     * @brief throws std::invalid_argument, if the thresholds have not been built (this cannot be a requires-clause,
+     * because whether they have been built is only known at runtime)
+     */
+    void check_thresholds() const {
+        if (!has_thresholds()) {
+            throw std::invalid_argument("matching statistics require the thresholds (move_r_params::build_thresholds or build_thresholds())");
+        }
+    }
+
+    public:
+    /**
+     * @brief returns whether the thresholds have been built (see move_r_params::build_thresholds)
+     * @return whether the thresholds have been built
+     */
+    inline bool has_thresholds() const {
+        return !_THR.empty();
+    }
+
+    /**
+     * @brief builds the thresholds used by matching_statistics() and maximal_exact_matches() (replaces existing ones),
+     * for which the suffix array and the input are decoded with the index (this needs O(n) words of space temporarily;
+     * with move_r_params::build_thresholds, they are computed during the construction)
+     * @param num_threads maximum number of threads to use
+     * @param log controls, whether to print log messages
+     */
+    void build_thresholds(uint16_t num_threads = omp_get_max_threads(), bool log = false) requires(supports_multiple_locate);
+
+    /**
+     * @brief computes the matching statistics of P, i.e., for each i in [0,|P|-1] the length MS_len[i] of the longest
+     * prefix of P[i..|P|-1] that occurs in the input (requires has_thresholds(), else std::invalid_argument is thrown);
+     * this performs |P| LF steps and O(|P|) symbol comparisons, plus at most sample_rate_isa() LF steps in extract()
+     * for each restart of the first pass (see matching_statistics<report_pos>(P,MS_len,MS_pos)), so it takes linear
+     * time in |P| if the text position samples have been built (see build_isa_samples())
+     * @param P a pattern
+     * @return [0..|P|-1] vector storing the lengths of the matching statistics
+     */
+    std::vector<pos_t> matching_statistics(const inp_t& P) const requires(supports_multiple_locate) {
+        std::vector<pos_t> MS_len;
+        check_thresholds();
+        no_init_resize(MS_len,P.size());
+        matching_statistics<false>(P,MS_len.data(),NULL);
+        return MS_len;
+    }
+
+    /**
+     * @brief computes the matching statistics of P, i.e., for each i in [0,|P|-1] the length MS_len[i] of the longest
+     * prefix of P[i..|P|-1] that occurs in the input and a position MS_pos[i] in the input, at which it occurs
+     * (MS_pos[i] = 0 if MS_len[i] = 0); requires has_thresholds(), else std::invalid_argument is thrown
+     * @param P a pattern
+     * @param MS_len vector to store the |P| lengths of the matching statistics in
+     * @param MS_pos vector to store the |P| positions of the matching statistics in
+     */
+    void matching_statistics(const inp_t& P, std::vector<pos_t>& MS_len, std::vector<pos_t>& MS_pos) const requires(supports_multiple_locate) {
+        check_thresholds();
+        no_init_resize(MS_len,P.size());
+        no_init_resize(MS_pos,P.size());
+        matching_statistics<true>(P,MS_len.data(),MS_pos.data());
+    }
+
+    /**
+     * @brief computes the matching statistics of each pattern in P (see matching_statistics(P)) in parallel
+     * @param P the patterns (e.g. reads)
+     * @param MS_len vector to store the |P| vectors storing the lengths of the matching statistics of the patterns in
+     * @param num_threads maximum number of threads to use
+     */
+    void matching_statistics(
+        std::span<const inp_t> P, std::vector<std::vector<pos_t>>& MS_len,
+        uint16_t num_threads = omp_get_max_threads()
+    ) const requires(supports_multiple_locate);
+
+    /**
+     * @brief computes the maximal exact matches (MEMs) of P with length at least min_len, i.e., the substrings P[i..i+l)
+     * with l >= min_len that occur in the input, but neither P[i-1..i+l) nor P[i..i+l] occurs in the input; they are
+     * derived from the matching statistics of P (requires has_thresholds(), else std::invalid_argument is thrown)
+     * @param P a pattern
+     * @param min_len minimum length of a MEM
+     * @return vector storing a tuple (i,l,t) for each MEM P[i..i+l) (in increasing order of i), where P[i..i+l) occurs
+     * at position t in the input
+     */
+    std::vector<std::tuple<pos_t,pos_t,pos_t>> maximal_exact_matches(const inp_t& P, pos_t min_len = 1) const requires(supports_multiple_locate);
+
+    /**
+     * @brief computes the maximal exact matches (MEMs) of each pattern in P (see maximal_exact_matches(P,min_len)) in parallel
+     * @param P the patterns (e.g. reads)
+     * @param min_len minimum length of a MEM
+     * @param MEMs vector to store the |P| vectors storing the MEMs of the patterns in
+     * @param num_threads maximum number of threads to use
+     */
+    void maximal_exact_matches(
+        std::span<const inp_t> P, pos_t min_len,
+        std::vector<std::vector<std::tuple<pos_t,pos_t,pos_t>>>& MEMs,
+        uint16_t num_threads = omp_get_max_threads()
+    ) const requires(supports_multiple_locate);
+
+    public:
+    /**
+     * @brief parameters for approximate pattern matching
+     */
+    struct approx_params {
+        pos_t k = 1; // maximum number of errors
+        bool edits = false; // false: only allow mismatches (hamming distance); true: allow mismatches, insertions and deletions (edit distance)
+        uint16_t num_threads = 1; // maximum number of threads to use
+    };
+
+    /**
+     * @brief an approximate match of a pattern, i.e., a substring of the input within distance k of the pattern
+     */
+    struct approx_match {
+        pos_t b; // left interval limit of the suffix array interval of the matched substring
+        pos_t e; // right interval limit of the suffix array interval of the matched substring
+        pos_t length; // length of the matched substring
+        pos_t errors; // (minimum) number of errors between the pattern and the matched substring
+
+        auto operator<=>(const approx_match&) const = default;
+    };
+
+    /**
+     * @brief finds the distinct substrings of the input within hamming- or edit distance params.k of P by backtracking
+     * over query contexts, i.e., the pattern is matched from right to left and at each position, every symbol is tried
+     * that extends the current match; branches that exceed params.k errors are pruned, and if the index is bidirectional,
+     * also branches that cannot be completed within params.k errors, because of a lower bound table that is computed
+     * with append(); the branches near the root of the search tree are explored in parallel tasks; insertions before the
+     * first or after the last pattern symbol are not considered, because they only extend a match with fewer errors
+     * @param P the pattern to search for
+     * @param params parameters
+     * @return the matches in increasing order of (b,e,length); each matched substring occurs at SA[b..e]
+     */
+    std::vector<approx_match> approximate_matches(const inp_t& P, approx_params params) const;
+
+    protected:
+    /**
+     * @brief state of an approximate pattern matching search that is shared by all branches
+     */
+    struct approx_search {
+        const inp_t* P; // the pattern
+        approx_params params; // parameters
+        std::vector<pos_t> D; // [0..|P|], D[i] = lower bound for the number of errors in P[0..i-1]
+        std::vector<std::vector<approx_match>> matches; // [0..p-1] matches found by each thread
+    };
+
+    /**
+     * @brief explores a branch of an approximate pattern matching search, in which P[i..|P|-1] has been matched
+     * with errors errors to the pattern of the query context
+     * @param search the search
+     * @param query query context storing the currently matched substring
+     * @param i number of pattern symbols that have not been matched yet
+     * @param errors number of errors in the current branch
+     * @param depth depth of the branch in the search tree
+     */
+    void approximate_matches(approx_search* search, query_context query, pos_t i, pos_t errors, uint8_t depth) const;
+
+    public:
+
     // ############################# RETRIEVE-RANGE METHODS #############################
 
     struct retrieve_params {
@@ -910,7 +2136,7 @@ class move_r {
             params.r = range_max;
         }
 
-        params.r = std::max(params.r,range_max);
+        params.r = std::min(params.r,range_max);
     }
 
     /**
@@ -981,7 +2207,8 @@ class move_r {
     /**
      * @brief reports the characters in the input in the range [l,r] (0 <= l <= r < input size), else if l > r, then
      * all characters of the input are reported (default); if num_threads = 1, then the values are reported from right
-     * to left, if num_threads > 1, the order may vary
+     * to left, if num_threads > 1, the order may vary; without text position samples, at most max_revert_threads()
+     * threads are used, else the range is split into num_threads parts that start at the nearest samples
      * @param report function that is called with every tuple (i,c) as a parameter, where i in [l,r] and c = input[i]
      * @param params parameters
      */
@@ -1032,6 +2259,333 @@ class move_r {
         retrieve_range<pos_t,false>(&move_r<support,sym_t,pos_t>::SA,file_name,params);
     }
 
+    // ############################# ROW REORDERING #############################
+
+    /**
+     * @brief stores copies of M_LF (with L') and M_Phi^{-1} (for _locate_move and _locate_move_bi), whose rows are
+     * ordered by the first time reverting the input (for M_LF) and decoding SA[0..n-1] with Phi^{-1} (for
+     * M_Phi^{-1}) visit them; on repetitive inputs, the repeated regions then use consecutive rows, so chains of
+     * move queries access fewer cache lines and pages (this only pays off, if the rows do not fit into the cache,
+     * because the reordered rows are wider); the reordered rows of M_LF are used by revert(), extract()
+     * and ISA(j), and the ones of M_Phi^{-1} by SA(i), SA(l,r), all locate methods (sequential, parallel, batched,
+     * sorted, limited and spread, and the Phi^{-1} half of _locate_move_bi), the document queries and
+     * query_context::locate()/next_occ() (next_occ() translates the row index on every call, so it gains little);
+     * backward search and the Phi steps of _locate_move_bi use the original rows; the copies take
+     * O(r+r'') words of additional space, are built in O(n) time and are not serialized (call this again after
+     * loading the index)
+     * @param num_threads maximum number of threads to use
+     * @param log controls, whether to print log messages
+     */
+    void reorder_rows(uint16_t num_threads = omp_get_max_threads(), bool log = false);
+
+    /**
+     * @brief removes the reordered copies of M_LF and M_Phi^{-1} that have been built by reorder_rows()
+     */
+    void clear_reordered_rows() {
+        _M_LF_ro = move_data_structure_reordered<pos_t,i_sym_t>();
+        _M_Phi_m1_ro = move_data_structure_reordered<pos_t>();
+    }
+
+    // ############################# EXTRACT METHODS #############################
+
+    /**
+     * @brief builds the text position samples ISA_s (replaces existing ones); for every sample_rate-th text position
+     * j, the position i in the bwt with L[i] = T[j] and the index of the input interval in M_LF containing i are stored,
+     * which takes O(n/sample_rate) words of space; the samples are collected while reverting the index in parallel
+     * @param sample_rate sample rate (1 <= sample_rate)
+     * @param num_threads maximum number of threads to use
+     * @param log controls, whether to print log messages
+     */
+    void build_isa_samples(pos_t sample_rate, uint16_t num_threads = omp_get_max_threads(), bool log = false);
+
+    /**
+     * @brief reports the characters in the input in the range [l,r] (0 <= l <= r < input size) from right to left;
+     * if the text position samples have been built, this performs at most r-l+sample_rate_isa() LF steps, else it
+     * falls back to revert({.l=l,.r=r,.num_threads=1}), which reverts the whole section of the input containing r
+     * @param l left range limit
+     * @param r right range limit
+     * @param report function that is called with every tuple (j,c) as a parameter, where j in [l,r] and c = input[j]
+     */
+    template <typename report_t>
+    void extract(pos_t l, pos_t r, report_t&& report) const;
+
+    /**
+     * @brief returns the input in the range [l,r] (0 <= l <= r < input size), see extract(l,r,report)
+     * @param l left range limit
+     * @param r right range limit
+     * @return the input range [l,r]
+     */
+    inp_t extract(pos_t l, pos_t r) const {
+        inp_t T_lr;
+        if (r > n-2) r = n-2;
+        if (l > r) return T_lr;
+        no_init_resize(T_lr,r-l+1);
+        extract(l,r,[&T_lr,&l](pos_t j, sym_t c){T_lr[j-l] = c;});
+        return T_lr;
+    }
+
+    // ############################# DOCUMENT METHODS #############################
+
+    protected:
+    /**
+     * @brief builds the document array (replaces an existing one) from the starting positions of the documents in the
+     * input, without the ILCP runs
+     * @param doc_starts strictly increasing starting positions of the documents in the input (each < input size); 0 is
+     * always a document start, even if it is not contained in doc_starts
+     */
+    template <typename int_t>
+    void build_document_starts(const std::vector<int_t>& doc_starts);
+
+    /**
+     * @brief builds the run-length encoded ILCP (see _ILCP_R) from the suffix array and the input (requires the
+     * document array); ILCP[i] is the minimum of the LCP values after the last position of the document of SA[i] up
+     * to i, which is found with a binary search on a stack of the suffix minima of LCP (see plcp_array())
+     * @param SA [0..n-1] the suffix array
+     * @param T function that returns T[j] for j in [0..n-2]
+     * @param log controls, whether to print log messages
+     */
+    template <typename sa_t, typename t_t>
+    void build_ilcp(const sa_t& SA, t_t&& T, bool log) requires(supports_multiple_locate);
+
+    public:
+    /**
+     * @brief builds the document array (replaces an existing one) from the starting positions of the documents in the
+     * input; it is stored as a compressed bit vector marking the document starts, which takes O(d log(n/d)) bits of
+     * space, where d is the number of documents; for _locate_move, _locate_move_bi and _locate_rlzdsa, this also
+     * builds the ILCP runs used by list_documents(), for which the suffix array and the input are decoded with the
+     * index (this needs O(n) words of space temporarily; with move_r_params::doc_starts, the ILCP runs are computed
+     * during the construction instead)
+     * @param doc_starts strictly increasing starting positions of the documents in the input (each < input size); 0 is
+     * always a document start, even if it is not contained in doc_starts
+     * @param num_threads maximum number of threads to use
+     * @param log controls, whether to print log messages
+     */
+    void build_document_array(
+        const std::vector<pos_t>& doc_starts, uint16_t num_threads = omp_get_max_threads(), bool log = false
+    );
+
+    /**
+     * @brief builds the document array (replaces an existing one), s.t. every occurrence of separator ends a document
+     * (see build_document_array(doc_starts)); the occurrences of separator are located with the index
+     * @param separator the symbol that separates the documents in the input
+     * @param num_threads maximum number of threads to use
+     * @param log controls, whether to print log messages
+     */
+    void build_document_array(
+        sym_t separator, uint16_t num_threads = omp_get_max_threads(), bool log = false
+    ) requires(supports_multiple_locate);
+
+    /**
+     * @brief returns whether the ILCP runs have been built (see build_document_array())
+     * @return whether the ILCP runs have been built
+     */
+    inline bool has_ilcp() const {
+        return !_ILCP_R.empty();
+    }
+
+    /**
+     * @brief returns the number of documents (1 if the document array has not been built)
+     * @return the number of documents
+     */
+    inline pos_t num_documents() const {
+        return _DS.empty() ? 1 : _DS.num_ones();
+    }
+
+    /**
+     * @brief returns the document containing the input position j
+     * @param j [0..input size-1] position in the input
+     * @return [0..num_documents()-1] the document containing position j
+     */
+    inline pos_t document(pos_t j) const {
+        return _DS.empty() ? 0 : _DS.rank_1(j+1)-1;
+    }
+
+    /**
+     * @brief returns the starting position of the document d in the input
+     * @param d [0..num_documents()-1] a document
+     * @return the starting position of document d in the input
+     */
+    inline pos_t document_start(pos_t d) const {
+        return _DS.empty() ? 0 : _DS.select_1(d+1);
+    }
+
+    /**
+     * @brief appends the documents that contain P to Docs in increasing order; if the ILCP runs have been built, only
+     * the leftmost occurrence of P in each document is decoded (see list_documents_ilcp()), else all occurrences are
+     * @param P the pattern to search for
+     * @param Docs vector to append the documents to
+     */
+    void list_documents(const inp_t& P, std::vector<pos_t>& Docs) const requires(supports_multiple_locate);
+
+    /**
+     * @brief returns the documents that contain P (see list_documents(P,Docs))
+     * @param P the pattern to search for
+     * @return a vector containing the documents that contain P in increasing order
+     */
+    inline std::vector<pos_t> list_documents(const inp_t& P) const requires(supports_multiple_locate) {
+        std::vector<pos_t> Docs;
+        list_documents(P,Docs);
+        return Docs;
+    }
+
+    /**
+     * @brief returns for each document that contains P the number of occurrences of P in it; unless P only occurs in
+     * one document (which is checked with the ILCP runs, if they have been built), all occurrences of P are decoded
+     * (see count_occ_per_document())
+     * @param P the pattern to search for
+     * @return a vector containing the pairs (d,c), where d is a document that contains P and c is the number of
+     * occurrences of P in d, in increasing order of d
+     */
+    std::vector<std::pair<pos_t,pos_t>> count_per_document(const inp_t& P) const requires(supports_multiple_locate);
+
+    /**
+     * @brief returns the (at most) k documents that contain P most often (see count_per_document())
+     * @param P the pattern to search for
+     * @param k maximum number of documents to return
+     * @return a vector containing the pairs (d,c), where d is a document that contains P and c is the number of
+     * occurrences of P in d, in decreasing order of c (documents with equal c are in increasing order of d)
+     */
+    std::vector<std::pair<pos_t,pos_t>> top_k_documents(const inp_t& P, pos_t k) const requires(supports_multiple_locate);
+
+    // ############################# LCP METHODS #############################
+
+    protected:
+    /**
+     * @brief computes PLCP from the suffix array and the input with Kasai's algorithm (O(n) time and n words of space)
+     * @param SA [0..n-1] the suffix array
+     * @param T function that returns T[j] for j in [0..n-2]
+     * @return [0..n-1] PLCP
+     */
+    template <typename sa_t, typename t_t>
+    std::vector<pos_t> plcp_array(const sa_t& SA, t_t&& T) const;
+
+    public:
+    /**
+     * @brief returns whether the PLCP samples have been built (see move_r_params::build_lcp)
+     * @return whether the PLCP samples have been built
+     */
+    inline bool has_lcp() const {
+        return !_PLCP_I.empty();
+    }
+
+    /**
+     * @brief returns PLCP[j], i.e., the length of the longest common prefix of the suffix of the input starting at j
+     * and the suffix preceding it in the suffix array; if j_k is the largest irreducible position with j_k <= j, then
+     * PLCP[j] = PLCP[j_k]-(j-j_k), so only the r irreducible values are stored (requires has_lcp())
+     * @param j [0..input size] position in the input
+     * @return PLCP[j]
+     */
+    inline pos_t PLCP(pos_t j) const {
+        pos_t k = _PLCP_I.rank_1(j+1)-1;
+        return _PLCP_s.template get<0,pos_t>(k)-(j-_PLCP_I.select_1(k+1));
+    }
+
+    /**
+     * @brief returns LCP[i] = PLCP[SA[i]], i.e., the length of the longest common prefix of the suffixes at the
+     * positions i-1 and i in the suffix array (LCP[0] = 0; requires has_lcp())
+     * @param i [0..input size] position in the suffix array
+     * @return LCP[i]
+     */
+    inline pos_t LCP(pos_t i) const requires(supports_multiple_locate) {
+        return PLCP(SA(i));
+    }
+
+    /**
+     * @brief returns the lcp array in the range [b,e] (0 <= b <= e <= input size); the suffix array values in [b,e]
+     * are decoded with SA(report,params), so this takes O(e-b+1) time plus the time to access SA[b] (requires has_lcp())
+     * @param b left range limit
+     * @param e right range limit
+     * @param num_threads maximum number of threads to use
+     * @return the lcp array range [b,e]
+     */
+    std::vector<pos_t> lcp_range(pos_t b, pos_t e, uint16_t num_threads = 1) const requires(supports_multiple_locate) {
+        std::vector<pos_t> LCP_range;
+        if (e > n-1) e = n-1;
+        if (b > e) return LCP_range;
+        no_init_resize(LCP_range,e-b+1);
+
+        SA([this,&LCP_range,&b](pos_t i, pos_t s){
+            LCP_range[i-b] = PLCP(s);
+        },{.l = b, .r = e, .num_threads = num_threads});
+
+        return LCP_range;
+    }
+
+    // ############################# K-MER METHODS #############################
+
+    /**
+     * @brief parameters for enumerating the k-mers of the input
+     */
+    struct kmer_params {
+        pos_t min_freq = 1; // minimum frequency of a k-mer to report
+        pos_t max_freq = std::numeric_limits<pos_t>::max(); // maximum frequency of a k-mer to report
+        uint16_t num_threads = omp_get_max_threads(); // maximum number of threads to use
+    };
+
+    /**
+     * @brief reports the distinct k-mers of the input with their frequencies; the k-mers are enumerated by a depth-k
+     * search over the suffix array intervals, in which each interval is extended to the left with all symbols that
+     * precede it (see interval_symbols()), so it takes time proportional to the number of runs in the visited intervals
+     * instead of O(n); the subtrees of the intervals of the first few levels are searched in parallel; intervals with
+     * a frequency less than params.min_freq are not extended
+     * @param k length of the k-mers (1 <= k)
+     * @param report function that is called with every pair (kmer,frequency), where params.min_freq <= frequency <=
+     * params.max_freq; it is called concurrently by up to params.num_threads threads in no particular order
+     * @param params parameters
+     */
+    void kmers(pos_t k, const std::function<void(const inp_t&,pos_t)>& report, kmer_params params = {}) const;
+
+    /**
+     * @brief returns the distinct k-mers of the input with their frequencies (see kmers(k,report,params))
+     * @param k length of the k-mers (1 <= k)
+     * @param params parameters
+     * @return the pairs (kmer,frequency) in increasing order of the k-mers
+     */
+    std::vector<std::pair<inp_t,pos_t>> kmers(pos_t k, kmer_params params = {}) const {
+        std::vector<std::pair<inp_t,pos_t>> K;
+
+        kmers(k,[&K](const inp_t& kmer, pos_t freq){
+            #pragma omp critical
+            {
+                K.emplace_back(kmer,freq);
+            }
+        },params);
+
+        std::sort(K.begin(),K.end());
+        return K;
+    }
+
+    /**
+     * @brief writes the distinct k-mers of the input with their frequencies (see kmers(k,report,params)) to the file
+     * file_name in no particular order; each record consists of the k symbols of the k-mer (sizeof(sym_t) bytes each),
+     * followed by its frequency (sizeof(pos_t) bytes)
+     * @param k length of the k-mers (1 <= k)
+     * @param file_name name of the file to write the k-mers to
+     * @param params parameters
+     * @return the number of distinct k-mers written to the file
+     */
+    uint64_t write_kmers(pos_t k, std::string file_name, kmer_params params = {}) const;
+
+    protected:
+    /**
+     * @brief reports the k-mers with the suffix kmer[k-d..k-1] (see kmers(k,report,params))
+     * @param k length of the k-mers
+     * @param d length of the current suffix
+     * @param b left interval limit of the suffix array interval of the current suffix
+     * @param e right interval limit of the suffix array interval of the current suffix
+     * @param b_ index of the input interval in M_LF containing b
+     * @param e_ index of the input interval in M_LF containing e
+     * @param kmer [0..k-1] buffer storing the current suffix in kmer[k-d..k-1]
+     * @param report function that is called with every pair (kmer,frequency)
+     * @param params parameters
+     */
+    void kmers(
+        pos_t k, pos_t d, pos_t b, pos_t e, pos_t b_, pos_t e_, inp_t& kmer,
+        const std::function<void(const inp_t&,pos_t)>& report, const kmer_params& params
+    ) const;
+
+    public:
+
     // ############################# SERIALIZATION METHODS #############################
 
     /**
@@ -1075,12 +2629,18 @@ class move_r {
 
         if constexpr (support == _locate_one) {
             _SA_s.serialize(out);
-        } else if constexpr (support == _locate_move) {
+        } else if constexpr (uses_m_phi_m1) {
             out.write((char*)&r__,sizeof(pos_t));
             _M_Phi_m1.serialize(out);
 
             out.write((char*)&omega_idx,1);
             _SA_Phi_m1.serialize(out);
+
+            if constexpr (uses_m_phi) {
+                out.write((char*)&r___,sizeof(pos_t));
+                _M_Phi.serialize(out);
+                _SA_Phi.serialize(out);
+            }
         } else if constexpr (support == _locate_rlzdsa) {
             out.write((char*)&z,sizeof(pos_t));
             out.write((char*)&z_l,sizeof(pos_t));
@@ -1095,6 +2655,53 @@ class move_r {
             _PT.serialize(out);
         }
 
+        out.write((char*)&bidirectional,1);
+        if (bidirectional) {
+            out.write((char*)&r_rev,sizeof(pos_t));
+            _M_LF_rev.serialize(out);
+            _RS_L__rev.serialize(out);
+
+            if constexpr (supports_locate) {
+                _SA_s_rev.serialize(out);
+            }
+        }
+
+        out.write((char*)&sr_isa,sizeof(pos_t));
+        if (sr_isa != 0) {
+            _ISA_s.serialize(out);
+        }
+
+        bool has_documents = !_DS.empty();
+        out.write((char*)&has_documents,1);
+        if (has_documents) {
+            _DS.serialize(out);
+        }
+
+        bool has_plcp = has_lcp();
+        out.write((char*)&has_plcp,1);
+        if (has_plcp) {
+            _PLCP_I.serialize(out);
+            _PLCP_s.serialize(out);
+        }
+
+        out.write((char*)&sr_sa,sizeof(pos_t));
+        if (sr_sa != 0) {
+            _SA_sr.serialize(out);
+        }
+
+        bool has_ilcp_runs = has_ilcp();
+        out.write((char*)&has_ilcp_runs,1);
+        if (has_ilcp_runs) {
+            _ILCP_R.serialize(out);
+            _ILCP_V.serialize(out);
+            _ILCP_RMQ.serialize(out);
+            if constexpr (uses_m_phi_m1) _ILCP_SA.serialize(out);
+        }
+
+        bool has_thr = has_thresholds();
+        out.write((char*)&has_thr,1);
+        if (has_thr) _THR.serialize(out);
+
         std::streamoff offs_end = out.tellp()-pos_data_structure_offsets;
         out.seekp(pos_data_structure_offsets,std::ios::beg);
         out.write((char*)&offs_end,sizeof(std::streamoff));
@@ -1160,12 +2767,18 @@ class move_r {
 
         if constexpr (support == _locate_one) {
             _SA_s.load(in);
-        } else if constexpr (support == _locate_move) {
+        } else if constexpr (uses_m_phi_m1) {
             in.read((char*)&r__,sizeof(pos_t));
             _M_Phi_m1.load(in);
 
             in.read((char*)&omega_idx,1);
             _SA_Phi_m1.load(in);
+
+            if constexpr (uses_m_phi) {
+                in.read((char*)&r___,sizeof(pos_t));
+                _M_Phi.load(in);
+                _SA_Phi.load(in);
+            }
         } else if constexpr (support == _locate_rlzdsa) {
             in.read((char*)&z,sizeof(pos_t));
             in.read((char*)&z_l,sizeof(pos_t));
@@ -1181,7 +2794,97 @@ class move_r {
             _PT.load(in);
         }
 
+        // indexes that have been serialized before bidirectional indexes were supported end here
+        bidirectional = false;
+        if (in.tellg()-pos_data_structure_offsets < offs_end) {
+            in.read((char*)&bidirectional,1);
+        }
+
+        if (bidirectional) {
+            in.read((char*)&r_rev,sizeof(pos_t));
+            _M_LF_rev.load(in);
+            _RS_L__rev.load(in);
+
+            if constexpr (supports_locate) {
+                _SA_s_rev.load(in);
+            }
+        }
+
+        // indexes that have been serialized before text position samples were supported end here
+        sr_isa = 0;
+        if (in.tellg()-pos_data_structure_offsets < offs_end) {
+            in.read((char*)&sr_isa,sizeof(pos_t));
+        }
+
+        if (sr_isa != 0) {
+            _ISA_s.load(in);
+        }
+
+        // indexes that have been serialized before documents were supported end here
+        bool has_documents = false;
+        if (in.tellg()-pos_data_structure_offsets < offs_end) {
+            in.read((char*)&has_documents,1);
+        }
+
+        _DS = sd_array<pos_t>();
+        if (has_documents) {
+            _DS.load(in);
+        }
+
+        // indexes that have been serialized before the PLCP samples were supported end here
+        bool has_plcp = false;
+        if (in.tellg()-pos_data_structure_offsets < offs_end) {
+            in.read((char*)&has_plcp,1);
+        }
+
+        _PLCP_I = sd_array<pos_t>();
+        _PLCP_s = interleaved_vectors<pos_t,pos_t>();
+        if (has_plcp) {
+            _PLCP_I.load(in);
+            _PLCP_s.load(in);
+        }
+
+        // indexes that have been serialized before suffix array samples were supported end here
+        sr_sa = 0;
+        if (in.tellg()-pos_data_structure_offsets < offs_end) {
+            in.read((char*)&sr_sa,sizeof(pos_t));
+        }
+
+        _SA_sr = interleaved_vectors<pos_t,pos_t>();
+        if (sr_sa != 0) {
+            _SA_sr.load(in);
+        }
+
+        // indexes that have been serialized before the ILCP runs were supported end here
+        bool has_ilcp_runs = false;
+        if (in.tellg()-pos_data_structure_offsets < offs_end) {
+            in.read((char*)&has_ilcp_runs,1);
+        }
+
+        _ILCP_R = sd_array<pos_t>();
+        _ILCP_V = interleaved_vectors<pos_t,pos_t>();
+        _ILCP_RMQ = sdsl::rmq_succinct_sct<>();
+        _ILCP_SA = interleaved_vectors<pos_t,pos_t>();
+        if (has_ilcp_runs) {
+            _ILCP_R.load(in);
+            _ILCP_V.load(in);
+            _ILCP_RMQ.load(in);
+            if constexpr (uses_m_phi_m1) _ILCP_SA.load(in);
+        }
+
+        // indexes that have been serialized before the thresholds were supported end here
+        bool has_thr = false;
+        if (in.tellg()-pos_data_structure_offsets < offs_end) {
+            in.read((char*)&has_thr,1);
+        }
+
+        _THR = interleaved_vectors<pos_t,pos_t>();
+        if (has_thr) _THR.load(in);
+
         in.seekg(pos_data_structure_offsets+offs_end,std::ios::beg);
+
+        // the reordered rows are not serialized, so the ones of a previously loaded index are removed
+        clear_reordered_rows();
     }
 
     std::ostream& operator>>(std::ostream& os) const {
@@ -1,59 +1,108 @@
+#include <sstream>
 #include <gtest/gtest.h>
 #include <move_r/data_structures/move_data_structure/move_data_structure.hpp>
 #include <move_r/data_structures/move_data_structure/move_data_structure_l_.hpp>
+#include <move_r/data_structures/move_data_structure/move_data_structure_packed.hpp>
+#include <move_r/data_structures/move_data_structure/move_data_structure_reordered.hpp>
 
-TEST(test_move_data_structure,fuzzy_test) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    uint16_t max_num_threads = omp_get_max_threads();
+std::random_device rd;
+std::mt19937 gen(rd());
+uint16_t max_num_threads = omp_get_max_threads();
 
-    std::uniform_int_distribution<uint32_t> input_size_distrib(1,200000);
-    std::lognormal_distribution<double> avg_interval_length_distrib(4.0,2.0);
-    std::uniform_int_distribution<uint16_t> num_threads_distrib(1,max_num_threads);
-    std::lognormal_distribution<double> a_distrib(2.0,3.0);
+std::uniform_int_distribution<uint32_t> input_size_distrib(1,200000);
+std::lognormal_distribution<double> avg_interval_length_distrib(4.0,2.0);
+std::uniform_int_distribution<uint16_t> num_threads_distrib(1,max_num_threads);
+std::lognormal_distribution<double> a_distrib(2.0,3.0);
+std::uniform_int_distribution<uint16_t> l__distrib(0,3);
 
-    uint32_t input_size;
-    uint32_t num_intervals;
-    std::vector<std::pair<uint32_t,uint32_t>> interval_sequence;
-    std::vector<uint32_t> interval_permutation;
+uint32_t input_size;
+uint32_t num_intervals;
+uint16_t a;
+std::vector<std::pair<uint32_t,uint32_t>> interval_sequence;
+std::vector<uint32_t> interval_permutation;
+std::vector<uint32_t> query_positions; // roughly evenly distributed input values in [0,input_size) to start move queries with
 
-    auto start_time = now();
+// each test runs for this many minutes, such that all tests together run for one hour
+constexpr uint64_t test_duration_min = 12;
 
-    // generate random disjoint interval sequences and test the move data structure until one hour has passed
-    while (time_diff_min(start_time,now()) < 60) {
-        // choose a random input size
-        input_size = input_size_distrib(gen);
-        num_intervals = 0;
-
-        // choose input intervals of random lengths
-        std::uniform_int_distribution<uint32_t> interval_length_distrib(1,2*avg_interval_length_distrib(gen));
-        uint32_t interval_length_prefix_sum = 0;
-        interval_sequence.emplace_back(std::make_pair(0,0));
-        while (interval_length_prefix_sum < input_size) {
-            interval_length_prefix_sum = std::min<uint32_t>(
-                interval_length_prefix_sum+interval_length_distrib(gen),
-                input_size
-            );
-            interval_sequence.emplace_back(std::make_pair(interval_length_prefix_sum,0));
-            num_intervals++;
-        }
+/**
+ * @brief generates a random disjoint interval sequence, a random balancing parameter and the positions to start move
+ * queries with (all random values are drawn here, so that the parallel loops of the tests do not use gen)
+ */
+void generate_interval_sequence() {
+    // choose a random input size
+    input_size = input_size_distrib(gen);
+    num_intervals = 0;
+    interval_sequence.clear();
 
-        // permute the input intervals randomly into the output intervals
-        no_init_resize(interval_permutation,num_intervals);
-        #pragma omp parallel for num_threads(max_num_threads)
-        for (uint32_t i=0; i<num_intervals; i++) {
-            interval_permutation[i] = i;
-        }
-        std::shuffle(interval_permutation.begin(),interval_permutation.end(),gen);
-        interval_length_prefix_sum = 0;
-        for (uint32_t i=0; i<num_intervals; i++) {
-            interval_sequence[interval_permutation[i]].second = interval_length_prefix_sum;
-            interval_length_prefix_sum += interval_sequence[interval_permutation[i]+1].first-interval_sequence[interval_permutation[i]].first;
-        }
-        interval_sequence.pop_back();
+    // choose input intervals of random lengths
+    std::uniform_int_distribution<uint32_t> interval_length_distrib(1,2*avg_interval_length_distrib(gen));
+    uint32_t interval_length_prefix_sum = 0;
+    interval_sequence.emplace_back(std::make_pair(0,0));
+    while (interval_length_prefix_sum < input_size) {
+        interval_length_prefix_sum = std::min<uint32_t>(
+            interval_length_prefix_sum+interval_length_distrib(gen),
+            input_size
+        );
+        interval_sequence.emplace_back(std::make_pair(interval_length_prefix_sum,0));
+        num_intervals++;
+    }
+
+    // permute the input intervals randomly into the output intervals
+    no_init_resize(interval_permutation,num_intervals);
+    #pragma omp parallel for num_threads(max_num_threads)
+    for (uint32_t i=0; i<num_intervals; i++) {
+        interval_permutation[i] = i;
+    }
+    std::shuffle(interval_permutation.begin(),interval_permutation.end(),gen);
+    interval_length_prefix_sum = 0;
+    for (uint32_t i=0; i<num_intervals; i++) {
+        interval_sequence[interval_permutation[i]].second = interval_length_prefix_sum;
+        interval_length_prefix_sum += interval_sequence[interval_permutation[i]+1].first-interval_sequence[interval_permutation[i]].first;
+    }
+    interval_sequence.pop_back();
+
+    // choose a random value for the balancing parameter a
+    a = std::min<uint16_t>(2+a_distrib(gen),32767);
 
-        // choose a random value for the balancing parameter a
-        uint16_t a = std::min<uint16_t>(2+a_distrib(gen),32767);
+    // choose at most ~10000 roughly evenly distributed input values in the range [0,input_size)
+    uint32_t avg_step_size = std::max<uint32_t>(2,input_size/10000);
+    std::uniform_int_distribution<uint32_t> step_size_distrib(avg_step_size/1.5,1.5*avg_step_size);
+    query_positions.clear();
+    for (uint32_t i=0; i<input_size; i+=std::max<uint32_t>(1,step_size_distrib(gen))) {
+        query_positions.emplace_back(i);
+    }
+}
+
+/**
+ * @brief returns the pair (i,x), where x is the index of the input interval of mds containing i
+ * @param mds a move data structure
+ * @param i an input value
+ * @return (i,x)
+ */
+template <typename mds_t>
+std::pair<uint32_t,uint32_t> input_pair(const mds_t& mds, uint32_t i) {
+    return {i,bin_search_max_leq<uint32_t>(i,0,mds.num_intervals()-1,[&mds](uint32_t x){return mds.p(x);})};
+}
+
+/**
+ * @brief builds a move data structure with L' from the interval sequence and fills L' with random values
+ * @return the move data structure
+ */
+move_data_structure_l_<uint32_t,uint8_t,_l_interleaved> build_mds_l_() {
+    move_data_structure_l_<uint32_t,uint8_t,_l_interleaved> mds_l_i(interval_sequence,input_size,{
+        .num_threads = num_threads_distrib(gen), .a = a
+    });
+    for (uint32_t x=0; x<mds_l_i.num_intervals(); x++) mds_l_i.set_L_(x,l__distrib(gen));
+    return mds_l_i;
+}
+
+TEST(test_move_data_structure,fuzzy_test) {
+    auto start_time = now();
+
+    // generate random disjoint interval sequences and test the move data structure
+    while (time_diff_min(start_time,now()) < test_duration_min) {
+        generate_interval_sequence();
 
         // build a move data structure from the disjoint interval sequence
         move_data_structure<uint32_t> mds(interval_sequence,input_size,{
@@ -75,25 +124,278 @@ TEST(test_move_data_structure,fuzzy_test) {
             EXPECT_LE(num_intervals_in_output_interval,2*a);
         }
 
-        // perform at most ~10000 move queries starting with roughly evenly distributed input values in the range [0,input_size)
-        // using the move data structure and the original interval sequence and compare the output values
-        uint32_t avg_step_size = std::max<uint32_t>(2,input_size/10000);
-        std::uniform_int_distribution<uint32_t> step_size_distrib(avg_step_size/1.5,1.5*avg_step_size);
+        // perform move queries using the move data structure and the original interval sequence and compare the output values
         #pragma omp parallel for num_threads(max_num_threads)
-        for (uint32_t i=0; i<input_size; i+=step_size_distrib(gen)) {
-            std::pair<uint32_t,uint32_t> ix_mds{i,
-                bin_search_max_leq<uint32_t>(i,0,mds.num_intervals()-1,[&mds](uint32_t x){return mds.p(x);})
-            };
+        for (uint32_t k=0; k<query_positions.size(); k++) {
+            uint32_t i = query_positions[k];
+            std::pair<uint32_t,uint32_t> ix_mds = input_pair(mds,i);
             std::pair<uint32_t,uint32_t> ix_is{i,
-                bin_search_max_leq<uint32_t>(i,0,num_intervals-1,[&interval_sequence](uint32_t x){return interval_sequence[x].first;})
+                bin_search_max_leq<uint32_t>(i,0,num_intervals-1,[](uint32_t x){return interval_sequence[x].first;})
             };
-            ix_mds = mds.move(ix_mds);
+            std::pair<uint32_t,uint32_t> ix_mds_fast = mds.move<_move_fast>(ix_mds);
+            ix_mds = mds.move<_move_plain>(ix_mds);
+            EXPECT_EQ(ix_mds,ix_mds_fast);
             ix_is.first = interval_sequence[ix_is.second].second + (ix_is.first - interval_sequence[ix_is.second].first);
             EXPECT_EQ(ix_mds.first,ix_is.first);
             // also check if the index of the input interval containing the output value has been calculated correctly
             EXPECT_TRUE(mds.p(ix_mds.second) <= ix_mds.first && ix_mds.first < mds.p(ix_mds.second+1));
         }
+    }
+}
+
+TEST(test_move_data_structure,fixed_widths) {
+    auto start_time = now();
 
-        interval_sequence.clear();
+    while (time_diff_min(start_time,now()) < test_duration_min) {
+        generate_interval_sequence();
+        move_data_structure<uint32_t> mds(interval_sequence,input_size,{
+            .num_threads = num_threads_distrib(gen), .a = a
+        });
+        move_data_structure_l_<uint32_t,uint8_t,_l_interleaved> mds_l_i = build_mds_l_();
+
+        // check if the view with compile-time widths (if the widths of mds are specialized) answers the same queries
+        mds.with_fixed_widths([&](const auto& mds_f){
+            EXPECT_EQ(mds_f.num_intervals(),mds.num_intervals());
+            #pragma omp parallel for num_threads(max_num_threads)
+            for (uint32_t x=0; x<=mds.num_intervals(); x++) {
+                EXPECT_EQ(mds_f.p(x),mds.p(x));
+                if (x < mds.num_intervals()) {
+                    EXPECT_EQ(mds_f.idx(x),mds.idx(x));
+                    EXPECT_EQ(mds_f.offs(x),mds.offs(x));
+                    EXPECT_EQ(mds_f.q(x),mds.q(x));
+                }
+            }
+            #pragma omp parallel for num_threads(max_num_threads)
+            for (uint32_t k=0; k<query_positions.size(); k++) {
+                std::pair<uint32_t,uint32_t> ix = input_pair(mds,query_positions[k]);
+                EXPECT_EQ(mds_f.template move<_move_plain>(ix),mds.move<_move_plain>(ix));
+                EXPECT_EQ(mds_f.template move<_move_fast>(ix),mds.move<_move_plain>(ix));
+            }
+        });
+
+        // check if the view of mds_l_i with compile-time widths returns the same values in L' and move queries
+        mds_l_i.with_fixed_widths([&](const auto& mds_l_f){
+            #pragma omp parallel for num_threads(max_num_threads)
+            for (uint32_t x=0; x<mds_l_i.num_intervals(); x++) {
+                EXPECT_EQ(mds_l_f.L_(x),mds_l_i.L_(x));
+            }
+            #pragma omp parallel for num_threads(max_num_threads)
+            for (uint32_t k=0; k<query_positions.size(); k++) {
+                std::pair<uint32_t,uint32_t> ix = input_pair(mds_l_i,query_positions[k]);
+                EXPECT_EQ(mds_l_f.template move<_move_fast>(ix),mds_l_i.move<_move_plain>(ix));
+            }
+        });
+    }
+}
+
+TEST(test_move_data_structure,packed) {
+    auto start_time = now();
+
+    while (time_diff_min(start_time,now()) < test_duration_min) {
+        generate_interval_sequence();
+        move_data_structure<uint32_t> mds(interval_sequence,input_size,{
+            .num_threads = num_threads_distrib(gen), .a = a
+        });
+
+        // load the move data structure into a bit-packed move data structure (by serializing and loading it) and
+        // check if it stores the same data, and if serializing it again results in the same data
+        std::stringstream mds_stream;
+        move_data_structure_packed<uint32_t> mds_packed;
+        mds.serialize(mds_stream);
+        std::string mds_serialized = mds_stream.str();
+        mds_packed.load(mds_stream);
+        EXPECT_EQ(mds_packed.num_intervals(),mds.num_intervals());
+        #pragma omp parallel for num_threads(max_num_threads)
+        for (uint32_t x=0; x<=mds.num_intervals(); x++) {
+            EXPECT_EQ(mds_packed.p(x),mds.p(x));
+            if (x < mds.num_intervals()) {
+                EXPECT_EQ(mds_packed.idx(x),mds.idx(x));
+                EXPECT_EQ(mds_packed.offs(x),mds.offs(x));
+            }
+        }
+        std::stringstream mds_packed_stream;
+        mds_packed.serialize(mds_packed_stream);
+        EXPECT_EQ(mds_packed_stream.str(),mds_serialized);
+        #pragma omp parallel for num_threads(max_num_threads)
+        for (uint32_t k=0; k<query_positions.size(); k++) {
+            std::pair<uint32_t,uint32_t> ix = input_pair(mds,query_positions[k]);
+            EXPECT_EQ(mds_packed.move<_move_plain>(ix),mds.move<_move_plain>(ix));
+            EXPECT_EQ(mds_packed.move<_move_fast>(ix),mds.move<_move_plain>(ix));
+        }
+
+        // check if the view with compile-time widths (if the widths of mds_packed are specialized) answers the same queries
+        mds_packed.with_fixed_widths([&](const auto& mds_f){
+            EXPECT_EQ(mds_f.num_intervals(),mds.num_intervals());
+            #pragma omp parallel for num_threads(max_num_threads)
+            for (uint32_t x=0; x<=mds.num_intervals(); x++) {
+                EXPECT_EQ(mds_f.p(x),mds.p(x));
+                if (x < mds.num_intervals()) {
+                    EXPECT_EQ(mds_f.idx(x),mds.idx(x));
+                    EXPECT_EQ(mds_f.offs(x),mds.offs(x));
+                    EXPECT_EQ(mds_f.q(x),mds.q(x));
+                }
+            }
+            #pragma omp parallel for num_threads(max_num_threads)
+            for (uint32_t k=0; k<query_positions.size(); k++) {
+                std::pair<uint32_t,uint32_t> ix = input_pair(mds,query_positions[k]);
+                EXPECT_EQ(mds_f.template move<_move_plain>(ix),mds.move<_move_plain>(ix));
+                EXPECT_EQ(mds_f.template move<_move_fast>(ix),mds.move<_move_plain>(ix));
+            }
+        });
+    }
+}
+
+TEST(test_move_data_structure,l__layouts) {
+    auto start_time = now();
+
+    while (time_diff_min(start_time,now()) < test_duration_min) {
+        generate_interval_sequence();
+
+        // build a move data structure with L' from the disjoint interval sequence, load it into the other layouts
+        // (by serializing and loading it) and check if they store the same data
+        move_data_structure_l_<uint32_t,uint8_t,_l_interleaved> mds_l_i = build_mds_l_();
+        uint32_t k_ = mds_l_i.num_intervals();
+        std::stringstream mds_l_stream;
+        move_data_structure_l_<uint32_t,uint8_t,_l_separate> mds_l_s;
+        move_data_structure_l_<uint32_t,uint8_t,_l_p_separate> mds_l_ps;
+        move_data_structure_l_<uint32_t,uint8_t,_l_packed> mds_l_pk;
+        mds_l_i.serialize(mds_l_stream);
+        mds_l_s.load(mds_l_stream);
+        mds_l_s.serialize(mds_l_stream);
+        mds_l_ps.load(mds_l_stream);
+        mds_l_ps.serialize(mds_l_stream);
+        mds_l_pk.load(mds_l_stream);
+        EXPECT_EQ(mds_l_ps.num_intervals(),k_);
+        EXPECT_EQ(mds_l_pk.num_intervals(),k_);
+        #pragma omp parallel for num_threads(max_num_threads)
+        for (uint32_t x=0; x<=k_; x++) {
+            EXPECT_EQ(mds_l_s.p(x),mds_l_i.p(x));
+            EXPECT_EQ(mds_l_ps.p(x),mds_l_i.p(x));
+            EXPECT_EQ(mds_l_pk.p(x),mds_l_i.p(x));
+            if (x < k_) {
+                EXPECT_EQ(mds_l_s.idx(x),mds_l_i.idx(x));
+                EXPECT_EQ(mds_l_ps.idx(x),mds_l_i.idx(x));
+                EXPECT_EQ(mds_l_pk.idx(x),mds_l_i.idx(x));
+                EXPECT_EQ(mds_l_s.offs(x),mds_l_i.offs(x));
+                EXPECT_EQ(mds_l_ps.offs(x),mds_l_i.offs(x));
+                EXPECT_EQ(mds_l_pk.offs(x),mds_l_i.offs(x));
+                EXPECT_EQ(mds_l_s.L_(x),mds_l_i.L_(x));
+                EXPECT_EQ(mds_l_ps.L_(x),mds_l_i.L_(x));
+                EXPECT_EQ(mds_l_pk.L_(x),mds_l_i.L_(x));
+            }
+        }
+
+        // choose a random range [x_b,x_e] and a random value v for a scan over L' for each query position
+        std::uniform_int_distribution<uint32_t> x_distrib(0,k_-1);
+        std::uniform_int_distribution<uint32_t> scan_length_distrib(0,100);
+        std::vector<std::tuple<uint32_t,uint32_t,uint8_t>> scans;
+        scans.reserve(query_positions.size());
+        for (uint32_t k=0; k<query_positions.size(); k++) {
+            uint32_t x_b = x_distrib(gen);
+            scans.emplace_back(x_b,std::min<uint32_t>(x_b+scan_length_distrib(gen),k_-1),l__distrib(gen));
+        }
+
+        // check if move queries and the scans over L' return the same results in all layouts
+        #pragma omp parallel for num_threads(max_num_threads)
+        for (uint32_t k=0; k<query_positions.size(); k++) {
+            std::pair<uint32_t,uint32_t> ix = input_pair(mds_l_i,query_positions[k]);
+            std::pair<uint32_t,uint32_t> ix_i = mds_l_i.move<_move_plain>(ix);
+            EXPECT_EQ(mds_l_s.move<_move_plain>(ix),ix_i);
+            EXPECT_EQ(mds_l_ps.move<_move_fast>(ix),ix_i);
+            EXPECT_EQ(mds_l_pk.move<_move_fast>(ix),ix_i);
+            auto [x_b,x_e,v] = scans[k];
+            uint32_t x_f = x_b;
+            while (x_f < x_e && mds_l_i.L_(x_f) != v) x_f++;
+            EXPECT_EQ(mds_l_i.find_l_(v,x_b,x_e),x_f);
+            EXPECT_EQ(mds_l_s.find_l_(v,x_b,x_e),x_f);
+            EXPECT_EQ(mds_l_ps.find_l_(v,x_b,x_e),x_f);
+            EXPECT_EQ(mds_l_pk.find_l_(v,x_b,x_e),x_f);
+            uint32_t x_r = x_e;
+            while (x_r > x_b && mds_l_i.L_(x_r) != v) x_r--;
+            EXPECT_EQ(mds_l_i.rfind_l_(v,x_b,x_e),x_r);
+            EXPECT_EQ(mds_l_s.rfind_l_(v,x_b,x_e),x_r);
+            EXPECT_EQ(mds_l_ps.rfind_l_(v,x_b,x_e),x_r);
+            EXPECT_EQ(mds_l_pk.rfind_l_(v,x_b,x_e),x_r);
+        }
+
+        // check if the view of mds_l_pk with compile-time widths returns the same values in L' and move queries
+        mds_l_pk.with_fixed_widths([&](const auto& mds_l_f){
+            #pragma omp parallel for num_threads(max_num_threads)
+            for (uint32_t x=0; x<k_; x++) {
+                EXPECT_EQ(mds_l_f.L_(x),mds_l_i.L_(x));
+            }
+            #pragma omp parallel for num_threads(max_num_threads)
+            for (uint32_t k=0; k<query_positions.size(); k++) {
+                std::pair<uint32_t,uint32_t> ix = input_pair(mds_l_i,query_positions[k]);
+                EXPECT_EQ(mds_l_f.template move<_move_fast>(ix),mds_l_i.move<_move_plain>(ix));
+            }
+        });
+    }
+}
+
+TEST(test_move_data_structure,reordered) {
+    auto start_time = now();
+
+    while (time_diff_min(start_time,now()) < test_duration_min) {
+        generate_interval_sequence();
+        move_data_structure<uint32_t> mds(interval_sequence,input_size,{
+            .num_threads = num_threads_distrib(gen), .a = a
+        });
+        move_data_structure_l_<uint32_t,uint8_t,_l_interleaved> mds_l_i = build_mds_l_();
+        uint32_t k_ = mds_l_i.num_intervals();
+
+        // copy mds into a move data structure, whose rows are ordered by a walk of move queries, and mds_l_i into
+        // one, whose rows are permuted randomly, and check if they return the same values and move queries (using
+        // the logical and the physical row indices)
+        move_data_structure_reordered<uint32_t> mds_ro(mds,
+            move_data_structure_reordered<uint32_t>::walk_order(mds,0,0,input_size),num_threads_distrib(gen));
+        std::vector<uint32_t> order(k_);
+        for (uint32_t y=0; y<k_; y++) order[y] = y;
+        std::shuffle(order.begin(),order.end(),gen);
+        move_data_structure_reordered<uint32_t,uint8_t> mds_l_ro(mds_l_i,order,num_threads_distrib(gen));
+        EXPECT_EQ(mds_ro.num_intervals(),mds.num_intervals());
+        EXPECT_EQ(mds_l_ro.num_intervals(),k_);
+        #pragma omp parallel for num_threads(max_num_threads)
+        for (uint32_t x=0; x<=mds.num_intervals(); x++) {
+            EXPECT_EQ(mds_ro.p(x),mds.p(x));
+            if (x < mds.num_intervals()) {
+                EXPECT_EQ(mds_ro.to_logical(mds_ro.to_physical(x)),x);
+                EXPECT_EQ(mds_ro.idx(x),mds.idx(x));
+                EXPECT_EQ(mds_ro.offs(x),mds.offs(x));
+                EXPECT_EQ(mds_ro.q(x),mds.q(x));
+            }
+        }
+        #pragma omp parallel for num_threads(max_num_threads)
+        for (uint32_t x=0; x<=k_; x++) {
+            EXPECT_EQ(mds_l_ro.p(x),mds_l_i.p(x));
+            if (x < k_) {
+                EXPECT_EQ(order[mds_l_ro.to_physical(x)],x);
+                EXPECT_EQ(mds_l_ro.idx(x),mds_l_i.idx(x));
+                EXPECT_EQ(mds_l_ro.offs(x),mds_l_i.offs(x));
+                EXPECT_EQ(mds_l_ro.L_(x),mds_l_i.L_(x));
+                EXPECT_EQ(mds_l_ro.rows().L_(mds_l_ro.to_physical(x)),mds_l_i.L_(x));
+            }
+        }
+        #pragma omp parallel for num_threads(max_num_threads)
+        for (uint32_t k=0; k<query_positions.size(); k++) {
+            uint32_t i = query_positions[k];
+            std::pair<uint32_t,uint32_t> ix = input_pair(mds,i);
+            EXPECT_EQ(mds_ro.move(ix),mds.move<_move_plain>(ix));
+            ix = input_pair(mds_l_i,i);
+            std::pair<uint32_t,uint32_t> ix_i = mds_l_i.move<_move_plain>(ix);
+            EXPECT_EQ(mds_l_ro.move(ix),ix_i);
+            std::pair<uint32_t,uint32_t> iy = mds_l_ro.rows().move({i,mds_l_ro.to_physical(ix.second)});
+            EXPECT_EQ(iy.first,ix_i.first);
+            EXPECT_EQ(mds_l_ro.to_logical(iy.second),ix_i.second);
+        }
+        mds_l_ro.with_fixed_widths([&](const auto& rows_f){
+            #pragma omp parallel for num_threads(max_num_threads)
+            for (uint32_t x=0; x<k_; x++) {
+                uint32_t y = mds_l_ro.to_physical(x);
+                EXPECT_EQ(rows_f.L_(y),mds_l_i.L_(x));
+                EXPECT_EQ(rows_f.next(y),mds_l_ro.to_physical(x+1));
+                EXPECT_EQ(rows_f.template move<_move_fast>(std::make_pair(mds_l_i.p(x),y)),mds_l_ro.rows().move({mds_l_i.p(x),y}));
+            }
+        });
     }
-}
\ No newline at end of file
+}
@@ -53,12 +53,22 @@ void test_move_r() {
         input.push_back(uchar_to_char(cur_uchar));
     }
 
+    // allocate the arrays of the index with a random allocation policy
+    alloc_policy_scope alloc_scope({
+        .huge_pages = prob_distrib(gen) < 0.5,
+        .numa = prob_distrib(gen) < 0.5 ? _numa_interleave : _numa_default
+    });
+
     // build move-r and choose a random number of threads and balancing parameter, but always use libsais,
     // because there are bugs in Big-BWT that come through during fuzzing but not really in practice
     move_r<support,char,uint32_t> index(input,{
         .mode = _suffix_array,
         .num_threads = num_threads_distrib(gen),
-        .a = std::min<uint16_t>(2+a_distrib(gen),32767)
+        .a = std::min<uint16_t>(2+a_distrib(gen),32767),
+        .bidirectional = prob_distrib(gen) < 0.5,
+        .sample_rate_sa = prob_distrib(gen) < 0.5 ? std::uniform_int_distribution<uint32_t>(1,256)(gen) : 0,
+        .build_lcp = prob_distrib(gen) < 0.5,
+        .build_thresholds = prob_distrib(gen) < 0.5
     });
     
     // revert the index and compare the output with the input string
@@ -66,6 +76,41 @@ void test_move_r() {
     #pragma omp parallel for num_threads(max_num_threads)
     for (uint32_t i=0; i<input_size; i++) EXPECT_EQ(input[i],input_reverted[i]);
 
+    // replicate the index on two NUMA nodes (the second one may not exist) and check if both replicas store the input
+    numa_replicated<move_r<support,char,uint32_t>> replicas(index,2);
+    EXPECT_EQ(replicas.num_replicas(),2);
+    EXPECT_EQ(replicas.replica(1).revert({.num_threads = 1}),input);
+    EXPECT_EQ(replicas.local().revert({.num_threads = 1}),input);
+
+    // build the text position samples with a random sample rate (and reorder the rows of the move data structures
+    // with probability 1/2, which are then also used by the queries below), extract random ranges of the input (with
+    // and without the samples) and compare them with the input, revert a random range with a random number of threads
+    // and check random inverse suffix array values
+    std::uniform_int_distribution<uint32_t> extract_pos_distrib(0,input_size-1);
+    for (uint8_t round=0; round<2; round++) {
+        if (round == 1) {
+            index.build_isa_samples(std::uniform_int_distribution<uint32_t>(1,1024)(gen),num_threads_distrib(gen));
+            if (prob_distrib(gen) < 0.5) index.reorder_rows(num_threads_distrib(gen));
+        }
+
+        for (uint32_t query=0; query<100; query++) {
+            uint32_t l = extract_pos_distrib(gen);
+            uint32_t r = std::min<uint32_t>(input_size-1,l+std::uniform_int_distribution<uint32_t>(0,1000)(gen));
+            EXPECT_TRUE(std::equal(input.begin()+l,input.begin()+r+1,index.extract(l,r).begin()));
+        }
+
+        uint32_t l = extract_pos_distrib(gen);
+        uint32_t r = extract_pos_distrib(gen);
+        if (l > r) std::swap(l,r);
+        input_reverted = index.revert({.l = l, .r = r, .num_threads = num_threads_distrib(gen)});
+        EXPECT_TRUE(std::equal(input.begin()+l,input.begin()+r+1,input_reverted.begin()));
+
+        for (uint32_t query=0; query<100; query++) {
+            uint32_t j = std::uniform_int_distribution<uint32_t>(0,input_size)(gen);
+            EXPECT_EQ(index.SA(index.ISA(j)),j);
+        }
+    }
+
     // retrieve the suffix array and compare it with the correct suffix array; if the input contains 0,
     // then temporarily remap the characters of the input string s.t. it does not contain 0
     if (contains(alphabet,(uint8_t)0)) {
@@ -92,11 +137,40 @@ void test_move_r() {
     suffix_array_retrieved = index.SA({.num_threads = num_threads_distrib(gen)});
     #pragma omp parallel for num_threads(max_num_threads)
     for (uint32_t i=0; i<=input_size; i++) EXPECT_EQ(suffix_array[i],suffix_array_retrieved[i]);
+
+    // if the thresholds have not been built during the construction, build them with the index with probability 1/2
+    if (!index.has_thresholds() && prob_distrib(gen) < 0.5) index.build_thresholds(num_threads_distrib(gen));
     
     // compute each suffix array value separately and check if it is correct
     #pragma omp parallel for num_threads(max_num_threads)
     for (uint32_t i=0; i<=input_size; i++) EXPECT_EQ(index.SA(i),suffix_array[i]);
 
+    // compute each inverse suffix array value and check if it is correct
+    #pragma omp parallel for num_threads(max_num_threads)
+    for (uint32_t i=0; i<=input_size; i++) EXPECT_EQ(index.ISA(suffix_array[i]),i);
+
+    // if the PLCP samples have been built, compute the lcp array with Kasai's algorithm and compare it with LCP(i)
+    // and with random ranges retrieved by lcp_range(b,e)
+    if (index.has_lcp()) {
+        std::vector<uint32_t> inv_suffix_array(input_size+1);
+        std::vector<uint32_t> lcp_array(input_size+1,0);
+        for (uint32_t i=0; i<=input_size; i++) inv_suffix_array[suffix_array[i]] = i;
+        for (uint32_t j=0,l=0; j<=input_size; j++) {
+            if (inv_suffix_array[j] == 0) {l = 0; continue;}
+            uint32_t j_ = suffix_array[inv_suffix_array[j]-1];
+            while (j+l < input_size && j_+l < input_size && input[j+l] == input[j_+l]) l++;
+            lcp_array[inv_suffix_array[j]] = l;
+            if (l > 0) l--;
+        }
+        #pragma omp parallel for num_threads(max_num_threads)
+        for (uint32_t i=0; i<=input_size; i++) EXPECT_EQ(index.LCP(i),lcp_array[i]);
+        for (uint32_t query=0; query<100; query++) {
+            uint32_t b = std::uniform_int_distribution<uint32_t>(0,input_size)(gen);
+            uint32_t e = std::min<uint32_t>(input_size,b+std::uniform_int_distribution<uint32_t>(0,1000)(gen));
+            EXPECT_TRUE(std::equal(lcp_array.begin()+b,lcp_array.begin()+e+1,index.lcp_range(b,e,num_threads_distrib(gen)).begin()));
+        }
+    }
+
     // retrieve the bwt and compare it with the correct bwt
     no_init_resize(bwt,input_size+1);
     #pragma omp parallel for num_threads(max_num_threads)
@@ -109,6 +183,53 @@ void test_move_r() {
     #pragma omp parallel for num_threads(max_num_threads)
     for (uint32_t i=0; i<=input_size; i++) EXPECT_EQ(index.BWT(i),bwt[i]);
 
+    /* build the document array, either with a random separator or with random document starts, which are passed to the
+    construction of a second index with probability 1/2 (it then computes ILCP from its suffix array), whose document
+    queries are tested instead */
+    std::vector<uint32_t> doc_starts = {0};
+    move_r<support,char,uint32_t> index_docs_constructed;
+    bool docs_constructed = false;
+    if (prob_distrib(gen) < 0.5) {
+        auto separator = uchar_to_char(alphabet[char_idx_distrib(gen)]);
+        index.build_document_array(separator);
+        for (uint32_t i=0; i<input_size-1; i++) {
+            if (input[i] == separator) doc_starts.emplace_back(i+1);
+        }
+    } else {
+        std::uniform_int_distribution<uint32_t> doc_start_distrib(0,input_size-1);
+        uint32_t num_docs = std::uniform_int_distribution<uint32_t>(1,std::min<uint32_t>(input_size,1000))(gen);
+        for (uint32_t i=1; i<num_docs; i++) doc_starts.emplace_back(doc_start_distrib(gen));
+        std::sort(doc_starts.begin(),doc_starts.end());
+        doc_starts.erase(std::unique(doc_starts.begin(),doc_starts.end()),doc_starts.end());
+        if (prob_distrib(gen) < 0.5) {
+            index.build_document_array(doc_starts,num_threads_distrib(gen));
+        } else {
+            index_docs_constructed = move_r<support,char,uint32_t>(input.substr(0,input_size),{
+                .mode = _suffix_array,
+                .num_threads = num_threads_distrib(gen),
+                .doc_starts = std::vector<uint64_t>(doc_starts.begin(),doc_starts.end())
+            });
+            docs_constructed = true;
+        }
+    }
+    const move_r<support,char,uint32_t>& index_docs = docs_constructed ? index_docs_constructed : index;
+    EXPECT_EQ(index_docs.num_documents(),doc_starts.size());
+    EXPECT_TRUE(index_docs.has_ilcp());
+
+    // enumerate the k-mers of the input with a random k and minimum frequency and compare them with the correct ones
+    uint32_t kmer_len = std::uniform_int_distribution<uint32_t>(1,12)(gen);
+    uint32_t min_freq = std::uniform_int_distribution<uint32_t>(1,3)(gen);
+    std::map<std::string,uint32_t> kmer_freqs;
+    for (uint32_t i=0; i+kmer_len<=input_size; i++) kmer_freqs[input.substr(i,kmer_len)]++;
+    std::vector<std::pair<std::string,uint32_t>> correct_kmers;
+    for (auto& [kmer,freq] : kmer_freqs) {
+        if (freq >= min_freq) correct_kmers.emplace_back(kmer,freq);
+    }
+    EXPECT_EQ(index.kmers(kmer_len,{.min_freq = min_freq, .num_threads = num_threads_distrib(gen)}),correct_kmers);
+
+    // choose a random maximum scan distance over L' for the backward searches
+    index.set_max_scan_l_length(std::uniform_int_distribution<uint32_t>(0,256)(gen));
+
     // generate patterns from the input and test count- and locate queries
     std::uniform_int_distribution<uint32_t> pattern_pos_distrib(0,input_size-1);
     max_pattern_length = std::min<uint32_t>(10000,std::max<uint32_t>(100,input_size/1000));
@@ -124,6 +245,11 @@ void test_move_r() {
         std::string pattern;
         std::vector<uint32_t> correct_occurrences;
         std::vector<uint32_t> occurrences;
+        std::vector<std::string> patterns;
+        std::vector<uint32_t> correct_counts;
+        std::vector<std::string> batch_patterns;
+        std::vector<uint32_t> batch_correct_occurrences;
+        std::vector<uint64_t> batch_occurrences_offsets;
         bool match;
         for(uint32_t cur_query=0; cur_query<num_queries; cur_query++) {
             pattern_pos = pattern_pos_distrib(gen_thr);
@@ -141,18 +267,196 @@ void test_move_r() {
                 if (match) correct_occurrences.emplace_back(i);
             }
             EXPECT_EQ(index.count(pattern),correct_occurrences.size());
+            patterns.emplace_back(pattern);
+            correct_counts.emplace_back(correct_occurrences.size());
             occurrences = index.locate(pattern);
             ips4o::sort(occurrences.begin(),occurrences.end());
             EXPECT_EQ(occurrences,correct_occurrences);
             occurrences.clear();
+            index.locate(pattern,occurrences,num_threads_distrib(gen_thr));
+            ips4o::sort(occurrences.begin(),occurrences.end());
+            EXPECT_EQ(occurrences,correct_occurrences);
+            occurrences.clear();
+            EXPECT_EQ(index.locate_sorted(pattern),correct_occurrences);
+            occurrences.resize(correct_occurrences.size()+1);
+            EXPECT_EQ(index.locate_sorted(pattern,std::span<uint32_t>(occurrences)),correct_occurrences.size());
+            EXPECT_TRUE(std::equal(correct_occurrences.begin(),correct_occurrences.end(),occurrences.begin()));
+            occurrences.clear();
+            uint32_t max_occ = std::uniform_int_distribution<uint32_t>(0,correct_occurrences.size()+1)(gen_thr);
+            for (bool spread : {false,true}) {
+                index.locate(pattern,occurrences,{.max_occ = max_occ, .spread = spread});
+                EXPECT_EQ(occurrences.size(),std::min<uint32_t>(max_occ,correct_occurrences.size()));
+                ips4o::sort(occurrences.begin(),occurrences.end());
+                EXPECT_TRUE(std::adjacent_find(occurrences.begin(),occurrences.end()) == occurrences.end());
+                EXPECT_TRUE(std::includes(correct_occurrences.begin(),correct_occurrences.end(),occurrences.begin(),occurrences.end()));
+                occurrences.clear();
+            }
+            std::vector<std::pair<uint32_t,uint32_t>> correct_doc_counts;
+            for (uint32_t occ : correct_occurrences) {
+                uint32_t doc = std::upper_bound(doc_starts.begin(),doc_starts.end(),occ)-doc_starts.begin()-1;
+                EXPECT_EQ(index_docs.document(occ),doc);
+                if (correct_doc_counts.empty() || correct_doc_counts.back().first != doc) correct_doc_counts.emplace_back(doc,0);
+                correct_doc_counts.back().second++;
+            }
+            EXPECT_EQ(index_docs.count_per_document(pattern),correct_doc_counts);
+            index_docs.list_documents(pattern,occurrences);
+            EXPECT_EQ(occurrences.size(),correct_doc_counts.size());
+            for (uint32_t i=0; i<occurrences.size(); i++) EXPECT_EQ(occurrences[i],correct_doc_counts[i].first);
+            occurrences.clear();
+            uint32_t k = std::uniform_int_distribution<uint32_t>(0,correct_doc_counts.size()+1)(gen_thr);
+            std::stable_sort(correct_doc_counts.begin(),correct_doc_counts.end(),[](auto& p1, auto& p2){return p1.second > p2.second;});
+            if (k < correct_doc_counts.size()) correct_doc_counts.resize(k);
+            EXPECT_EQ(index_docs.top_k_documents(pattern,k),correct_doc_counts);
             auto query = index.query();
             for (int32_t i=pattern.size()-1; i>=0; i--) query.prepend(pattern[i]);
             EXPECT_EQ(query.num_occ(),correct_occurrences.size());
+            auto [b,e] = query.sa_interval();
+            std::vector<char> preceding_symbols;
+            for (uint32_t i=b; i<=e; i++) {
+                if (suffix_array[i] != 0) preceding_symbols.emplace_back(bwt[i]);
+            }
+            std::sort(preceding_symbols.begin(),preceding_symbols.end(),[](char c1, char c2){return char_to_uchar(c1) < char_to_uchar(c2);});
+            preceding_symbols.erase(std::unique(preceding_symbols.begin(),preceding_symbols.end()),preceding_symbols.end());
+            std::vector<std::tuple<char,uint32_t,uint32_t>> correct_symbols;
+            for (char c : preceding_symbols) {
+                auto query_c = query;
+                EXPECT_TRUE(query_c.prepend(c));
+                correct_symbols.emplace_back(c,query_c.sa_interval().first,query_c.sa_interval().second);
+            }
+            EXPECT_EQ(index.interval_symbols(b,e),correct_symbols);
             query.locate(occurrences);
             ips4o::sort(occurrences.begin(),occurrences.end());
             EXPECT_EQ(occurrences,correct_occurrences);
+            occurrences.clear();
+            auto query_many = index.query();
+            auto state_empty = query_many.state();
+            EXPECT_EQ(query_many.prepend_many(pattern.data(),pattern_length),pattern_length);
+            EXPECT_EQ(query_many.sa_interval(),query.sa_interval());
+            std::stringstream state_stream;
+            query_many.state().serialize(state_stream);
+            query_many.restore(state_empty);
+            EXPECT_EQ(query_many.length(),0);
+            typename decltype(index)::query_state state_pattern;
+            state_pattern.load(state_stream);
+            query_many.restore(state_pattern);
+            query_many.locate(occurrences);
+            ips4o::sort(occurrences.begin(),occurrences.end());
+            EXPECT_EQ(occurrences,correct_occurrences);
+            occurrences.clear();
+            auto query_lim = index.query();
+            for (int32_t i=pattern.size()-1; i>=0; i--) query_lim.prepend(pattern[i]);
+            query_lim.locate_spread(occurrences,max_occ);
+            EXPECT_EQ(occurrences.size(),std::min<uint32_t>(max_occ,correct_occurrences.size()));
+            occurrences.clear();
+            query_lim.locate(occurrences,max_occ);
+            EXPECT_EQ(query_lim.num_occ_rem(),correct_occurrences.size()-occurrences.size());
+            query_lim.locate(occurrences);
+            ips4o::sort(occurrences.begin(),occurrences.end());
+            EXPECT_EQ(occurrences,correct_occurrences);
+            if (index.is_bidirectional()) {
+                // match the pattern by extending it to the left and to the right in a random order
+                auto query_bi = index.query();
+                uint32_t left = std::uniform_int_distribution<uint32_t>(0,pattern_length)(gen_thr);
+                uint32_t right = left;
+                while (left > 0 || right < pattern_length) {
+                    if (right == pattern_length || (left > 0 && prob_distrib(gen_thr) < 0.5)) {
+                        left--;
+                        EXPECT_TRUE(query_bi.prepend(pattern[left]));
+                    } else {
+                        EXPECT_TRUE(query_bi.append(pattern[right]));
+                        right++;
+                    }
+                }
+                EXPECT_EQ(query_bi.num_occ(),correct_occurrences.size());
+                EXPECT_TRUE(std::binary_search(correct_occurrences.begin(),correct_occurrences.end(),query_bi.one_occ()));
+                occurrences.clear();
+                query_bi.locate(occurrences);
+                ips4o::sort(occurrences.begin(),occurrences.end());
+                EXPECT_EQ(occurrences,correct_occurrences);
+            }
+            if (index.has_thresholds() && cur_query % 16 == 0) {
+                // mutate the pattern and check its matching statistics and maximal exact matches
+                std::string pattern_mut = pattern;
+                for (uint32_t i=0; i<pattern_length; i++) {
+                    if (prob_distrib(gen_thr) < 0.05) pattern_mut[i] = uchar_to_char(alphabet[char_idx_distrib(gen_thr)]);
+                }
+                std::vector<uint32_t> ms_len,ms_pos;
+                index.matching_statistics(pattern_mut,ms_len,ms_pos);
+                uint32_t min_len = std::uniform_int_distribution<uint32_t>(1,8)(gen_thr);
+                std::vector<std::tuple<uint32_t,uint32_t,uint32_t>> correct_mems;
+                uint32_t len = 0;
+                for (uint32_t i=0; i<pattern_length; i++) {
+                    uint32_t len_prev = len;
+                    if (len > 0) len--;
+                    while (i+len < pattern_length && index.count(pattern_mut.substr(i,len+1)) > 0) len++;
+                    EXPECT_EQ(ms_len[i],len);
+                    if (len > 0) {
+                        EXPECT_EQ(input.compare(ms_pos[i],len,pattern_mut,i,len),0);
+                    }
+                    if (len >= min_len && (i == 0 || len_prev <= len)) correct_mems.emplace_back(i,len,ms_pos[i]);
+                }
+                EXPECT_EQ(index.maximal_exact_matches(pattern_mut,min_len),correct_mems);
+            } else if (!index.has_thresholds() && cur_query == 0) {
+                EXPECT_THROW(index.matching_statistics(pattern),std::invalid_argument);
+            }
+            if (cur_query % 512 == 0) {
+                // mutate a short prefix of the pattern and compare its approximate matches with the ones found by brute force
+                uint32_t m = std::min<uint32_t>(pattern_length,8);
+                std::string pattern_apx(pattern.begin(),pattern.begin()+m);
+                for (uint32_t i=0; i<m; i++) {
+                    if (prob_distrib(gen_thr) < 0.2) pattern_apx[i] = uchar_to_char(alphabet[char_idx_distrib(gen_thr)]);
+                }
+                uint32_t k = std::uniform_int_distribution<uint32_t>(0,2)(gen_thr);
+                bool edits = prob_distrib(gen_thr) < 0.5;
+                uint32_t max_len = edits ? m+k : m;
+                // minimum number of errors between the pattern and each substring of the input within distance k of it
+                std::map<std::string,uint32_t> correct_apx;
+                // d[i][j] = minimum number of errors between P[0..i-1] and input[t..t+j-1] without insertions at the ends
+                std::vector<std::vector<uint32_t>> d(m+1,std::vector<uint32_t>(max_len+1));
+                for (uint32_t t=0; t<input_size; t++) {
+                    for (uint32_t j=0; j<=max_len; j++) d[0][j] = j == 0 ? 0 : k+1;
+                    for (uint32_t i=1; i<=m; i++) {
+                        d[i][0] = i;
+                        for (uint32_t j=1; j<=max_len && t+j<=input_size; j++) {
+                            d[i][j] = std::min(d[i-1][j-1]+(pattern_apx[i-1] != input[t+j-1]),d[i-1][j]+(edits ? 1 : k+1));
+                            if (edits && i < m) d[i][j] = std::min(d[i][j],d[i][j-1]+1);
+                        }
+                    }
+                    for (uint32_t j = edits ? 1 : m; j<=max_len && t+j<=input_size; j++) {
+                        if (d[m][j] <= k) {
+                            std::string substr(input.begin()+t,input.begin()+t+j);
+                            auto it = correct_apx.find(substr);
+                            if (it == correct_apx.end()) correct_apx.emplace(substr,d[m][j]);
+                            else it->second = std::min(it->second,d[m][j]);
+                        }
+                    }
+                }
+                std::vector<typename decltype(index)::approx_match> correct_matches;
+                for (auto& [substr,errors] : correct_apx) {
+                    auto query_apx = index.query();
+                    for (int32_t i=substr.size()-1; i>=0; i--) query_apx.prepend(substr[i]);
+                    correct_matches.push_back({query_apx.sa_interval().first,query_apx.sa_interval().second,(uint32_t)substr.size(),errors});
+                }
+                std::sort(correct_matches.begin(),correct_matches.end());
+                EXPECT_EQ(index.approximate_matches(pattern_apx,{.k = k, .edits = edits, .num_threads = num_threads_distrib(gen_thr)}),correct_matches);
+            }
+            batch_patterns.emplace_back(pattern);
+            batch_correct_occurrences.insert(batch_correct_occurrences.end(),correct_occurrences.begin(),correct_occurrences.end());
+            if (batch_patterns.size() == 32 || cur_query == num_queries-1) {
+                occurrences.clear();
+                index.locate_batch(batch_patterns,occurrences,batch_occurrences_offsets);
+                EXPECT_EQ(batch_occurrences_offsets.back(),batch_correct_occurrences.size());
+                for (uint32_t j=0; j<batch_patterns.size(); j++) {
+                    ips4o::sort(occurrences.begin()+batch_occurrences_offsets[j],occurrences.begin()+batch_occurrences_offsets[j+1]);
+                }
+                EXPECT_EQ(occurrences,batch_correct_occurrences);
+                occurrences.clear();
+                batch_patterns.clear();
+                batch_correct_occurrences.clear();
+            }
             correct_occurrences.clear();
         }
+        EXPECT_EQ(index.count_batch(patterns),correct_counts);
     }
     
     input.clear();
@@ -162,8 +466,12 @@ TEST(test_move_r,fuzzy_test) {
     auto start_time = now();
 
     while (time_diff_min(start_time,now()) < 60) {
-        if (prob_distrib(gen) < 0.5) {
+        double prob = prob_distrib(gen);
+
+        if (prob < 1/3.0) {
             test_move_r<_locate_move>();
+        } else if (prob < 2/3.0) {
+            test_move_r<_locate_move_bi>();
         } else {
             test_move_r<_locate_rlzdsa>();
         }